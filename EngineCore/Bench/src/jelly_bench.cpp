@@ -0,0 +1,706 @@
+#include "jelly/jelly.hpp"
+#include "jelly/core/allocation_counter.hpp"
+#include "jelly/core/camera.hpp"
+#include "jelly/core/camera_system.hpp"
+#include "jelly/core/frame_timings.hpp"
+#include "jelly/core/game_system_interface.hpp"
+#include "jelly/core/job_system.hpp"
+#include "jelly/core/profiler.hpp"
+#include "jelly/core/spatial_index_system.hpp"
+#include "jelly/core/transform.hpp"
+#include "jelly/core/transform_system.hpp"
+#include "jelly/graphics/graphic_context.hpp"
+#include "jelly/graphics/image.hpp"
+#include "jelly/graphics/material_factory.hpp"
+#include "jelly/graphics/mesh_factory.hpp"
+#include "jelly/graphics/mesh_renderer_system.hpp"
+#include "jelly/graphics/shader_factory.hpp"
+#include "jelly/graphics/texture_factory.hpp"
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+#include "jelly/graphics/vulkan/vulkan_memory_allocator.hpp"
+#include "jelly/graphics/vulkan/vulkan_pipeline_registry.hpp"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+using jelly::core::FramePhase;
+using jelly::core::FrameTimings;
+
+// Counts the heap allocations of the whole process for the "allocations" report.
+// The array and nothrow forms call these. On Windows the engine DLL keeps its
+// own operator new, so only the allocations of the bench itself are counted.
+void* operator new(std::size_t size) {
+    jelly::core::AllocationCounter::record(size);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    jelly::core::AllocationCounter::record(size);
+    const size_t align = static_cast<size_t>(alignment);
+    const size_t alignedSize = (std::max<size_t>(size, 1) + align - 1) / align * align;
+#if defined(_WIN32)
+    void* pointer = _aligned_malloc(alignedSize, align);
+#else
+    void* pointer = std::aligned_alloc(align, alignedSize);
+#endif
+    if (pointer) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+#if defined(_WIN32)
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(pointer, alignment);
+}
+
+namespace {
+
+constexpr size_t PHASE_COUNT = static_cast<size_t>(FramePhase::Count);
+
+struct Options {
+    std::string scene = "cubes";    // cubes | hierarchy | materials | textures
+    uint32_t count = 10'000;        // Renderable entities
+    uint32_t depth = 16;            // Chain length of the hierarchy scene
+    uint32_t variants = 64;         // Distinct materials or textures
+    uint32_t frames = 500;          // Measured frames
+    uint32_t warmup = 50;           // Frames run before measuring
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    bool headless = true;
+    bool gpuCulling = true;
+    bool spatialIndex = false;      // Cull through a SpatialIndexSystem query
+    uint32_t recordingThreads = 0;
+    uint32_t jobThreads = 0;
+    uint32_t framesInFlight = 2;
+    std::string presentMode = "auto";  // auto | fifo | fifo-relaxed | mailbox | immediate
+    uint32_t targetFps = 0;         // Frame pacer cap, 0 for none
+    bool lowLatency = false;
+    bool renderThread = false;
+    std::string shader = "triangle";
+    std::string output;             // JSON file, stdout when empty
+    std::string trace;              // Chrome trace of the measured frames, none when empty
+};
+
+bool parsePresentMode(const std::string& text, jelly::core::PresentMode& mode) {
+    using jelly::core::PresentMode;
+    if (text == "auto") mode = PresentMode::Auto;
+    else if (text == "fifo") mode = PresentMode::Fifo;
+    else if (text == "fifo-relaxed") mode = PresentMode::FifoRelaxed;
+    else if (text == "mailbox") mode = PresentMode::Mailbox;
+    else if (text == "immediate") mode = PresentMode::Immediate;
+    else return false;
+    return true;
+}
+
+void printUsage() {
+    std::printf(
+        "Usage: JellyBench [options]\n"
+        "  --scene <cubes|hierarchy|materials|textures>  Stress scene (default cubes)\n"
+        "  --count <n>           Renderable entities (default 10000)\n"
+        "  --depth <n>           Hierarchy chain length (default 16)\n"
+        "  --variants <n>        Distinct materials or textures (default 64)\n"
+        "  --frames <n>          Measured frames (default 500)\n"
+        "  --warmup <n>          Unmeasured frames first (default 50)\n"
+        "  --size <w>x<h>        Render target size (default 1280x720)\n"
+        "  --window              Render to a window instead of offscreen\n"
+        "  --shader <name>       Shader of every material (default triangle)\n"
+        "  --no-gpu-culling      Cull on the CPU only\n"
+        "  --spatial-index       Cull with a frustum query of the spatial index\n"
+        "  --recording-threads <n>\n"
+        "  --job-threads <n>\n"
+        "  --frames-in-flight <n> Frames recorded ahead of the GPU, 1 to 3 (default 2)\n"
+        "  --present-mode <auto|fifo|fifo-relaxed|mailbox|immediate>  Windowed only (default auto)\n"
+        "  --target-fps <n>      Cap the frame rate with the frame pacer\n"
+        "  --low-latency         Sleep the predicted GPU wait before polling input\n"
+        "  --render-thread       Record frames on a render thread while the next one is simulated\n"
+        "  --output <file>       Write the JSON report to a file instead of stdout\n"
+        "  --trace <file>        Write a Chrome trace of the measured frames\n");
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        auto nextUInt = [&](uint32_t& value) {
+            const char* text = next();
+            if (!text) return false;
+            value = static_cast<uint32_t>(std::strtoul(text, nullptr, 10));
+            return true;
+        };
+
+        bool ok = true;
+        if (arg == "--scene") {
+            const char* text = next();
+            ok = text != nullptr;
+            if (ok) options.scene = text;
+        } else if (arg == "--count") {
+            ok = nextUInt(options.count);
+        } else if (arg == "--depth") {
+            ok = nextUInt(options.depth);
+        } else if (arg == "--variants") {
+            ok = nextUInt(options.variants);
+        } else if (arg == "--frames") {
+            ok = nextUInt(options.frames);
+        } else if (arg == "--warmup") {
+            ok = nextUInt(options.warmup);
+        } else if (arg == "--size") {
+            const char* text = next();
+            ok = text && std::sscanf(text, "%ux%u", &options.width, &options.height) == 2;
+        } else if (arg == "--window") {
+            options.headless = false;
+        } else if (arg == "--shader") {
+            const char* text = next();
+            ok = text != nullptr;
+            if (ok) options.shader = text;
+        } else if (arg == "--no-gpu-culling") {
+            options.gpuCulling = false;
+        } else if (arg == "--spatial-index") {
+            options.spatialIndex = true;
+        } else if (arg == "--recording-threads") {
+            ok = nextUInt(options.recordingThreads);
+        } else if (arg == "--job-threads") {
+            ok = nextUInt(options.jobThreads);
+        } else if (arg == "--frames-in-flight") {
+            ok = nextUInt(options.framesInFlight);
+        } else if (arg == "--present-mode") {
+            const char* text = next();
+            ok = text != nullptr;
+            if (ok) options.presentMode = text;
+        } else if (arg == "--target-fps") {
+            ok = nextUInt(options.targetFps);
+        } else if (arg == "--low-latency") {
+            options.lowLatency = true;
+        } else if (arg == "--render-thread") {
+            options.renderThread = true;
+        } else if (arg == "--output") {
+            const char* text = next();
+            ok = text != nullptr;
+            if (ok) options.output = text;
+        } else if (arg == "--trace") {
+            const char* text = next();
+            ok = text != nullptr;
+            if (ok) options.trace = text;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::fprintf(stderr, "Invalid argument: %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    const bool knownScene = options.scene == "cubes" || options.scene == "hierarchy" ||
+                            options.scene == "materials" || options.scene == "textures";
+    if (!knownScene) {
+        std::fprintf(stderr, "Unknown scene: %s\n", options.scene.c_str());
+        return false;
+    }
+
+    options.count = std::max(options.count, 1u);
+    options.depth = std::max(options.depth, 1u);
+    options.variants = std::max(options.variants, 1u);
+    options.frames = std::max(options.frames, 1u);
+    return true;
+}
+
+struct Spin {
+    float radiansPerFrame;
+};
+
+// Rotates by a fixed step per frame so every run does the same work regardless of frame time
+class SpinSystem : public jelly::core::GameSystemInterface {
+public:
+    explicit SpinSystem(entt::registry& registry)
+        : registry_(registry) {}
+
+    void declareAccess(jelly::core::SystemAccess& access) const override {
+        access.reads<Spin>().writes<jelly::core::Transform>();
+    }
+
+    void update() override {
+        auto view = registry_.view<jelly::core::Transform, Spin>();
+
+        jelly::core::JobSystem::get().parallelForEach(view, [](auto /*entity*/, auto& transform, auto& spin) {
+            glm::quat step = glm::quat(glm::vec3(0.0f, spin.radiansPerFrame, spin.radiansPerFrame * 0.5f));
+            transform.setLocalRotationQuat(step * transform.localRotation);
+        });
+    }
+
+private:
+    entt::registry& registry_;
+};
+
+// Checkerboard with a per-variant tint so no two textures are identical
+jelly::graphics::Image makeTexture(uint32_t variant) {
+    constexpr uint32_t SIZE = 64;
+    std::vector<uint8_t> pixels(SIZE * SIZE * 4);
+
+    const uint8_t r = static_cast<uint8_t>(variant * 67u);
+    const uint8_t g = static_cast<uint8_t>(variant * 131u);
+    const uint8_t b = static_cast<uint8_t>(variant * 197u);
+
+    for (uint32_t y = 0; y < SIZE; ++y) {
+        for (uint32_t x = 0; x < SIZE; ++x) {
+            const bool dark = ((x / 8) + (y / 8)) % 2 == 0;
+            uint8_t* p = &pixels[(y * SIZE + x) * 4];
+            p[0] = dark ? r / 2 : r;
+            p[1] = dark ? g / 2 : g;
+            p[2] = dark ? b / 2 : b;
+            p[3] = 255;
+        }
+    }
+
+    return jelly::graphics::Image(SIZE, SIZE, std::move(pixels));
+}
+
+// Lays the entities out on a cube grid centred on the origin and returns its side length
+float gridPosition(uint32_t index, uint32_t count, glm::vec3& position) {
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(count))));
+    constexpr float SPACING = 2.5f;
+    const float offset = (side - 1) * SPACING * 0.5f;
+
+    position = glm::vec3(
+        (index % side) * SPACING - offset,
+        ((index / side) % side) * SPACING - offset,
+        (index / (side * side)) * SPACING - offset
+    );
+    return side * SPACING;
+}
+
+struct BenchScene {
+    std::shared_ptr<jelly::graphics::MeshRendererSystem> meshRenderer;
+    uint32_t materialCount = 0;
+    uint32_t textureCount = 0;
+};
+
+BenchScene buildScene(jelly::Jelly& jelly, const Options& options) {
+    using namespace jelly::core;
+    using namespace jelly::graphics;
+
+    auto scene = std::make_unique<Scene>("JellyBench");
+    auto& registry = scene->getEntityManager();
+
+    auto transformSystem = std::make_shared<TransformSystem>(registry);
+    scene->addGameSystem(transformSystem);
+
+    // One shader per material in the materials and textures scenes: the
+    // descriptor set holding the albedo texture belongs to the shader
+    const bool perVariant = options.scene == "materials" || options.scene == "textures";
+    const uint32_t variantCount = perVariant ? std::min(options.variants, options.count) : 1;
+
+    std::vector<MaterialHandle> materials;
+    materials.reserve(variantCount);
+
+    BenchScene result;
+    TextureHandle sharedTexture;
+    for (uint32_t v = 0; v < variantCount; ++v) {
+        auto material = MaterialFactory::create(ShaderFactory::createFromFiles(options.shader));
+
+        // The materials scene shares one texture so only the material count varies
+        if (options.scene == "textures" || !sharedTexture) {
+            sharedTexture = TextureFactory::create(makeTexture(v));
+            ++result.textureCount;
+        }
+        material->setAlbedoTexture(sharedTexture);
+
+        materials.push_back(material);
+    }
+    result.materialCount = variantCount;
+
+    auto mesh = MeshFactory::cube();
+
+    float extent = 0.0f;
+    if (options.scene == "hierarchy") {
+        // Chains of `depth` transforms; each link is offset from its parent and
+        // spins, so every frame propagates through the whole chain
+        const uint32_t chainCount = (options.count + options.depth - 1) / options.depth;
+        uint32_t created = 0;
+
+        for (uint32_t chain = 0; chain < chainCount; ++chain) {
+            entt::entity parent = entt::null;
+
+            for (uint32_t link = 0; link < options.depth && created < options.count; ++link, ++created) {
+                auto entity = registry.create();
+                auto& transform = registry.emplace<Transform>(entity);
+
+                if (parent == entt::null) {
+                    glm::vec3 position;
+                    extent = gridPosition(chain, chainCount, position);
+                    transform.setLocalPosition(position);
+                } else {
+                    transform.setLocalPosition(glm::vec3(0.0f, 0.0f, 0.5f));
+                    transform.setLocalScale(glm::vec3(0.9f));
+                }
+
+                registry.emplace<MeshComponent>(entity, mesh);
+                registry.emplace<MaterialComponent>(entity, materials.front());
+                registry.emplace<Spin>(entity, 0.01f);
+
+                if (parent != entt::null) {
+                    transformSystem->setParent(entity, parent);
+                }
+                parent = entity;
+            }
+        }
+    } else {
+        for (uint32_t i = 0; i < options.count; ++i) {
+            auto entity = registry.create();
+            auto& transform = registry.emplace<Transform>(entity);
+
+            glm::vec3 position;
+            extent = gridPosition(i, options.count, position);
+            transform.setLocalPosition(position);
+
+            registry.emplace<MeshComponent>(entity, mesh);
+            registry.emplace<MaterialComponent>(entity, materials[i % materials.size()]);
+            registry.emplace<Spin>(entity, 0.01f + 0.001f * static_cast<float>(i % 7));
+        }
+    }
+
+    // Far enough back that most of the grid is visible, close enough that some of it is culled
+    auto cameraEntity = registry.create();
+    auto& cameraTransform = registry.emplace<Transform>(cameraEntity);
+    cameraTransform.setLocalPosition(glm::vec3(0.0f, 0.0f, extent * 1.2f + 3.0f));
+
+    Camera camera;
+    camera.type = CameraType::Perspective;
+    camera.fieldOfViewDegrees = 60.0f;
+    camera.nearPlane = 0.1f;
+    camera.farPlane = extent * 4.0f + 100.0f;
+    registry.emplace<Camera>(cameraEntity, camera);
+
+    scene->addGameSystem(std::make_shared<CameraSystem>(
+        registry, static_cast<float>(options.width), static_cast<float>(options.height)));
+    scene->addGameSystem(std::make_shared<SpinSystem>(registry));
+
+    std::shared_ptr<SpatialIndexSystem> spatialIndex;
+    if (options.spatialIndex) {
+        for (auto entity : registry.view<MeshComponent>()) {
+            registry.emplace<SpatialBounds>(entity, SpatialBounds{ mesh->getBoundingBox() });
+        }
+        spatialIndex = std::make_shared<SpatialIndexSystem>(registry, *transformSystem);
+        scene->addGameSystem(spatialIndex);
+    }
+
+    result.meshRenderer = std::make_shared<MeshRendererSystem>(registry);
+    result.meshRenderer->setGpuCulling(options.gpuCulling);
+    result.meshRenderer->setSpatialIndex(spatialIndex.get());
+    scene->addGameSystem(result.meshRenderer);
+
+    jelly.getSceneManager().addScene(std::move(scene));
+    jelly.getSceneManager().setActiveScene(0);
+
+    return result;
+}
+
+struct Series {
+    std::vector<double> samples; // Milliseconds
+
+    void writeJson(FILE* out) const {
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        double sum = 0.0;
+        for (double s : sorted) sum += s;
+
+        auto percentile = [&](double p) {
+            size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+            return sorted[index];
+        };
+
+        std::fprintf(out, "{ \"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }",
+            sum / static_cast<double>(sorted.size()), sorted.front(), percentile(0.5),
+            percentile(0.95), percentile(0.99), sorted.back());
+    }
+};
+
+uint64_t residentSetBytes() {
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    uint64_t pages = 0, resident = 0;
+    if (statm >> pages >> resident) {
+        return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+void writeMemoryJson(FILE* out) {
+    std::fprintf(out, "  \"memory\": {\n    \"residentBytes\": %llu",
+        static_cast<unsigned long long>(residentSetBytes()));
+
+    auto& context = jelly::graphics::GraphicContext::get();
+    if (context.getAPIType() == jelly::core::GraphicAPIType::Vulkan) {
+        auto* api = static_cast<jelly::graphics::vulkan::VulkanGraphicAPI*>(context.getAPI());
+
+        if (auto* registry = api->getPipelineRegistry()) {
+            std::fprintf(out, ",\n    \"pipelines\": %u", registry->getPipelineCount());
+        }
+
+        if (auto* allocator = api->getMemoryAllocator()) {
+            std::fprintf(out, ",\n    \"deviceAllocations\": %u,\n    \"heaps\": [", allocator->getDeviceAllocationCount());
+
+            auto heaps = allocator->getHeapStats();
+            for (size_t i = 0; i < heaps.size(); ++i) {
+                const auto& heap = heaps[i];
+                std::fprintf(out,
+                    "%s\n      { \"heapSize\": %llu, \"blockBytes\": %llu, \"allocatedBytes\": %llu, "
+                    "\"blockCount\": %u, \"dedicatedCount\": %u, \"allocationCount\": %u, \"fragmentation\": %.4f }",
+                    i ? "," : "",
+                    static_cast<unsigned long long>(heap.heapSize),
+                    static_cast<unsigned long long>(heap.blockBytes),
+                    static_cast<unsigned long long>(heap.allocatedBytes),
+                    heap.blockCount, heap.dedicatedCount, heap.allocationCount, heap.fragmentation);
+            }
+            std::fprintf(out, "\n    ]");
+        }
+    }
+
+    std::fprintf(out, "\n  }");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            printUsage();
+            return 0;
+        }
+    }
+
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    jelly::Jelly jelly;
+
+    jelly::core::WindowSettings settings = {
+        static_cast<int>(options.width), static_cast<int>(options.height), false, "JellyBench"
+    };
+    settings.recordingThreads = options.recordingThreads;
+    settings.jobThreads = options.jobThreads;
+    settings.headless = options.headless;
+    settings.framesInFlight = options.framesInFlight;
+    settings.targetFrameRate = static_cast<float>(options.targetFps);
+    settings.lowLatency = options.lowLatency;
+    settings.renderThread = options.renderThread;
+
+    if (!parsePresentMode(options.presentMode, settings.presentMode)) {
+        std::fprintf(stderr, "Invalid present mode: %s\n", options.presentMode.c_str());
+        return 1;
+    }
+
+    if (!jelly.initialize(jelly::core::GraphicAPIType::Vulkan, settings)) {
+        std::fprintf(stderr, "Failed to initialize the engine\n");
+        return 1;
+    }
+
+    auto setupStart = std::chrono::steady_clock::now();
+    BenchScene scene = buildScene(jelly, options);
+    double setupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupStart).count();
+
+    std::array<Series, PHASE_COUNT> phases;
+    Series frameTimes;
+    Series pacingCpu, pacingWait, pacingSleep;
+    Series allocationCounts, allocationBytes; // Heap allocations per frame, not milliseconds
+    for (auto& phase : phases) phase.samples.reserve(options.frames);
+    frameTimes.samples.reserve(options.frames);
+    allocationCounts.samples.reserve(options.frames);
+    allocationBytes.samples.reserve(options.frames);
+    uint32_t framesWithoutAllocations = 0;
+
+    // GPU timings arrive a few frames late; keyed by scope name, "frame" for the whole frame
+    std::map<std::string, Series> gpuSeries;
+    jelly::graphics::GpuFrameStats gpuStats;
+    uint64_t nextGpuFrame = options.warmup;
+
+    uint32_t frame = 0;
+    const uint32_t totalFrames = options.warmup + options.frames;
+
+    auto runStart = std::chrono::steady_clock::now();
+    while (frame < totalFrames && jelly.isRunning()) {
+        // Trace the measured frames only
+        if (frame == options.warmup && !options.trace.empty()) {
+            jelly::core::Profiler::beginCapture();
+        }
+
+        auto frameStart = std::chrono::steady_clock::now();
+        const uint64_t allocationsBefore = jelly::core::AllocationCounter::getCount();
+        const uint64_t bytesBefore = jelly::core::AllocationCounter::getBytes();
+
+        jelly.pollEvents();
+        jelly.update();
+        jelly.render();
+
+        const uint64_t allocations = jelly::core::AllocationCounter::getCount() - allocationsBefore;
+        const uint64_t allocatedBytes = jelly::core::AllocationCounter::getBytes() - bytesBefore;
+        auto frameEnd = std::chrono::steady_clock::now();
+
+        if (frame == options.warmup) {
+            runStart = frameStart;
+        }
+
+        if (frame >= options.warmup) {
+            frameTimes.samples.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+            for (size_t p = 0; p < PHASE_COUNT; ++p) {
+                phases[p].samples.push_back(static_cast<double>(FrameTimings::get(static_cast<FramePhase>(p))) * 1e-6);
+            }
+
+            const auto& pacing = jelly.getFramePacer().getLastStats();
+            pacingCpu.samples.push_back(pacing.cpuMs);
+            pacingWait.samples.push_back(pacing.waitMs);
+            pacingSleep.samples.push_back(pacing.sleepMs);
+
+            allocationCounts.samples.push_back(static_cast<double>(allocations));
+            allocationBytes.samples.push_back(static_cast<double>(allocatedBytes));
+            if (allocations == 0) ++framesWithoutAllocations;
+        }
+
+        if (jelly.getGpuFrameStats(gpuStats) && gpuStats.frameNumber >= nextGpuFrame) {
+            nextGpuFrame = gpuStats.frameNumber + 1;
+            gpuSeries["frame"].samples.push_back(gpuStats.frameMs);
+            for (const auto& scope : gpuStats.scopes) {
+                gpuSeries[scope.name].samples.push_back(scope.durationMs);
+            }
+        }
+        ++frame;
+    }
+
+    // The last frame may still be recording on the render thread
+    jelly.waitForRender();
+    double runMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - runStart).count();
+
+    if (!options.trace.empty()) {
+        jelly::core::Profiler::endCapture();
+        if (!jelly::core::Profiler::writeChromeTrace(options.trace)) {
+            std::fprintf(stderr, "Failed to write %s\n", options.trace.c_str());
+        }
+    }
+
+    // Window closed before anything was measured
+    if (frameTimes.samples.empty()) {
+        jelly.shutdown();
+        std::fprintf(stderr, "No frames were measured\n");
+        return 1;
+    }
+
+    FILE* out = options.output.empty() ? stdout : std::fopen(options.output.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "Failed to open %s\n", options.output.c_str());
+        jelly.shutdown();
+        return 1;
+    }
+
+    const auto& queue = scene.meshRenderer->getQueueStats();
+    const auto& culling = scene.meshRenderer->getCullingStats();
+
+    std::fprintf(out, "{\n");
+    std::fprintf(out,
+        "  \"config\": { \"scene\": \"%s\", \"count\": %u, \"depth\": %u, \"materials\": %u, \"textures\": %u, "
+        "\"frames\": %u, \"warmup\": %u, \"width\": %u, \"height\": %u, \"headless\": %s, \"shader\": \"%s\", "
+        "\"gpuCulling\": %s, \"spatialIndex\": %s, \"recordingThreads\": %u, \"jobWorkers\": %u, \"framesInFlight\": %u, "
+        "\"presentMode\": \"%s\", \"targetFps\": %u, \"lowLatency\": %s, \"renderThread\": %s },\n",
+        options.scene.c_str(), options.count, options.depth, scene.materialCount, scene.textureCount,
+        static_cast<uint32_t>(frameTimes.samples.size()), options.warmup, options.width, options.height,
+        options.headless ? "true" : "false", options.shader.c_str(), options.gpuCulling ? "true" : "false",
+        options.spatialIndex ? "true" : "false", options.recordingThreads, jelly::core::JobSystem::get().getWorkerCount(), options.framesInFlight,
+        options.presentMode.c_str(), options.targetFps, options.lowLatency ? "true" : "false",
+        options.renderThread ? "true" : "false");
+
+    std::fprintf(out, "  \"setupMs\": %.3f,\n", setupMs);
+    std::fprintf(out, "  \"averageFps\": %.2f,\n", static_cast<double>(frameTimes.samples.size()) * 1000.0 / runMs);
+    std::fprintf(out, "  \"frameMs\": ");
+    frameTimes.writeJson(out);
+    std::fprintf(out, ",\n  \"phasesMs\": {\n");
+    for (size_t p = 0; p < PHASE_COUNT; ++p) {
+        std::fprintf(out, "    \"%s\": ", FrameTimings::name(static_cast<FramePhase>(p)));
+        phases[p].writeJson(out);
+        std::fprintf(out, "%s\n", p + 1 < PHASE_COUNT ? "," : "");
+    }
+    std::fprintf(out, "  },\n");
+
+    std::fprintf(out, "  \"pacingMs\": {\n    \"cpu\": ");
+    pacingCpu.writeJson(out);
+    std::fprintf(out, ",\n    \"wait\": ");
+    pacingWait.writeJson(out);
+    std::fprintf(out, ",\n    \"sleep\": ");
+    pacingSleep.writeJson(out);
+    std::fprintf(out, "\n  },\n");
+
+    std::fprintf(out, "  \"allocations\": {\n    \"perFrame\": ");
+    allocationCounts.writeJson(out);
+    std::fprintf(out, ",\n    \"bytesPerFrame\": ");
+    allocationBytes.writeJson(out);
+    std::fprintf(out, ",\n    \"framesWithoutAllocations\": %u,\n    \"total\": %llu\n  },\n",
+        framesWithoutAllocations, static_cast<unsigned long long>(jelly::core::AllocationCounter::getCount()));
+
+    if (!gpuSeries.empty()) {
+        std::fprintf(out, "  \"gpuMs\": {\n");
+        size_t written = 0;
+        for (const auto& [name, series] : gpuSeries) {
+            std::fprintf(out, "    \"%s\": ", name.c_str());
+            series.writeJson(out);
+            std::fprintf(out, "%s\n", ++written < gpuSeries.size() ? "," : "");
+        }
+        std::fprintf(out, "  },\n");
+    }
+
+    std::fprintf(out,
+        "  \"lastFrame\": { \"drawCount\": %u, \"pipelineBinds\": %u, \"resourceBinds\": %u, \"meshBinds\": %u, "
+        "\"skippedBinds\": %u, \"mergedDraws\": %u, \"tested\": %u, \"visible\": %u, \"culled\": %u, "
+        "\"gpuCulled\": %u, \"pending\": %u, \"indexed\": %u },\n",
+        queue.drawCount, queue.pipelineBinds, queue.resourceBinds, queue.meshBinds,
+        queue.getSkippedBinds(), queue.mergedDraws, culling.testedCount, culling.visibleCount,
+        culling.culledCount, culling.gpuCount, culling.pendingCount, culling.indexedCount);
+
+    writeMemoryJson(out);
+    std::fprintf(out, "\n}\n");
+
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    jelly.shutdown();
+    return 0;
+}
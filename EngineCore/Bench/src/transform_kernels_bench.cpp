@@ -0,0 +1,150 @@
+#include "jelly/core/transform.hpp"
+#include "jelly/core/transform_kernels.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using jelly::core::SimdLevel;
+using jelly::core::Transform;
+using jelly::core::TransformKernels;
+using jelly::core::TransformSoA;
+
+namespace {
+
+// Roughly this many transforms are processed per measurement
+constexpr size_t WORK_PER_SAMPLE = 20'000'000;
+
+struct Scene {
+    // AoS data as the ECS stores it today
+    std::vector<Transform> transforms;
+    std::vector<glm::mat4> parentWorld;
+
+    // Same data in SoA form for the batch kernels
+    std::vector<float> px, py, pz, rx, ry, rz, rw, sx, sy, sz;
+    std::vector<glm::mat4> local, world;
+
+    TransformSoA view() const {
+        return TransformSoA{
+            px.data(), py.data(), pz.data(),
+            rx.data(), ry.data(), rz.data(), rw.data(),
+            sx.data(), sy.data(), sz.data()
+        };
+    }
+};
+
+Scene makeScene(size_t count) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    Scene scene;
+    scene.transforms.resize(count);
+    scene.parentWorld.resize(count);
+    scene.local.resize(count);
+    scene.world.resize(count);
+
+    for (auto* v : { &scene.px, &scene.py, &scene.pz, &scene.rx, &scene.ry, &scene.rz,
+                     &scene.rw, &scene.sx, &scene.sy, &scene.sz }) {
+        v->resize(count);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        glm::quat q = glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng)));
+        glm::vec3 p(unit(rng) * 100.0f, unit(rng) * 100.0f, unit(rng) * 100.0f);
+        glm::vec3 s(1.0f + unit(rng) * 0.5f);
+
+        Transform& t = scene.transforms[i];
+        t.localPosition = p;
+        t.localRotation = q;
+        t.localScale = s;
+
+        scene.px[i] = p.x; scene.py[i] = p.y; scene.pz[i] = p.z;
+        scene.rx[i] = q.x; scene.ry[i] = q.y; scene.rz[i] = q.z; scene.rw[i] = q.w;
+        scene.sx[i] = s.x; scene.sy[i] = s.y; scene.sz[i] = s.z;
+
+        scene.parentWorld[i] = glm::translate(glm::mat4(1.0f), glm::vec3(unit(rng)));
+    }
+
+    return scene;
+}
+
+template <typename Fn>
+double nanosecondsPerTransform(size_t count, Fn&& fn) {
+    const size_t iterations = std::max<size_t>(3, WORK_PER_SAMPLE / count);
+
+    fn(); // Warm-up
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / static_cast<double>(iterations * count);
+}
+
+// Current path: TransformSystem rebuilt T * R * S with glm and multiplied by the parent
+double runGlm(Scene& scene) {
+    return nanosecondsPerTransform(scene.transforms.size(), [&] {
+        for (size_t i = 0; i < scene.transforms.size(); ++i) {
+            Transform& t = scene.transforms[i];
+            t.rebuildLocalMatrix();
+            t.worldMatrix = scene.parentWorld[i] * t.localMatrix;
+        }
+    });
+}
+
+double runKernels(Scene& scene, SimdLevel level) {
+    TransformKernels::setSimdLevel(level);
+    const size_t count = scene.transforms.size();
+
+    return nanosecondsPerTransform(count, [&] {
+        TransformKernels::composeLocalMatrices(scene.view(), count, scene.local.data());
+        TransformKernels::multiplyMatrices(scene.parentWorld.data(), scene.local.data(), scene.world.data(), count);
+    });
+}
+
+float maxDifference(const Scene& scene) {
+    float diff = 0.0f;
+    for (size_t i = 0; i < scene.transforms.size(); ++i) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                diff = std::max(diff, std::abs(scene.transforms[i].worldMatrix[c][r] - scene.world[i][c][r]));
+            }
+        }
+    }
+    return diff;
+}
+
+} // namespace
+
+int main() {
+    const SimdLevel supported = TransformKernels::getSupportedSimdLevel();
+    std::printf("CPU supports: %s\n\n", TransformKernels::getSimdLevelName(supported));
+    std::printf("%-10s %-8s %14s %10s %12s\n", "count", "path", "ns/transform", "speedup", "max |diff|");
+
+    for (size_t count : { size_t(1'000), size_t(100'000), size_t(1'000'000) }) {
+        Scene scene = makeScene(count);
+
+        double glmNs = runGlm(scene);
+        std::printf("%-10zu %-8s %14.2f %10s %12s\n", count, "glm", glmNs, "1.00x", "-");
+
+        for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2 }) {
+            if (level > supported) continue;
+
+            double ns = runKernels(scene, level);
+            std::printf("%-10zu %-8s %14.2f %9.2fx %12.2e\n",
+                count, TransformKernels::getSimdLevelName(level), ns, glmNs / ns, maxDifference(scene));
+        }
+        std::printf("\n");
+    }
+
+    TransformKernels::setSimdLevel(supported);
+    return 0;
+}
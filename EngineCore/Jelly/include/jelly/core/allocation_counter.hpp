@@ -0,0 +1,37 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace jelly::core {
+
+/// @brief Counts heap allocations made by the process
+///
+/// The engine does not replace the global operator new itself. An executable
+/// that wants the numbers replaces it and calls record() from it, e.g. the
+/// benchmark to check that steady-state frames do not allocate. Without such
+/// a replacement the counters stay at zero.
+class JELLY_EXPORT AllocationCounter {
+public:
+    /// @brief Adds an allocation
+    /// @param bytes Size of the allocation
+    static void record(size_t bytes) {
+        count_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /// @brief Gets the number of allocations since the start
+    static uint64_t getCount() { return count_.load(std::memory_order_relaxed); }
+
+    /// @brief Gets the number of bytes allocated since the start
+    static uint64_t getBytes() { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+    static inline std::atomic<uint64_t> count_{0};
+    static inline std::atomic<uint64_t> bytes_{0};
+};
+
+} // namespace jelly::core
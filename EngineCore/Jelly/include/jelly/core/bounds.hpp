@@ -0,0 +1,149 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace jelly::core {
+
+/// @brief Half-line used by ray casts.
+struct Ray {
+    glm::vec3 origin{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f}; ///< Normalized, so hit distances are in world units
+};
+
+/// @brief Axis-aligned bounding box.
+struct BoundingBox {
+    glm::vec3 min{0.0f};
+    glm::vec3 max{0.0f};
+
+    /// @brief Gets the center of the box
+    glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+
+    /// @brief Gets the half size of the box along each axis
+    glm::vec3 getExtents() const { return (max - min) * 0.5f; }
+
+    /// @brief Gets the surface area, used as insertion cost by the spatial index
+    float getSurfaceArea() const {
+        const glm::vec3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    /// @brief Gets the smallest box containing this one and another
+    BoundingBox merged(const BoundingBox& other) const {
+        return { glm::min(min, other.min), glm::max(max, other.max) };
+    }
+
+    /// @brief Gets the box grown by a margin on every side
+    BoundingBox expanded(float margin) const {
+        return { min - glm::vec3(margin), max + glm::vec3(margin) };
+    }
+
+    /// @brief Returns true if the boxes touch or overlap
+    bool overlaps(const BoundingBox& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x
+            && min.y <= other.max.y && max.y >= other.min.y
+            && min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    /// @brief Returns true if the other box is entirely inside this one
+    bool contains(const BoundingBox& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z
+            && max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    /// @brief Intersects a ray with the box (slab test)
+    /// @param ray Ray to test
+    /// @param maxDistance Hits further than this are ignored
+    /// @param outDistance Receives the entry distance (0 when the origin is inside)
+    /// @return True if the ray enters the box within maxDistance
+    bool intersects(const Ray& ray, float maxDistance, float& outDistance) const {
+        float entry = 0.0f;
+        float exit = maxDistance;
+
+        for (int axis = 0; axis < 3; ++axis) {
+            const float origin = ray.origin[axis];
+            const float direction = ray.direction[axis];
+
+            if (std::abs(direction) < 1e-12f) {
+                if (origin < min[axis] || origin > max[axis]) return false;
+                continue;
+            }
+
+            const float inverse = 1.0f / direction;
+            float nearHit = (min[axis] - origin) * inverse;
+            float farHit = (max[axis] - origin) * inverse;
+            if (nearHit > farHit) std::swap(nearHit, farHit);
+
+            entry = std::max(entry, nearHit);
+            exit = std::min(exit, farHit);
+            if (entry > exit) return false;
+        }
+
+        outDistance = entry;
+        return true;
+    }
+
+    /// @brief Gets the box enclosing this one after a transformation
+    /// @param matrix Affine transformation (e.g. a world matrix)
+    BoundingBox transformed(const glm::mat4& matrix) const {
+        const glm::vec3 center = glm::vec3(matrix * glm::vec4(getCenter(), 1.0f));
+        const glm::vec3 extents = getExtents();
+
+        // Projecting the extents on the absolute basis vectors gives the new half size
+        const glm::vec3 worldExtents =
+            glm::abs(glm::vec3(matrix[0])) * extents.x +
+            glm::abs(glm::vec3(matrix[1])) * extents.y +
+            glm::abs(glm::vec3(matrix[2])) * extents.z;
+
+        return { center - worldExtents, center + worldExtents };
+    }
+
+    /// @brief Builds the smallest box containing every point
+    static BoundingBox fromPoints(const std::vector<glm::vec3>& points) {
+        if (points.empty()) return {};
+
+        BoundingBox box{ points[0], points[0] };
+        for (const glm::vec3& point : points) {
+            box.min = glm::min(box.min, point);
+            box.max = glm::max(box.max, point);
+        }
+        return box;
+    }
+};
+
+/// @brief Bounding sphere.
+struct BoundingSphere {
+    glm::vec3 center{0.0f};
+    float radius = 0.0f;
+
+    /// @brief Gets the sphere enclosing this one after a transformation
+    /// @param matrix Affine transformation; the radius grows with the largest axis scale
+    BoundingSphere transformed(const glm::mat4& matrix) const {
+        const float scale = std::max({
+            glm::length(glm::vec3(matrix[0])),
+            glm::length(glm::vec3(matrix[1])),
+            glm::length(glm::vec3(matrix[2]))
+        });
+
+        return { glm::vec3(matrix * glm::vec4(center, 1.0f)), radius * scale };
+    }
+
+    /// @brief Builds a sphere centered on the box that contains every point
+    static BoundingSphere fromPoints(const std::vector<glm::vec3>& points, const BoundingBox& box) {
+        BoundingSphere sphere{ box.getCenter(), 0.0f };
+
+        float radiusSquared = 0.0f;
+        for (const glm::vec3& point : points) {
+            const glm::vec3 offset = point - sphere.center;
+            radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+        }
+        sphere.radius = std::sqrt(radiusSquared);
+        return sphere;
+    }
+};
+
+} // namespace jelly::core
@@ -17,6 +17,7 @@ public:
     explicit CameraSystem(entt::registry &registry, float viewportWidth, float viewportHeight);
 
     void update() override;
+    void declareAccess(SystemAccess& access) const override;
     void onResize(float w, float h);
 
 private:
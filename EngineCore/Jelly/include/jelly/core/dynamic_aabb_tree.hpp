@@ -0,0 +1,221 @@
+#pragma once
+
+#include "bounds.hpp"
+#include "frustum.hpp"
+
+#include "jelly/jelly_export.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jelly::core {
+
+/// @brief Incrementally balanced bounding volume hierarchy of boxes.
+///
+/// Every proxy is stored in a leaf with a box enlarged by a margin, so small
+/// movements only cost a containment check; a proxy is reinserted once it
+/// leaves its enlarged box. Leaves are inserted where they grow the total
+/// surface area the least and internal nodes are rotated to keep the tree
+/// height logarithmic.
+///
+/// Queries report leaves through a callback taking the proxy id and returning
+/// whether the traversal should continue.
+class JELLY_EXPORT DynamicAabbTree {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+
+    /// @brief Creates an empty tree
+    /// @param margin Distance added around every proxy box
+    explicit DynamicAabbTree(float margin = 0.1f);
+
+    /// @brief Inserts a box
+    /// @param box Tight bounds of the object
+    /// @param userData Value returned by getUserData()
+    /// @return Proxy id
+    int32_t createProxy(const BoundingBox& box, uint64_t userData);
+
+    /// @brief Removes a proxy
+    void destroyProxy(int32_t proxyId);
+
+    /// @brief Updates the bounds of a proxy
+    /// @return True if the proxy had to be reinserted
+    bool moveProxy(int32_t proxyId, const BoundingBox& box);
+
+    /// @brief Removes every proxy
+    void clear();
+
+    /// @brief Gets the value given to createProxy()
+    uint64_t getUserData(int32_t proxyId) const { return nodes_[proxyId].userData; }
+
+    /// @brief Gets the enlarged box stored for a proxy
+    const BoundingBox& getFatBox(int32_t proxyId) const { return nodes_[proxyId].box; }
+
+    /// @brief Gets the number of proxies
+    size_t getProxyCount() const { return proxyCount_; }
+
+    /// @brief Gets the height of the tree (0 for a single leaf)
+    int32_t getHeight() const { return root_ == NULL_NODE ? 0 : nodes_[root_].height; }
+
+    /// @brief Gets the largest height difference between the children of a node
+    int32_t getMaxBalance() const;
+
+    /// @brief Checks the structure of the tree, for tests
+    ///
+    /// Parent and child links must agree, every internal node must have the
+    /// height above its tallest child and a box containing both children, and
+    /// every node must be either in the tree or in the free list.
+    /// @return False at the first broken invariant
+    bool validate() const;
+
+    /// @brief Reports every proxy whose enlarged box overlaps a box
+    template <typename Callback>
+    void query(const BoundingBox& box, Callback&& callback) const {
+        NodeStack stack;
+        stack.push(root_);
+
+        while (!stack.empty()) {
+            const int32_t index = stack.pop();
+            if (index == NULL_NODE) continue;
+
+            const Node& node = nodes_[index];
+            if (!node.box.overlaps(box)) continue;
+
+            if (node.isLeaf()) {
+                if (!callback(index)) return;
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    /// @brief Reports every proxy whose enlarged box is at least partially inside a frustum
+    ///
+    /// Subtrees entirely inside the frustum are reported without further plane tests.
+    template <typename Callback>
+    void query(const Frustum& frustum, Callback&& callback) const {
+        NodeStack stack;
+        stack.push(root_);
+
+        while (!stack.empty()) {
+            const int32_t index = stack.pop();
+            if (index == NULL_NODE) continue;
+
+            const Node& node = nodes_[index];
+            if (!frustum.intersects(node.box)) continue;
+
+            if (node.isLeaf()) {
+                if (!callback(index)) return;
+            } else if (frustum.contains(node.box)) {
+                if (!reportLeaves(index, callback)) return;
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    /// @brief Reports every proxy whose enlarged box is hit by a ray
+    ///
+    /// The callback receives the proxy id and the current maximum distance and
+    /// returns the new maximum distance: the hit distance to clip the ray, the
+    /// same value to ignore the proxy, or 0 to stop.
+    template <typename Callback>
+    void rayCast(const Ray& ray, float maxDistance, Callback&& callback) const {
+        NodeStack stack;
+        stack.push(root_);
+
+        while (!stack.empty()) {
+            const int32_t index = stack.pop();
+            if (index == NULL_NODE) continue;
+
+            const Node& node = nodes_[index];
+            float distance = 0.0f;
+            if (!node.box.intersects(ray, maxDistance, distance)) continue;
+
+            if (node.isLeaf()) {
+                const float value = callback(index, maxDistance);
+                if (value == 0.0f) return;
+                if (value > 0.0f && value < maxDistance) maxDistance = value;
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+private:
+    struct Node {
+        BoundingBox box;
+        uint64_t userData = 0;
+        int32_t parent = NULL_NODE; // Next free node while in the free list
+        int32_t child1 = NULL_NODE;
+        int32_t child2 = NULL_NODE;
+        int32_t height = -1;        // 0 for leaves, -1 for free nodes
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    /// @brief Traversal stack that only allocates for very deep trees
+    class NodeStack {
+    public:
+        void push(int32_t index) {
+            if (size_ < INLINE_CAPACITY) {
+                inline_[size_++] = index;
+            } else {
+                overflow_.push_back(index);
+                ++size_;
+            }
+        }
+
+        int32_t pop() {
+            --size_;
+            if (size_ < INLINE_CAPACITY) return inline_[size_];
+            int32_t index = overflow_.back();
+            overflow_.pop_back();
+            return index;
+        }
+
+        bool empty() const { return size_ == 0; }
+
+    private:
+        static constexpr size_t INLINE_CAPACITY = 256;
+        int32_t inline_[INLINE_CAPACITY];
+        std::vector<int32_t> overflow_;
+        size_t size_ = 0;
+    };
+
+    std::vector<Node> nodes_;
+    int32_t root_ = NULL_NODE;
+    int32_t freeList_ = NULL_NODE;
+    size_t proxyCount_ = 0;
+    float margin_;
+
+    template <typename Callback>
+    bool reportLeaves(int32_t subtree, Callback& callback) const {
+        NodeStack stack;
+        stack.push(subtree);
+
+        while (!stack.empty()) {
+            const Node& node = nodes_[stack.pop()];
+            if (node.isLeaf()) {
+                if (!callback(static_cast<int32_t>(&node - nodes_.data()))) return false;
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+        return true;
+    }
+
+    int32_t allocateNode();
+    void freeNode(int32_t index);
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+
+    /// @brief Rotates the subtree at index if it is unbalanced, returns the new subtree root
+    int32_t balance(int32_t index);
+};
+
+} // namespace jelly::core
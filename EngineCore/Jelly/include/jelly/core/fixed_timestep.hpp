@@ -0,0 +1,62 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <cstdint>
+
+namespace jelly::core {
+
+/// @brief Accumulator that turns variable frame times into fixed simulation steps
+///
+/// Time is accumulated in integer nanoseconds, so the number of steps taken for
+/// a given sequence of frame times is exact and the simulation stays
+/// deterministic regardless of the display refresh rate.
+///
+/// At most maxStepsPerFrame steps run per frame. When a frame falls further
+/// behind, the excess whole steps are dropped (the simulation slows down)
+/// instead of being carried over, which would make every following frame even
+/// slower (the "spiral of death").
+class JELLY_EXPORT FixedTimestep {
+public:
+    static constexpr double DEFAULT_TICK_RATE = 60.0;
+    static constexpr uint32_t DEFAULT_MAX_STEPS_PER_FRAME = 5;
+
+    /// @brief Sets the number of fixed steps per simulated second
+    /// @param ticksPerSecond Values <= 0 are ignored
+    void setTickRate(double ticksPerSecond);
+
+    /// @brief Sets how many steps a single frame may catch up
+    /// @param steps Clamped to at least 1
+    void setMaxStepsPerFrame(uint32_t steps);
+
+    /// @brief Adds the elapsed frame time and takes whole steps from the accumulator
+    /// @param elapsedSeconds Time since the previous frame
+    /// @return Number of fixed steps to run this frame
+    uint32_t advance(double elapsedSeconds);
+
+    /// @brief Discards the accumulated time, e.g. after loading a scene
+    void reset() { accumulatorNs_ = 0; }
+
+    /// @brief Gets the length of a step in seconds
+    double getStepSeconds() const { return static_cast<double>(stepNs_) * 1e-9; }
+
+    /// @brief Gets the fraction of a step left in the accumulator, in [0, 1)
+    ///
+    /// Renderers blend the last two simulation states by this amount.
+    float getAlpha() const { return static_cast<float>(static_cast<double>(accumulatorNs_) / static_cast<double>(stepNs_)); }
+
+    /// @brief Gets the number of steps taken since the start
+    uint64_t getTickCount() const { return tickCount_; }
+
+    /// @brief Gets the number of steps dropped because frames fell too far behind
+    uint64_t getDroppedSteps() const { return droppedSteps_; }
+
+private:
+    int64_t stepNs_ = static_cast<int64_t>(1e9 / DEFAULT_TICK_RATE + 0.5);
+    int64_t accumulatorNs_ = 0;
+    uint32_t maxStepsPerFrame_ = DEFAULT_MAX_STEPS_PER_FRAME;
+    uint64_t tickCount_ = 0;
+    uint64_t droppedSteps_ = 0;
+};
+
+} // namespace jelly::core
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace jelly::core {
+
+/// @brief Linear allocator for transient CPU data that does not outlive a frame.
+///
+/// Allocating bumps an offset in the current block and deallocating does nothing;
+/// memory is released all at once by reset() or when a Scope ends. When a block
+/// is full another one is taken from the upstream resource, and the next reset()
+/// merges them into a single block large enough for the whole frame, so a steady
+/// workload stops touching the heap after a few frames.
+///
+/// Every thread has its own allocator (local()), so allocating takes no lock.
+/// Memory may be read by other threads, but only the owning thread allocates and
+/// resets. Containers opt in through std::pmr:
+///
+///     FrameAllocator::Scope scope;
+///     std::pmr::vector<uint32_t> indices(scope.resource());
+class JELLY_EXPORT FrameAllocator final : public std::pmr::memory_resource {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    /// @brief Rewinds the allocator to where it was when the scope began.
+    ///
+    /// Lets code that may run anywhere in a frame (jobs, recording threads) free
+    /// its scratch memory early. Scopes of one allocator must nest.
+    class JELLY_EXPORT Scope {
+    public:
+        /// @brief Opens a scope on the calling thread's allocator
+        Scope() : Scope(local()) {}
+        explicit Scope(FrameAllocator& allocator);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /// @brief Gets the allocator as a memory resource for std::pmr containers
+        std::pmr::memory_resource* resource() const { return &allocator_; }
+
+    private:
+        FrameAllocator& allocator_;
+        size_t block_;
+        size_t offset_;
+    };
+
+    /// @param blockSize Size of the first block; later blocks are at least this large
+    /// @param upstream Resource the blocks are taken from
+    explicit FrameAllocator(size_t blockSize = DEFAULT_BLOCK_SIZE,
+                            std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~FrameAllocator() override;
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    /// @brief Gets the calling thread's allocator
+    static FrameAllocator& local();
+
+    /// @brief Releases everything allocated since the last reset; call once per frame
+    void reset();
+
+    /// @brief Gets the number of bytes handed out since the last reset, padding included
+    size_t getUsedBytes() const;
+
+    /// @brief Gets the total size of the blocks owned by the allocator
+    size_t getCapacity() const;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct Block {
+        std::byte* data = nullptr;
+        size_t size = 0;
+    };
+
+    std::pmr::memory_resource* upstream_;
+    size_t blockSize_;
+
+    std::vector<Block> blocks_;
+    size_t current_ = 0; // Block allocations are taken from
+    size_t offset_ = 0;  // Bytes used in the current block
+
+    void releaseBlocks();
+};
+
+} // namespace jelly::core
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <chrono>
+
+namespace jelly::core {
+
+/// @brief Timings of the last completed frame, in milliseconds
+struct FramePacingStats {
+    double frameMs = 0.0;  ///< Start of the pacing sleep to the end of the frame
+    double sleepMs = 0.0;  ///< Slept by the pacer before input was polled
+    double waitMs = 0.0;   ///< Blocked on the frame fence, image acquire and present (FramePhase::Present)
+    double cpuMs = 0.0;    ///< Frame work excluding the pacing sleep and the waits
+    double gpuMs = 0.0;    ///< GPU time of the latest resolved frame (0 without GPU timestamps)
+};
+
+/// @brief Paces the main loop to a target frame rate and reduces input-to-photon latency
+///
+/// With a target frame rate the pacer sleeps until one frame interval after the
+/// previous frame started. With low latency enabled it also predicts how long
+/// the frame would block on the GPU (fence wait, acquire, present) and sleeps
+/// that long *before* input is polled, so the frame samples input as late as
+/// possible instead of waiting with stale input. A safety margin keeps the GPU
+/// fed; the prediction follows the measured waits, so it settles where the
+/// remaining wait is about the margin.
+///
+/// Sleeps use the OS scheduler for the bulk and spin for the last stretch.
+class JELLY_EXPORT FramePacer {
+public:
+    /// @brief Sets the frame rate to cap to
+    /// @param framesPerSecond Target rate, 0 for no cap
+    void setTargetFrameRate(double framesPerSecond);
+
+    /// @brief Enables sleeping the predicted GPU wait before input is polled
+    void setLowLatency(bool enabled);
+
+    bool isLowLatency() const { return lowLatency_; }
+
+    /// @brief Sleeps as needed; call at the start of the frame, before polling input
+    void beginFrame();
+
+    /// @brief Records the timings of the frame; call after it was presented
+    /// @param gpuMs GPU time of the latest resolved frame, 0 if unknown
+    void endFrame(double gpuMs);
+
+    /// @brief Gets the timings of the last completed frame
+    const FramePacingStats& getLastStats() const { return lastStats_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr double SPIN_MS = 1.0;          // Spun instead of slept at the end of a sleep
+    static constexpr double LATENCY_MARGIN_MS = 1.0; // Wait left to the GPU in low latency mode
+    static constexpr double SMOOTHING = 0.1;         // Weight of the newest frame in the slack average
+
+    double targetIntervalMs_ = 0.0;
+    bool lowLatency_ = false;
+
+    Clock::time_point frameStart_{};     // After the pacing sleep
+    double sleepMs_ = 0.0;
+    double slackMs_ = 0.0;               // Smoothed sleep + wait: time the CPU could have slept
+    bool started_ = false;
+
+    FramePacingStats lastStats_;
+
+    /// @brief Sleeps until a point in time, spinning for the last SPIN_MS
+    static void sleepUntil(Clock::time_point time);
+};
+
+} // namespace jelly::core
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace jelly::core {
+
+/// @brief Engine phases timed every frame
+enum class FramePhase : uint8_t {
+    Update,     ///< Scene update and fixed update systems (includes Transform)
+    Transform,  ///< World matrix propagation
+    Culling,    ///< Frustum culling and GPU culling setup
+    Recording,  ///< Render queue build, sort and command recording
+    Submit,     ///< Command buffer end and queue submission
+    Present,    ///< Frame slot fence wait, image acquire and present
+    Count
+};
+
+/// @brief Accumulates the CPU time spent in each FramePhase and keeps the totals of the last frame
+///
+/// Phases may be entered from job workers and the render thread, so the
+/// running totals are atomic. endFrame() moves them into the totals get()
+/// reports, once no thread is inside a phase of that frame. With a render
+/// thread, a frame therefore holds the simulation phases of one frame and
+/// the rendering phases of the previous one. Nested phases are not
+/// subtracted from their parent: Update includes Transform.
+class JELLY_EXPORT FrameTimings {
+public:
+    /// @brief Publishes the running totals as the last frame's and starts new ones
+    /// @note Called once per frame by Jelly, after waiting for the render thread
+    static void endFrame() {
+        for (size_t i = 0; i < totals_.size(); ++i) {
+            lastFrame_[i].store(totals_[i].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Adds time to a phase
+    /// @param phase Phase the time was spent in
+    /// @param nanoseconds Elapsed time in nanoseconds
+    static void add(FramePhase phase, uint64_t nanoseconds) {
+        totals_[static_cast<size_t>(phase)].fetch_add(nanoseconds, std::memory_order_relaxed);
+    }
+
+    /// @brief Gets the time spent in a phase during the last completed frame in nanoseconds
+    static uint64_t get(FramePhase phase) {
+        return lastFrame_[static_cast<size_t>(phase)].load(std::memory_order_relaxed);
+    }
+
+    /// @brief Gets the lowercase name of a phase, e.g. "culling"
+    static const char* name(FramePhase phase) {
+        static constexpr const char* names[] = {
+            "update", "transform", "culling", "recording", "submit", "present"
+        };
+        return names[static_cast<size_t>(phase)];
+    }
+
+private:
+    static inline std::array<std::atomic<uint64_t>, static_cast<size_t>(FramePhase::Count)> totals_{};
+    static inline std::array<std::atomic<uint64_t>, static_cast<size_t>(FramePhase::Count)> lastFrame_{};
+};
+
+/// @brief Adds the lifetime of the scope to a FramePhase
+class ScopedFrameTiming {
+public:
+    explicit ScopedFrameTiming(FramePhase phase)
+        : phase_(phase), start_(std::chrono::steady_clock::now()) {}
+
+    ~ScopedFrameTiming() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        FrameTimings::add(phase_, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ScopedFrameTiming(const ScopedFrameTiming&) = delete;
+    ScopedFrameTiming& operator=(const ScopedFrameTiming&) = delete;
+
+private:
+    FramePhase phase_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace jelly::core
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "bounds.hpp"
+
+#include "jelly/jelly_export.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace jelly::core {
+
+/// @brief Structure-of-arrays view over a batch of world-space boxes.
+///
+/// Boxes are given as centers and half extents; every pointer addresses
+/// count consecutive floats.
+struct BoxSoA {
+    const float* centerX = nullptr;
+    const float* centerY = nullptr;
+    const float* centerZ = nullptr;
+    const float* extentX = nullptr;
+    const float* extentY = nullptr;
+    const float* extentZ = nullptr;
+};
+
+/// @brief View frustum described by six inward-facing planes.
+///
+/// Planes are extracted from a view-projection matrix using the [0, 1] clip
+/// depth range of Vulkan. Batch tests use the instruction set selected in
+/// TransformKernels.
+class JELLY_EXPORT Frustum {
+public:
+    enum Plane { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    Frustum() = default;
+
+    /// @brief Extracts the planes of a view-projection matrix
+    /// @param viewProjection projection * view
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    /// @brief Gets a normalized plane (xyz = normal pointing inside, w = distance)
+    const glm::vec4& getPlane(Plane plane) const { return planes_[plane]; }
+
+    /// @brief Returns true if the box is at least partially inside
+    bool intersects(const BoundingBox& box) const;
+
+    /// @brief Returns true if the box is entirely inside
+    bool contains(const BoundingBox& box) const;
+
+    /// @brief Returns true if the sphere is at least partially inside
+    bool intersects(const BoundingSphere& sphere) const;
+
+    /// @brief Tests a batch of boxes
+    /// @param boxes SoA centers and half extents
+    /// @param count Number of boxes
+    /// @param outVisible Receives 1 for boxes at least partially inside, 0 otherwise
+    /// @return Number of visible boxes
+    size_t testBoxes(const BoxSoA& boxes, size_t count, uint8_t* outVisible) const;
+
+private:
+    std::array<glm::vec4, PlaneCount> planes_{};
+};
+
+} // namespace jelly::core
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "jelly/jelly_export.hpp"
+#include "jelly/core/system_access.hpp"
+
+#include <cstdint>
 
 namespace jelly::core {
 
@@ -22,11 +25,26 @@ public:
     /// @brief Called at a fixed timestep for deterministic updates (e.g., physics).
     virtual void fixedUpdate() {}
 
+    /// @brief Called every frame on the main thread, after update(), to copy what render() needs.
+    ///
+    /// With a render thread, render() runs concurrently with the next frame's
+    /// update(), so it must only read data copied here, never the registry.
+    /// @param frame Index of the frame, passed again to the render() drawing it
+    virtual void extractRenderData(uint64_t frame) {}
+
     /// @brief Called every frame to perform rendering operations.
-    virtual void render() {}
+    /// @param frame Index of the frame whose extracted data to draw
+    virtual void render(uint64_t frame) {}
 
     /// @brief Called once to clean up system resources.
     virtual void shutdown() {}
+
+    /// @brief Declares the components touched by update() and fixedUpdate().
+    ///
+    /// Systems whose declarations do not conflict may be updated concurrently.
+    /// Systems that declare nothing always run alone, in registration order.
+    /// @param access Receives the read and written component types
+    virtual void declareAccess(SystemAccess& access) const {}
 };
 
 } // namespace jelly::core
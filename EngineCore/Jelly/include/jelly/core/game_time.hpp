@@ -45,6 +45,21 @@ public:
     /// @return Frame count
     static long  frameCount() { return frameCount_; }
 
+    /// @brief Gets the length of a fixed simulation step in seconds
+    /// @return Step length to integrate with in fixedUpdate()
+    static float fixedDeltaTime() { return fixedDeltaTime_; }
+
+    /// @brief Gets how far the current frame is between the last two fixed steps
+    /// @return Blend factor in [0, 1)
+    static float interpolationAlpha() { return interpolationAlpha_; }
+
+    /// @brief Publishes the fixed step state of the current frame
+    /// @note Called once per frame by Jelly::update()
+    static void setFixedStep(float fixedDeltaTime, float interpolationAlpha) {
+        fixedDeltaTime_ = fixedDeltaTime;
+        interpolationAlpha_ = interpolationAlpha;
+    }
+
 private:
     static inline std::chrono::high_resolution_clock::time_point startTime_;
     static inline std::chrono::high_resolution_clock::time_point lastFrameTime_;
@@ -52,6 +67,8 @@ private:
     static inline float deltaTime_ = 0.0f;
     static inline float totalTime_ = 0.0f;
     static inline long frameCount_ = 0;
+    static inline float fixedDeltaTime_ = 1.0f / 60.0f;
+    static inline float interpolationAlpha_ = 0.0f;
 };
 
 } // namespace jelly::core
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace jelly::core {
+
+/// @brief Local TRS values of a Transform at one simulation step.
+struct TransformState {
+    glm::vec3 position{0.0f};
+    glm::quat rotation{1,0,0,0};
+    glm::vec3 scale{1.0f};
+};
+
+/// @brief Opts a Transform into render-side interpolation between fixed simulation steps.
+///
+/// Keeps the local TRS of the last two simulation states. Before each fixed step
+/// the Transform is restored to the latest simulated state, so fixedUpdate()
+/// systems never see interpolated values. Before update() the Transform is set
+/// to a blend of the two states by the fraction of a step left in the accumulator.
+///
+/// Move interpolated entities from fixedUpdate(); changes made in update() are
+/// replaced by the next fixed step. Call snap() after a teleport so the entity
+/// does not slide from its previous position.
+struct JELLY_EXPORT InterpolatedTransform {
+    TransformState previous; // State before the last fixed step
+    TransformState current;  // State after the last fixed step
+    bool initialized = false; // False until the states were captured from the Transform
+
+    /// @brief Restarts both states from the Transform's values at the next fixed step
+    void snap() { initialized = false; }
+};
+
+} // namespace jelly::core
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+#include "jelly/core/frame_allocator.hpp"
+#include "jelly/core/pool_allocator.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace jelly::core {
+
+/// @brief Tracks a group of scheduled jobs.
+///
+/// The counter is incremented when a job is scheduled against it and decremented
+/// when the job finishes. Jobs can be chained after a counter with
+/// JobSystem::scheduleAfter(), and JobSystem::wait() blocks until it reaches zero.
+/// The first exception thrown by one of its jobs is kept and rethrown by wait().
+/// A counter must outlive the jobs scheduled against it.
+class JELLY_EXPORT JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    /// @brief Returns true when every job scheduled against the counter has finished
+    bool isDone() const { return value_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    struct Continuation {
+        std::function<void()> function;
+        JobCounter* counter = nullptr;
+    };
+
+    std::atomic<uint32_t> value_{0};
+    std::mutex mutex_;
+    std::vector<Continuation> continuations_;
+    std::exception_ptr exception_; // First exception of a job, guarded by mutex_
+};
+
+/// @brief Work-stealing job scheduler shared by the engine.
+///
+/// Every worker thread owns a deque: it pushes and pops its own jobs at the back
+/// (LIFO, cache friendly) while idle workers steal from the front of the others.
+/// Threads that are not workers (e.g. the main thread) push to a shared queue and
+/// help executing jobs while they wait on a counter, so nested parallelism never
+/// blocks a thread.
+///
+/// When the system is not initialized, or has no workers, every job runs on the
+/// thread that waits for it.
+class JELLY_EXPORT JobSystem {
+public:
+    /// @brief Gets the singleton instance
+    static JobSystem& get();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /// @brief Starts the worker threads
+    /// @param workerCount Number of background workers; 0 uses one per hardware thread minus the caller
+    void initialize(uint32_t workerCount = 0);
+
+    /// @brief Runs the remaining jobs and joins the worker threads
+    void shutdown();
+
+    /// @brief Gets the number of background worker threads
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(threads_.size()); }
+
+    /// @brief Gets the number of threads that execute jobs (workers plus the waiting thread)
+    uint32_t getThreadCount() const { return getWorkerCount() + 1; }
+
+    /// @brief Gets the index of the calling thread: 1..N for workers, 0 for any other thread
+    static uint32_t getThreadIndex();
+
+    /// @brief Queues a job
+    ///
+    /// Exceptions of a job reach the thread that waits on its counter; a job
+    /// without a counter must not throw.
+    /// @param job Function to execute
+    /// @param counter Optional counter signalled when the job finishes
+    void schedule(std::function<void()> job, JobCounter* counter = nullptr);
+
+    /// @brief Queues a job once every job of a dependency counter has finished
+    /// @param dependency Counter the job waits on
+    /// @param job Function to execute
+    /// @param counter Optional counter signalled when the job finishes
+    void scheduleAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr);
+
+    /// @brief Executes queued jobs on the calling thread until the counter reaches zero
+    /// @throws The first exception thrown by a job of the counter, once every job finished
+    void wait(JobCounter& counter);
+
+    /// @brief Splits [0, count) into chunks and processes them in parallel
+    /// @param count Number of items
+    /// @param grainSize Minimum number of items per job
+    /// @param body Called with [begin, end) for every chunk
+    /// @throws The first exception thrown by body, once every chunk finished
+    void parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& body);
+
+    /// @brief Calls fn(entity, components...) for every entity of an EnTT view, in parallel
+    ///
+    /// The entities are snapshotted before the jobs start; fn must not add or remove
+    /// components of the viewed types.
+    /// @param view Any EnTT view
+    /// @param fn Callable taking the entity followed by references to the view components
+    /// @param grainSize Minimum number of entities per job
+    template <typename View, typename Func>
+    void parallelForEach(const View& view, Func&& fn, uint32_t grainSize = 256) {
+        using Entity = typename View::entity_type;
+
+        FrameAllocator::Scope scope;
+        std::pmr::vector<Entity> entities(scope.resource());
+        if constexpr (requires { view.size_hint(); }) {
+            entities.reserve(view.size_hint());
+        } else {
+            entities.reserve(view.size());
+        }
+        for (auto entity : view) {
+            entities.push_back(entity);
+        }
+
+        parallelFor(static_cast<uint32_t>(entities.size()), grainSize, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                const Entity entity = entities[i];
+                std::apply([&](auto&... components) { fn(entity, components...); }, view.get(entity));
+            }
+        });
+    }
+
+private:
+    JobSystem();
+    ~JobSystem();
+
+    struct Job {
+        std::function<void()> function;
+        JobCounter* counter = nullptr;
+    };
+
+    // Block size of the queue pools; fits a deque node of jobs
+    static constexpr size_t QUEUE_NODE_SIZE = 512;
+
+    struct WorkQueue {
+        std::mutex mutex;
+        PoolAllocator nodes{ QUEUE_NODE_SIZE, 8 }; // Recycles the deque nodes, guarded by mutex
+        std::pmr::deque<Job> jobs{ &nodes };
+    };
+
+    // queues_[0] is shared by non-worker threads, queues_[i] belongs to worker i
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> queuedJobs_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wakeCondition_;
+
+    void push(Job job);
+    bool tryPop(uint32_t threadIndex, Job& outJob);
+    bool tryRunJob(uint32_t threadIndex);
+    void execute(Job& job);
+    void finish(JobCounter& counter);
+    void workerLoop(uint32_t threadIndex);
+};
+
+} // namespace jelly::core
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace jelly::core {
+
+/// @brief Allocator of fixed-size blocks for objects created and destroyed at a high rate.
+///
+/// Requests that fit a block are served from a free list, refilled one chunk of
+/// blocks at a time from the upstream resource; larger requests go straight to
+/// upstream. Freed blocks return to the list and chunks are only released with
+/// the pool, so once a container reached its peak size, clearing and refilling
+/// it costs no heap allocation. Meant for node-based containers (hash maps,
+/// deques, lists) through std::pmr:
+///
+///     PoolAllocator nodes(64);
+///     std::pmr::unordered_map<uint32_t, uint32_t> map(&nodes);
+///
+/// The pool must outlive its containers. It is not thread-safe: guard it with
+/// the lock of the container that uses it.
+class JELLY_EXPORT PoolAllocator final : public std::pmr::memory_resource {
+public:
+    static constexpr size_t DEFAULT_BLOCKS_PER_CHUNK = 64;
+
+    /// @param blockSize Largest request served from the pool
+    /// @param blocksPerChunk Number of blocks taken from upstream at once
+    /// @param upstream Resource chunks and oversized requests are taken from
+    explicit PoolAllocator(size_t blockSize,
+                           size_t blocksPerChunk = DEFAULT_BLOCKS_PER_CHUNK,
+                           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~PoolAllocator() override;
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    /// @brief Gets the size of a block, after rounding up for alignment
+    size_t getBlockSize() const { return blockSize_; }
+
+    /// @brief Gets the number of blocks owned by the pool, free or not
+    size_t getCapacity() const { return chunks_.size() * blocksPerChunk_; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::pmr::memory_resource* upstream_;
+    size_t blockSize_;
+    size_t blocksPerChunk_;
+
+    FreeBlock* freeList_ = nullptr;
+    std::vector<void*> chunks_;
+
+    bool fits(size_t bytes, size_t alignment) const;
+    void grow();
+};
+
+} // namespace jelly::core
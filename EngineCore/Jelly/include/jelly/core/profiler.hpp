@@ -0,0 +1,106 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace jelly::core {
+
+/// @brief Records scoped CPU zones and writes them as a Chrome trace.
+///
+/// Each thread appends to its own fixed-size ring buffer, so recording a zone
+/// is two clock reads and a store without locks. Zones are only recorded
+/// while a capture is running; outside of one a zone costs a relaxed atomic
+/// load. When a thread records more zones than its ring holds during a
+/// capture, the oldest ones are overwritten.
+///
+/// Zone names must be string literals (or otherwise outlive the capture).
+/// Build with JELLY_ENABLE_PROFILER=OFF to compile the zones out entirely.
+///
+/// The written file opens in chrome://tracing and https://ui.perfetto.dev.
+class JELLY_EXPORT Profiler {
+public:
+    /// @brief Zones kept per thread
+    static constexpr uint32_t RING_CAPACITY = 1u << 16;
+
+    /// @brief Starts recording zones; zones recorded by an earlier capture are discarded
+    static void beginCapture();
+
+    /// @brief Stops recording zones
+    static void endCapture();
+
+    /// @brief Returns true while a capture is running
+    static bool isCapturing() { return capturing_.load(std::memory_order_relaxed); }
+
+    /// @brief Writes the zones of the last capture as Chrome trace event JSON
+    ///
+    /// Call after endCapture() once the instrumented threads are idle.
+    /// @param path Output file
+    /// @return False if the file could not be written
+    static bool writeChromeTrace(const std::string& path);
+
+    /// @brief Names the calling thread in the trace
+    /// @param name Copied; may be called before or during a capture
+    static void setThreadName(const std::string& name);
+
+    /// @brief Gets the profiler clock in nanoseconds
+    static uint64_t now();
+
+    /// @brief Converts a steady_clock time point to the profiler clock
+    static uint64_t fromSteadyClock(std::chrono::steady_clock::time_point time);
+
+    /// @brief Records a finished zone on the calling thread
+    /// @param name Zone name, must outlive the capture
+    /// @param start Start time from now()
+    /// @param end End time from now()
+    static void record(const char* name, uint64_t start, uint64_t end);
+
+    /// @brief Creates a named track for zones that do not belong to a CPU thread (e.g. GPU work)
+    /// @return Track id for recordOnTrack()
+    static uint32_t createTrack(const std::string& name);
+
+    /// @brief Records a finished zone on a track; each track must have a single writing thread
+    static void recordOnTrack(uint32_t track, const char* name, uint64_t start, uint64_t end);
+
+private:
+    static inline std::atomic<bool> capturing_{false};
+};
+
+/// @brief Records the lifetime of the scope as a profiler zone
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name)
+        : name_(Profiler::isCapturing() ? name : nullptr),
+          start_(name_ ? Profiler::now() : 0) {}
+
+    ~ProfileZone() {
+        if (name_) {
+            Profiler::record(name_, start_, Profiler::now());
+        }
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_;
+};
+
+} // namespace jelly::core
+
+#define JELLY_PROFILE_CONCAT_INNER(a, b) a##b
+#define JELLY_PROFILE_CONCAT(a, b) JELLY_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef JELLY_PROFILE
+/// @brief Profiles the rest of the enclosing scope under a literal name
+#define JELLY_PROFILE_SCOPE(name) ::jelly::core::ProfileZone JELLY_PROFILE_CONCAT(jellyProfileZone, __LINE__)(name)
+/// @brief Profiles the rest of the enclosing function under its name
+#define JELLY_PROFILE_FUNCTION() JELLY_PROFILE_SCOPE(__func__)
+#else
+#define JELLY_PROFILE_SCOPE(name) ((void)0)
+#define JELLY_PROFILE_FUNCTION() ((void)0)
+#endif
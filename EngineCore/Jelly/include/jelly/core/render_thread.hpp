@@ -0,0 +1,65 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace jelly::core {
+
+/// @brief Dedicated thread that records and submits one frame at a time.
+///
+/// The main thread hands a frame over with submit() and keeps simulating the
+/// next one. wait() blocks until the frame in flight is done, so at most one
+/// frame is rendered while another is simulated. Exceptions thrown by a frame
+/// are rethrown on the main thread by the next wait().
+class JELLY_EXPORT RenderThread {
+public:
+    RenderThread() = default;
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /// @brief Starts the thread
+    void start();
+
+    /// @brief Waits for the frame in flight and joins the thread
+    void stop();
+
+    /// @brief Returns true between start() and stop()
+    bool isRunning() const { return thread_.joinable(); }
+
+    /// @brief Hands a frame to the thread; the previous one must have been waited for
+    /// @param frame Records and submits the frame
+    void submit(std::function<void()> frame);
+
+    /// @brief Blocks until the submitted frame is done
+    /// @throws Whatever the frame threw
+    void wait();
+
+    /// @brief Blocks until the submitted frame is done or the timeout expires
+    /// @return False on timeout
+    /// @throws Whatever the frame threw
+    bool waitFor(std::chrono::milliseconds timeout);
+
+private:
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable frameReady_;
+    std::condition_variable frameDone_;
+
+    std::function<void()> frame_;
+    bool busy_ = false;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+
+    void run();
+};
+
+} // namespace jelly::core
@@ -38,13 +38,28 @@ public:
     void initialize();
 
     /// @brief Calls `update()` on all game systems.
+    ///
+    /// Consecutive systems with non-conflicting component access run in parallel
+    /// on the JobSystem; the others keep their registration order.
     void update();
 
-    /// @brief Calls `fixedUpdate()` on all game systems.
+    /// @brief Calls `fixedUpdate()` on all game systems, batched like `update()`.
+    ///
+    /// Entities with an InterpolatedTransform are restored to their last simulated
+    /// state first, and their new state is captured after the systems ran.
     void fixedUpdate();
 
+    /// @brief Blends every InterpolatedTransform between its last two simulation states.
+    /// @param alpha Fraction of a fixed step elapsed since the last one, in [0, 1)
+    void interpolateTransforms(float alpha);
+
+    /// @brief Calls `extractRenderData()` on all game systems.
+    /// @param frame Index of the frame being extracted
+    void extractRenderData(uint64_t frame);
+
     /// @brief Calls `render()` on all game systems.
-    void render();
+    /// @param frame Index of the frame being rendered
+    void render(uint64_t frame);
 
     /// @brief Calls `shutdown()` on all game systems.
     void shutdown();
@@ -53,6 +68,20 @@ private:
     std::string name_;
     entt::registry registry_;
     std::vector<std::shared_ptr<GameSystemInterface>> gameSystems_;
+
+    /// @brief Consecutive systems that can run at the same time
+    struct SystemBatch {
+        std::vector<GameSystemInterface*> systems;
+    };
+
+    std::vector<SystemBatch> systemBatches_;
+    bool systemBatchesDirty_ = true;
+
+    /// @brief Groups the systems by their declared component access
+    void buildSystemBatches();
+
+    /// @brief Runs a system callback over every batch
+    void runSystemBatches(void (GameSystemInterface::*callback)());
 };
 
 }
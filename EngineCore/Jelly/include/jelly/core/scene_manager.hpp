@@ -40,8 +40,17 @@ public:
     /// @brief Performs a fixed update on the active scene.
     void fixedUpdate();
 
+    /// @brief Blends the interpolated transforms of the active scene for rendering.
+    /// @param alpha Fraction of a fixed step elapsed since the last one
+    void interpolateActiveScene(float alpha);
+
+    /// @brief Copies the render data of the active scene for renderActiveScene().
+    /// @param frame Index of the frame, passed again to renderActiveScene()
+    void extractActiveScene(uint64_t frame);
+
     /// @brief Renders the active scene.
-    void renderActiveScene();
+    /// @param frame Index of the extracted frame to draw
+    void renderActiveScene(uint64_t frame);
 
     /// @brief Shuts down the active scene.
     void shutdownActiveScene();
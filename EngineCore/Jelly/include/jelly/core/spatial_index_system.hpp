@@ -0,0 +1,126 @@
+#pragma once
+
+#include "bounds.hpp"
+#include "frustum.hpp"
+#include "transform.hpp"
+#include "dynamic_aabb_tree.hpp"
+#include "transform_system.hpp"
+#include "game_system_interface.hpp"
+
+#include "jelly/jelly_export.hpp"
+
+#include <entt/entt.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace jelly::core {
+
+/// @brief Component that registers an entity in the spatial index.
+///
+/// The entity also needs a Transform. Changes to the local box must go through
+/// registry.patch() or registry.replace() so the index is notified.
+struct SpatialBounds {
+    BoundingBox localBox; ///< Bounds in the entity's local space
+};
+
+/// @brief Closest entity hit by SpatialIndexSystem::raycast()
+struct RaycastHit {
+    entt::entity entity{entt::null};
+    float distance = 0.0f;
+};
+
+/// @brief Keeps a dynamic AABB tree of every entity with SpatialBounds.
+///
+/// Only entities whose world matrix changed (as reported by the TransformSystem)
+/// or whose bounds were added or patched are refit each update, so the cost
+/// follows what moves rather than the scene size. Register it after the
+/// TransformSystem so world matrices are current.
+///
+/// Queries test the tight world box of the candidates returned by the tree and
+/// are safe to call concurrently with each other, but not with update().
+class JELLY_EXPORT SpatialIndexSystem final : public GameSystemInterface {
+public:
+    /// @brief Creates the index and inserts the entities that already have bounds.
+    ///
+    /// @param registry Registry holding the entities
+    /// @param transformSystem System providing the entities moved each frame
+    /// @param margin Distance added around every box so small motions skip tree updates
+    SpatialIndexSystem(entt::registry& registry, const TransformSystem& transformSystem, float margin = 0.1f);
+    ~SpatialIndexSystem() override;
+
+    SpatialIndexSystem(const SpatialIndexSystem&) = delete;
+    SpatialIndexSystem& operator=(const SpatialIndexSystem&) = delete;
+
+    /// @brief Refits the entities that moved or changed bounds.
+    void update() override;
+
+    /// @brief Reads Transform, writes SpatialBounds.
+    ///
+    /// update() only modifies the tree, but queries read it; declaring the
+    /// bounds as written keeps systems that query the index (and so read
+    /// SpatialBounds) from running at the same time.
+    void declareAccess(SystemAccess& access) const override;
+
+    /// @brief Collects the entities at least partially inside a frustum
+    /// @param frustum Frustum to test
+    /// @param outEntities Receives the entities (appended)
+    void queryFrustum(const Frustum& frustum, std::vector<entt::entity>& outEntities) const;
+
+    /// @brief Collects the entities whose world box overlaps a box
+    /// @param box World-space box
+    /// @param outEntities Receives the entities (appended)
+    void queryOverlap(const BoundingBox& box, std::vector<entt::entity>& outEntities) const;
+
+    /// @brief Collects the entities whose world box is within a distance of a point
+    /// @param center World-space point
+    /// @param radius Search distance
+    /// @param outEntities Receives the entities (appended)
+    void queryRadius(const glm::vec3& center, float radius, std::vector<entt::entity>& outEntities) const;
+
+    /// @brief Finds the closest entity whose world box is hit by a ray
+    /// @param ray Ray with a normalized direction
+    /// @param maxDistance Maximum hit distance
+    std::optional<RaycastHit> raycast(const Ray& ray, float maxDistance) const;
+
+    /// @brief Gets the world-space box of an indexed entity
+    /// @return nullptr if the entity is not indexed
+    const BoundingBox* getWorldBox(entt::entity entity) const;
+
+    /// @brief Gets the underlying tree (e.g. for statistics)
+    const DynamicAabbTree& getTree() const { return tree_; }
+
+private:
+    entt::registry& registry_;
+    const TransformSystem& transformSystem_;
+
+    DynamicAabbTree tree_;
+
+    /// @brief Index entry of an entity, indexed by entt::to_entity
+    struct Proxy {
+        int32_t id = DynamicAabbTree::NULL_NODE;
+        BoundingBox worldBox;
+    };
+
+    std::vector<Proxy> proxies_;
+    std::vector<entt::entity> pending_; // Entities whose bounds were added or changed
+
+    /// @brief Returns the tree proxy of an entity, or NULL_NODE
+    int32_t proxyOf(entt::entity entity) const;
+
+    /// @brief Gets the entity stored in a tree proxy
+    static entt::entity entityOf(uint64_t userData);
+
+    /// @brief Recomputes the world box of an entity and inserts or moves its proxy
+    void refresh(entt::entity entity);
+
+    /// @brief Removes the proxy of an entity, if any
+    void remove(entt::entity entity);
+
+    // === Registry hooks ===
+    void onBoundsChanged(entt::registry& registry, entt::entity entity);
+    void onBoundsOrTransformDestroy(entt::registry& registry, entt::entity entity);
+};
+
+} // namespace jelly::core
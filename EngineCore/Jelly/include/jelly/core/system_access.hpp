@@ -0,0 +1,66 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <entt/entt.hpp>
+
+#include <vector>
+
+namespace jelly::core {
+
+/// @brief Components a game system reads and writes during update() and fixedUpdate().
+///
+/// The Scene uses these declarations to run systems that do not conflict
+/// (no shared component where at least one of them writes) at the same time.
+///
+/// Example:
+/// @code
+/// void declareAccess(SystemAccess& access) const override {
+///     access.reads<Rotate>().writes<Transform>();
+/// }
+/// @endcode
+class JELLY_EXPORT SystemAccess {
+public:
+    /// @brief Declares components that are only read
+    template <typename... Components>
+    SystemAccess& reads() {
+        (add<Components>(reads_), ...);
+        return *this;
+    }
+
+    /// @brief Declares components that are modified
+    template <typename... Components>
+    SystemAccess& writes() {
+        (add<Components>(writes_), ...);
+        return *this;
+    }
+
+    /// @brief Returns true if anything was declared
+    ///
+    /// Systems that declare nothing are assumed to touch everything and run alone.
+    bool isDeclared() const { return !reads_.empty() || !writes_.empty(); }
+
+    /// @brief Returns true if both systems touch a component and at least one writes it
+    bool conflictsWith(const SystemAccess& other) const;
+
+    /// @brief Creates the storage of every declared component
+    ///
+    /// EnTT creates storages lazily; doing it up front keeps concurrent systems
+    /// from modifying the registry when they build their views.
+    void prepare(entt::registry& registry) const;
+
+private:
+    using PrepareFunction = void (*)(entt::registry&);
+
+    std::vector<entt::id_type> reads_;
+    std::vector<entt::id_type> writes_;
+    std::vector<PrepareFunction> prepareFunctions_;
+
+    template <typename Component>
+    void add(std::vector<entt::id_type>& ids) {
+        ids.push_back(entt::type_hash<Component>::value());
+        prepareFunctions_.push_back([](entt::registry& registry) { registry.storage<Component>(); });
+    }
+};
+
+} // namespace jelly::core
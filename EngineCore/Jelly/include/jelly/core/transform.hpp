@@ -6,7 +6,62 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <entt/entt.hpp>
+
+#include <array>
+#include <mutex>
+#include <vector>
+
 namespace jelly::core {
+
+/// @brief Entities whose Transform values changed since the last TransformSystem update.
+///
+/// Filled by the Transform setters, possibly from job workers, so the
+/// TransformSystem visits what changed instead of scanning every transform.
+class JELLY_EXPORT TransformChangeQueue {
+public:
+    /// @brief Queues an entity; safe to call from any thread
+    void push(entt::entity entity);
+
+    /// @brief Appends every queued entity to out and empties the queue
+    void drain(std::vector<entt::entity>& out);
+
+private:
+    static constexpr size_t BUCKET_COUNT = 16;
+
+    // Picked by job thread index so workers rarely contend on a lock
+    struct Bucket {
+        std::mutex mutex;
+        std::vector<entt::entity> entities;
+    };
+
+    std::array<Bucket, BUCKET_COUNT> buckets_;
+};
+
+/// @brief Where a Transform reports its changes, set by the TransformSystem.
+///
+/// Follows the component when the registry moves it, but assigning one
+/// Transform to another copies the values only, so a transform never reports
+/// under another entity.
+class TransformChangeLink {
+public:
+    TransformChangeLink() = default;
+    TransformChangeLink(const TransformChangeLink&) = default;
+    TransformChangeLink(TransformChangeLink&&) = default;
+    TransformChangeLink& operator=(const TransformChangeLink&) { return *this; }
+    TransformChangeLink& operator=(TransformChangeLink&&) = default;
+
+    void notify() const {
+        if (queue_) queue_->push(entity_);
+    }
+
+private:
+    friend class TransformSystem;
+
+    TransformChangeQueue* queue_ = nullptr;
+    entt::entity entity_{entt::null};
+};
+
 /// @brief Represents position, rotation, and scale in 3D space.
 /// 
 /// This component stores local transformation data and provides helper methods
@@ -20,34 +75,46 @@ struct JELLY_EXPORT Transform {
     // --- Cached data ---
     glm::mat4 localMatrix{1.0f}; // Local transformation matrix (T * R * S).
     glm::mat4 worldMatrix{1.0f}; // World transformation matrix.
-    bool hasTransformValuesChanged {true}; // Marks if transformation needs to be recalculated.
+    bool hasTransformValuesChanged {true}; // Marks if transformation needs to be recalculated. Set through markChanged().
+    bool hasWorldMatrixChanged {true}; // Set by the TransformSystem when worldMatrix was rewritten this update.
+
+    TransformChangeLink changeLink; // Owned by the TransformSystem.
 
     // --- Setters ---
 
+    /// @brief Flags the local values as changed so the next TransformSystem update rebuilds the matrices.
+    ///
+    /// The setters call it; call it after writing the local fields directly.
+    void markChanged() {
+        if (hasTransformValuesChanged) return; // Already queued
+        hasTransformValuesChanged = true;
+        changeLink.notify();
+    }
+
     /// @brief Sets the local position.
     /// @param p New local position.
-    void setLocalPosition(const glm::vec3& p) { localPosition = p; hasTransformValuesChanged = true; }
+    void setLocalPosition(const glm::vec3& p) { localPosition = p; markChanged(); }
 
     /// @brief Sets the local rotation using Euler angles (in degrees).
     /// @param eulerDeg Euler angles in degrees.
     void setLocalRotationEuler(const glm::vec3& eulerDeg) {
         glm::vec3 radians = glm::radians(eulerDeg);
         localRotation = glm::quat(radians);
-        hasTransformValuesChanged = true;
+        markChanged();
     }
 
     /// @brief Sets the local rotation using a quaternion.
     /// @param newQuaternion Quaternion representing the rotation.
     void setLocalRotationQuat(const glm::quat& newQuaternion) {
         localRotation = newQuaternion; 
-        hasTransformValuesChanged = true; 
+        markChanged();
     }
 
     /// @brief Sets the local scale.
     /// @param newScale New local scale.
     void setLocalScale(const glm::vec3& newScale) {
         localScale = newScale; 
-        hasTransformValuesChanged = true;
+        markChanged();
     }
 
     // --- Matrix operations ---
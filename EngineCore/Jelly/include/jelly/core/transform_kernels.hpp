@@ -0,0 +1,72 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+namespace jelly::core {
+
+/// @brief Instruction set used by the batch transform kernels.
+enum class SimdLevel {
+    Scalar, // Portable C++ fallback.
+    SSE,    // 4 transforms per iteration (SSE2).
+    AVX2    // 8 transforms per iteration (AVX2 + FMA).
+};
+
+/// @brief Structure-of-arrays view over a batch of TRS transforms.
+///
+/// Every pointer addresses count consecutive floats; rotations are unit quaternions.
+struct TransformSoA {
+    const float* positionX = nullptr;
+    const float* positionY = nullptr;
+    const float* positionZ = nullptr;
+    const float* rotationX = nullptr;
+    const float* rotationY = nullptr;
+    const float* rotationZ = nullptr;
+    const float* rotationW = nullptr;
+    const float* scaleX = nullptr;
+    const float* scaleY = nullptr;
+    const float* scaleZ = nullptr;
+};
+
+/// @brief Batch kernels that build local and world matrices.
+///
+/// The best instruction set supported by the CPU is detected on first use and
+/// can be lowered with setSimdLevel() (e.g. to compare implementations).
+/// All kernels produce the same column-major layout as glm::mat4.
+class JELLY_EXPORT TransformKernels {
+public:
+    /// @brief Gets the instruction set currently used by the kernels
+    static SimdLevel getSimdLevel();
+
+    /// @brief Gets the best instruction set supported by this CPU
+    static SimdLevel getSupportedSimdLevel();
+
+    /// @brief Selects the instruction set used by the kernels
+    /// @param level Requested level, clamped to what the CPU supports
+    static void setSimdLevel(SimdLevel level);
+
+    /// @brief Gets a printable name for an instruction set
+    static const char* getSimdLevelName(SimdLevel level);
+
+    /// @brief Builds T * R * S local matrices for a batch of transforms
+    /// @param transforms SoA view of positions, rotations and scales
+    /// @param count Number of transforms
+    /// @param outLocal Receives count matrices
+    static void composeLocalMatrices(const TransformSoA& transforms, size_t count, glm::mat4* outLocal);
+
+    /// @brief Computes out[i] = lhs[i] * rhs[i] for a batch of matrices
+    /// @param lhs Left-hand matrices (e.g. parent world matrices)
+    /// @param rhs Right-hand matrices (e.g. local matrices)
+    /// @param out Receives count matrices; may alias rhs
+    /// @param count Number of matrices
+    static void multiplyMatrices(const glm::mat4* lhs, const glm::mat4* rhs, glm::mat4* out, size_t count);
+
+    /// @brief Computes out = lhs * rhs for a single matrix pair
+    /// @param out May alias rhs
+    static void multiply(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out);
+};
+
+} // namespace jelly::core
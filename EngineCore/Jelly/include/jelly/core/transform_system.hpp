@@ -1,6 +1,7 @@
 #pragma once
 
 #include "transform.hpp"
+#include "transform_kernels.hpp"
 #include "hierarchy.hpp"
 #include "game_system_interface.hpp"
 
@@ -8,31 +9,126 @@
 
 #include <entt/entt.hpp>
 
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 namespace jelly::core {
 
 
 /// @brief System responsible for managing entity transforms and their hierarchy.
 ///
 /// Handles local-to-world space transformations and parent-child relationships.
+///
+/// The hierarchy is mirrored into a flattened, parent-before-child array where
+/// every subtree occupies a contiguous range. The array is kept up to date
+/// incrementally: new transforms are appended as roots and reparenting moves
+/// the child's subtree block next to its new parent. Destroyed transforms
+/// leave a tombstone that the next update compacts away in one pass.
+///
+/// Transforms report their changes through a TransformChangeQueue filled by
+/// the setters, and each update only walks the subtrees below them, so static
+/// scenes cost nearly nothing.
 class JELLY_EXPORT TransformSystem final : public jelly::core::GameSystemInterface {
 public:
     /// @brief Constructs a TransformSystem for the given entity registry.
-    /// 
+    ///
     /// @param registry Reference to the ECS registry that contains transform entities.
     explicit TransformSystem(entt::registry& registry);
+    ~TransformSystem() override;
+
+    TransformSystem(const TransformSystem&) = delete;
+    TransformSystem& operator=(const TransformSystem&) = delete;
 
-    
     /// @brief Updates all transforms in the hierarchy, recalculating world matrices.
     void update() override;
 
+    /// @brief Writes Transform, reads Hierarchy.
+    void declareAccess(SystemAccess& access) const override;
+
+    /// @brief Attaches an entity to a new parent, or makes it a root.
+    ///
+    /// Keeps the Hierarchy components of the child and both parents in sync.
+    /// @param child Entity to move (must have a Transform)
+    /// @param parent New parent entity, or entt::null to make child a root
+    /// @throws jelly::Exception if parent is child itself or one of its descendants
+    void setParent(entt::entity child, entt::entity parent);
+
+    /// @brief Gets the entities whose world matrix changed during the last update()
+    ///
+    /// Lets dependent systems (e.g. the spatial index) process only moved entities.
+    const std::vector<entt::entity>& getChangedEntities() const { return changedLastUpdate_; }
+
 private:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    // Subtrees smaller than this are not worth handing to another thread
+    static constexpr uint32_t MIN_PARALLEL_NODES = 4096;
+
+    /// @brief One entry of the flattened hierarchy
+    struct Node {
+        entt::entity entity{entt::null};
+        entt::entity parent{entt::null};
+        uint32_t subtreeSize = 1; // The node itself plus all of its descendants
+    };
+
+    /// @brief SoA copy of the TRS values of the dirty transforms of a range
+    struct LocalBatch {
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+        std::vector<float> scaleX, scaleY, scaleZ;
+        std::vector<glm::mat4> matrices;
+
+        void clear();
+        void push(const Transform& transform);
+        TransformSoA view() const;
+    };
+
     entt::registry& registry_;
 
-    /// @brief Recursively propagates a parent's world matrix to its children.
+    std::vector<Node> nodes_;              // Parent-before-child order
+    std::vector<uint32_t> nodeIndices_;    // entt::to_entity(entity) -> position in nodes_
+    std::vector<entt::entity> forcedDirty_; // Subtrees needing recomputation after a structural change
+    std::vector<entt::entity> changedLastUpdate_;
+    TransformChangeQueue changeQueue_;
+    uint32_t tombstoneCount_ = 0;          // Nodes of destroyed transforms still in nodes_
+
+    // Per-update scratch
+    std::vector<entt::entity> changedEntities_;
+    std::vector<uint32_t> dirtyRoots_;
+    std::vector<std::pair<uint32_t, uint32_t>> dirtyRanges_;
+    std::vector<uint32_t> compactRoots_;
+    std::vector<uint32_t> compactOffsets_;
+    std::vector<Node> compactNodes_;
+
+    /// @brief Returns the position of an entity in nodes_, or INVALID_INDEX
+    uint32_t indexOf(entt::entity entity) const;
+
+    /// @brief Recomputes the positions stored in nodeIndices_ for nodes_[first, last)
+    void reindex(uint32_t first, uint32_t last);
+
+    /// @brief Moves the subtree of child under parent (or to the roots) in nodes_
+    void moveSubtree(entt::entity child, entt::entity parent);
+
+    /// @brief Removes the tombstones of destroyed transforms from nodes_
     ///
-    /// @param entity The child entity to update.
-    /// @param parentWorld The world matrix of the parent entity.
-    void propagateWorldMatrix(entt::entity entity, const glm::mat4& parentWorld);
+    /// Orphaned subtrees leave the range of their former ancestors and every
+    /// subtree size is recomputed, in a single pass over the array.
+    void compact();
+
+    /// @brief Links a transform to the change queue, queueing it if it is already dirty
+    void link(entt::entity entity, Transform& transform);
+
+    /// @brief Adds the subtree size delta to every ancestor of a node
+    void adjustAncestorSizes(entt::entity parent, int64_t delta);
+
+    /// @brief Recomputes the world matrices of nodes_[first, last) in order
+    void updateRange(uint32_t first, uint32_t last);
+
+    // === Registry hooks ===
+    void onTransformConstruct(entt::registry& registry, entt::entity entity);
+    void onTransformDestroy(entt::registry& registry, entt::entity entity);
+    void onHierarchyChanged(entt::registry& registry, entt::entity entity);
 };
 
-} // namespace jelly::core
\ No newline at end of file
+} // namespace jelly::core
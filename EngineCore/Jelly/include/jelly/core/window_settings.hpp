@@ -1,6 +1,20 @@
 #pragma once
 
+#include <cstdint>
+
 namespace jelly::core {
+
+/// <summary>
+/// How finished frames are handed to the display.
+/// </summary>
+enum class PresentMode {
+    Auto,        ///< Mailbox when available, otherwise FIFO; with vsync off, Immediate instead of Mailbox.
+    Fifo,        ///< Wait for vertical blank; always supported.
+    FifoRelaxed, ///< Like Fifo, but a late frame is shown immediately (may tear).
+    Mailbox,     ///< Vsynced without blocking: the newest frame replaces a queued one.
+    Immediate    ///< No vsync: lowest latency, may tear.
+};
+
 /// <summary>
 /// Struct containing window creation settings.
 /// </summary>
@@ -9,6 +23,17 @@ struct WindowSettings {
     int height;          ///< Height of the window in pixels.
     bool vsync;          ///< Whether VSync should be enabled.
     const char* title;   ///< Title of the window.
+    uint32_t recordingThreads = 0; ///< Threads recording draw commands (0 records on the main thread).
+    uint32_t jobThreads = 0;       ///< Job system worker threads (0 uses one per hardware thread minus the main thread).
+    bool headless = false;         ///< Render offscreen at width x height without creating a window (Vulkan only).
+    bool frameReadback = false;    ///< In headless mode, copy every frame to host memory for Jelly::readFrame().
+    uint32_t framesInFlight = 2;   ///< Frames the CPU may record ahead of the GPU (1 to 3): 3 for throughput, 1 for latency.
+    PresentMode presentMode = PresentMode::Auto; ///< Swapchain present mode; unsupported modes fall back to Fifo.
+    float targetFrameRate = 0.0f;  ///< Frame rate the frame pacer caps to (0 leaves pacing to the present mode).
+    bool lowLatency = false;       ///< Sleep before polling input instead of blocking on the GPU after it.
+    float fixedTickRate = 60.0f;   ///< Fixed simulation steps per second.
+    uint32_t maxFixedSteps = 5;    ///< Fixed steps a frame may catch up before the simulation slows down.
+    bool renderThread = false;     ///< Record and submit frames on a dedicated thread while the next one is simulated.
 };
 
 }
@@ -1,9 +1,52 @@
 #pragma once
 
+#include "jelly/core/window_settings.hpp"
 #include "jelly/windowing/window_system_interface.hpp"
 
+#include <cstdint>
+#include <functional>
+#include <vector>
+
 namespace jelly::graphics {
 
+/// Parameters of one indexed draw, laid out like VkDrawIndexedIndirectCommand.
+struct DrawIndexedCommand {
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t firstInstance;
+};
+
+/// One draw of the GPU culling pass: a mesh of the shared geometry arena and its local bounds.
+struct CulledDrawDesc {
+    uint32_t indexCount = 0;
+    uint32_t firstIndex = 0;
+    int32_t vertexOffset = 0;
+    float boundsCenter[3] = {};   // Local-space bounding box center
+    float boundsExtents[3] = {};  // Local-space bounding box half size
+};
+
+/// Outputs of a GPU culling pass copied back to the CPU.
+struct GpuCullingResults {
+    std::vector<std::vector<DrawIndexedCommand>> buckets; // Compacted commands of each bucket, in bucket order
+    std::vector<float> instances;                         // Instance stream the commands' firstInstance index (16 floats each)
+};
+
+/// GPU time of a named scope of a frame.
+struct GpuScopeTiming {
+    const char* name = nullptr;
+    double startMs = 0.0;      // Since the first timestamp of the frame
+    double durationMs = 0.0;
+};
+
+/// GPU timings of a completed frame.
+struct GpuFrameStats {
+    uint64_t frameNumber = 0;  // Frame the timings belong to, counting from 0
+    double frameMs = 0.0;      // First to last timestamp of the frame
+    std::vector<GpuScopeTiming> scopes;
+};
+
 class GraphicAPIInterface {
 public:
     virtual ~GraphicAPIInterface() = default;
@@ -20,6 +63,90 @@ public:
     /// Ends rendering of the current frame.
     virtual void endFrame() = 0;
 
+    /// Copies per-instance world matrices (16 floats each, column-major) into the
+    /// current frame's instance stream.
+    /// Returns the index of the first written instance, to be used as firstInstance.
+    virtual uint32_t writeInstanceData(const float* worldMatrices, uint32_t count) { return 0; }
+
+    /// Renders into offscreen images of the given size instead of a window surface.
+    /// Must be called before initialize(). With readback enabled every frame is
+    /// copied to host memory for readFramePixels().
+    /// Returns false if the backend cannot render without a window.
+    virtual bool setOffscreenTarget(uint32_t width, uint32_t height, bool readback) { return false; }
+
+    /// Copies the last completed offscreen frame as tightly packed 8-bit RGBA rows, top row first.
+    /// Blocks until that frame has finished on the GPU.
+    /// Returns false if no frame was read back (windowed mode, readback disabled, nothing rendered yet).
+    virtual bool readFramePixels(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) { return false; }
+
+    /// Sets how many frames the CPU may record ahead of the GPU. Must be called before
+    /// initialize(). More frames raise throughput, fewer lower input latency.
+    virtual void setFramesInFlight(uint32_t count) {}
+
+    /// Selects how finished frames are presented. Must be called before initialize().
+    virtual void setPresentMode(core::PresentMode mode) {}
+
+    /// Sets how many worker threads record draw commands (0 records on the calling thread).
+    virtual void setRecordingThreadCount(uint32_t count) {}
+
+    /// Records itemCount draws, possibly split across the recording threads.
+    /// record(begin, end) is called for consecutive ranges covering [0, itemCount).
+    /// Ranges may run concurrently, so the callback must only record commands.
+    virtual void recordDraws(uint32_t itemCount, const std::function<void(uint32_t begin, uint32_t end)>& record) {
+        record(0, itemCount);
+    }
+
+    /// Binds the vertex and index buffers of the shared geometry arena.
+    /// Returns false if the backend has no arena.
+    virtual bool bindSharedGeometry() { return false; }
+
+    /// Issues draws against the bound shared geometry using as few indirect draw
+    /// calls as the device allows. Safe to call from recordDraws() ranges.
+    /// Returns the number of draw calls recorded.
+    virtual uint32_t drawIndexedIndirect(const DrawIndexedCommand* commands, uint32_t commandCount) { return 0; }
+
+    /// Returns true if frustum culling and draw generation can run on the GPU.
+    virtual bool supportsGpuCulling() const { return false; }
+
+    /// Starts this frame's GPU culling input.
+    /// frustumPlanes holds six normalized inward-facing planes (24 floats, as core::Frustum).
+    virtual void beginGpuCulling(const float* frustumPlanes) {}
+
+    /// Opens a bucket: every draw added to it is drawn by one drawCulledBucket() call,
+    /// so all of them must use the same material.
+    virtual uint32_t addCulledBucket() { return 0; }
+
+    /// Adds a draw to a bucket with its candidate instances (16 floats each, column-major).
+    virtual void addCulledDraw(uint32_t bucket, const CulledDrawDesc& draw, const float* worldMatrices, uint32_t instanceCount) {}
+
+    /// Records the culling pass for the draws added since beginGpuCulling().
+    /// Must be called once all draws are added and before any drawCulledBucket().
+    virtual void dispatchGpuCulling() {}
+
+    /// Draws the visible instances of a bucket against the bound shared geometry.
+    /// Safe to call from recordDraws() ranges. Returns the number of draw calls recorded.
+    virtual uint32_t drawCulledBucket(uint32_t bucket) { return 0; }
+
+    /// Keeps the outputs of the GPU culling pass readable by the CPU, for tests.
+    /// The outputs move to host-visible memory, which is slower to draw from.
+    virtual void setGpuCullingReadback(bool enabled) {}
+
+    /// Copies the outputs of the latest culling pass, waiting for the GPU to finish it.
+    /// Returns false unless readback is enabled and a pass has been submitted.
+    virtual bool readGpuCullingResults(GpuCullingResults& results) { return false; }
+
+    /// Opens a GPU timing scope in the current frame's commands. The name must outlive
+    /// the frame (a string literal). Returns the id to pass to endGpuScope().
+    virtual uint32_t beginGpuScope(const char* name) { return 0; }
+
+    /// Closes a scope opened by beginGpuScope() in the same frame.
+    virtual void endGpuScope(uint32_t scope) {}
+
+    /// Copies the GPU timings of the latest frame whose results have been read back,
+    /// a few frames behind the one being recorded.
+    /// Returns false if GPU timing is unsupported or no frame has been resolved yet.
+    virtual bool getGpuFrameStats(GpuFrameStats& stats) const { return false; }
+
     /// Releases all resources and shuts down the API.
     virtual void shutdown() = 0;
 };
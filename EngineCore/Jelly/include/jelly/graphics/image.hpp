@@ -19,6 +19,13 @@ public:
     /// @throws std::runtime_error se o arquivo não puder ser lido ou tiver formato inválido.
     explicit Image(const std::string& path);
 
+    /// @brief Cria uma imagem a partir de pixels RGBA já carregados.
+    /// @param width Largura em pixels
+    /// @param height Altura em pixels
+    /// @param pixels Dados RGBA, width * height * 4 bytes
+    /// @throws std::runtime_error se as dimensões não corresponderem aos dados.
+    Image(uint32_t width, uint32_t height, std::vector<uint8_t> pixels);
+
     uint32_t getWidth() const { return width_; }
     uint32_t getHeight() const { return height_; }
     const std::vector<uint8_t>& getPixels() const { return pixels_; }
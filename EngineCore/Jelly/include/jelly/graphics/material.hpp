@@ -5,6 +5,7 @@
 
 #include "jelly/jelly_export.hpp"
 
+#include <cstdint>
 #include <memory>
 
 namespace jelly::graphics {
@@ -21,11 +22,33 @@ public:
     /// @brief Constructs a material with the given shader.
     /// @param shader The shader program this material will use.
     explicit MaterialInterface(std::shared_ptr<ShaderInterface> shader)
-        : shader_(std::move(shader)) {}
+        : shader_(std::move(shader)), id_(nextId()) {}
+
+    virtual ~MaterialInterface() = default;
 
     /// @brief Binds the material for rendering (activates shader and resources).
     virtual void bind() = 0;
 
+    /// @brief Binds only the pipeline state of the material.
+    virtual void bindPipeline() = 0;
+
+    /// @brief Binds the material's resources (descriptor sets) for one draw.
+    /// @param uniformOffset Offset returned by ShaderInterface::commitUniforms()
+    virtual void bindResources(uint32_t uniformOffset) = 0;
+
+    /// @brief Gets the identifier used to build render sort keys.
+    uint32_t getId() const { return id_; }
+
+    /// @brief Gets the identifier of the pipeline state this material binds.
+    ///
+    /// Materials returning the same value can be drawn without a pipeline rebind.
+    virtual uint32_t getPipelineId() const { return id_; }
+
+    /// @brief Returns false while the material's pipeline is still being compiled.
+    ///
+    /// Renderers skip materials that are not ready instead of blocking on them.
+    virtual bool isReady() const { return true; }
+
     /// @brief Sets the albedo (base color) texture
     /// @param texture The texture to use as albedo map
     virtual void setAlbedoTexture(std::shared_ptr<TextureInterface> texture) = 0;
@@ -53,6 +76,9 @@ public:
 
 private:
     std::shared_ptr<ShaderInterface> shader_;
+    uint32_t id_;
+
+    static uint32_t nextId();
 };
 
 /// @brief Handle type for material resources.
@@ -28,10 +28,29 @@ public:
     /// @throws std::runtime_error if the graphics API reported by the `GraphicContext` is not supported.
     static MaterialHandle create(std::shared_ptr<ShaderInterface> shader);
 
+    /// @brief Creates a material whose pipeline compiles on a background job.
+    ///
+    /// Returns immediately; MaterialInterface::isReady() stays false until the
+    /// pipeline is compiled and renderers skip the material until then.
+    /// Materials sharing a pipeline with an existing one are ready at once.
+    ///
+    /// @param shader A shared pointer to the shader program that the material will use.
+    /// @return A `MaterialHandle` to the newly created, API-specific material.
+    /// @throws std::runtime_error if the graphics API reported by the `GraphicContext` is not supported.
+    static MaterialHandle createAsync(std::shared_ptr<ShaderInterface> shader);
+
+    /// @brief Re-acquires the pipeline of every live material.
+    ///
+    /// Called by the graphics API after its render pass had to be rebuilt.
+    static void recreatePipelines();
+
     /// @brief Releases all cached materials (call before device destruction)
     static void releaseAll();
 
 private:
+    /// @brief Creates the API-specific material, compiling its pipeline inline or on a job
+    static MaterialHandle createMaterial(std::shared_ptr<ShaderInterface> shader, bool async);
+
     /// @brief Registers a material instance in the factory's tracking system
     /// @param material The material handle to be registered and tracked
     static void registerMaterial(const MaterialHandle& material);
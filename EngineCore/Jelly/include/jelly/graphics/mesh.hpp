@@ -1,8 +1,13 @@
 #pragma once
 
+#include "jelly/jelly_export.hpp"
+#include "jelly/core/bounds.hpp"
+
 #include <glm/glm.hpp>
 
+#include <cstdint>
 #include <vector>
+#include <memory_resource>
 #include <memory>
 
 namespace jelly::graphics {
@@ -12,19 +17,63 @@ struct Vertex {
     glm::vec2 uv;
 };
 
+/// @brief How often a mesh's data is expected to change after the first upload.
+enum class MeshUsage {
+    Static,  ///< Uploaded once into device-local memory through a staging buffer
+    Dynamic, ///< Kept in host-visible memory so frequent re-uploads are cheap
+    Shared   ///< Sub-allocated from the backend's shared geometry arena (Static if it is full)
+};
+
+/// @brief Where a mesh lives inside the shared geometry arena.
+struct MeshGeometryRange {
+    uint32_t indexCount = 0;    // Number of indices of the mesh.
+    uint32_t firstIndex = 0;    // First index of the mesh in the shared index buffer.
+    int32_t vertexOffset = 0;   // Added to every index to reach the mesh's vertices.
+};
+
 /// @brief An interface for a renderable geometric mesh.
 ///
 /// Defines the abstract base class for a mesh, which consists of vertex and
 /// index data. Concrete implementations (e.g., for Vulkan or OpenGL) will
 /// handle the GPU-specific buffer management and draw calls.
-class Mesh {
+class JELLY_EXPORT Mesh {
 public:
+    /// @brief Assigns the mesh a process-unique identifier.
+    Mesh() : id_(nextId()) {}
+
     /// @brief Default virtual destructor to allow for proper cleanup of derived classes.
     virtual ~Mesh() = default;
 
+    /// @brief Gets the identifier used to build render sort keys.
+    uint32_t getId() const { return id_; }
+
     /// @brief Uploads vertex and index data to the GPU.
+    ///
+    /// Implementations also refresh the local bounds from the current positions.
     virtual void upload() = 0;
 
+    /// @brief Gets the local-space bounding box computed by the last upload()
+    const core::BoundingBox& getBoundingBox() const { return boundingBox_; }
+
+    /// @brief Gets the local-space bounding sphere computed by the last upload()
+    const core::BoundingSphere& getBoundingSphere() const { return boundingSphere_; }
+
+    /// @brief Gets the memory usage the next upload() will target
+    MeshUsage getUsage() const { return usage_; }
+
+    /// @brief Sets the memory usage the next upload() will target
+    /// @param usage Static (default) or Dynamic
+    void setUsage(MeshUsage usage) { usage_ = usage; }
+
+    /// @brief Returns true if the last upload() placed the mesh in the shared geometry arena
+    ///
+    /// Such meshes all bind the same buffers, so consecutive draws can be merged
+    /// into one indirect draw (see GraphicAPIInterface::drawIndexedIndirect()).
+    bool usesSharedGeometry() const { return sharedGeometry_; }
+
+    /// @brief Gets the range of the mesh inside the shared geometry arena
+    const MeshGeometryRange& getGeometryRange() const { return geometryRange_; }
+
     /// @brief Sets the vertex positions for the mesh
     /// @param position Vector of 3D position coordinates
     void setPositions(const std::vector<glm::vec3>& position) { positions_ = position; }
@@ -37,10 +86,28 @@ public:
     /// @param indices Vector of vertex indices defining triangles
     void setIndices(const std::vector<uint32_t>& indices) { indices_ = indices; }
 
+    /// @brief Binds the mesh's vertex and index buffers.
+    virtual void bind() const = 0;
+
+    /// @brief Issues an indexed draw using the currently bound buffers.
+    ///
+    /// Per-instance data must already be written to the frame's instance stream.
+    /// @param instanceCount Number of instances to draw
+    /// @param firstInstance Index of the first instance in the instance stream
+    virtual void drawIndexed(uint32_t instanceCount, uint32_t firstInstance) const = 0;
+
     /// @brief Binds the mesh's buffers and issues a draw command.
     ///
     /// This function is called during the rendering loop to draw the mesh.
-    virtual void draw() const = 0;
+    void draw() const { drawInstanced(1, 0); }
+
+    /// @brief Binds the mesh's buffers and issues an instanced draw command.
+    /// @param instanceCount Number of instances to draw
+    /// @param firstInstance Index of the first instance in the instance stream
+    void drawInstanced(uint32_t instanceCount, uint32_t firstInstance) const {
+        bind();
+        drawIndexed(instanceCount, firstInstance);
+    }
 
     /// @brief Releases all GPU resources associated with this shader
     /// @note Must be called before destruction if the shader needs explicit cleanup
@@ -55,9 +122,24 @@ protected:
     std::vector<glm::vec2> uv1_;
     std::vector<uint32_t> indices_;
 
+    MeshUsage usage_ = MeshUsage::Static;
+    bool sharedGeometry_ = false;
+    MeshGeometryRange geometryRange_;
+
     /// @brief Builds an interleaved vertex buffer from separate attribute arrays
+    /// @param memory Resource the vertices are allocated from, e.g. a FrameAllocator for a one-off upload
     /// @return Vector of interleaved Vertex structures ready for GPU upload
-    std::vector<Vertex> buildVertexBuffer() const;
+    std::pmr::vector<Vertex> buildVertexBuffer(std::pmr::memory_resource* memory = std::pmr::get_default_resource()) const;
+
+    /// @brief Recomputes the bounding box and sphere from the vertex positions
+    void computeBounds();
+
+private:
+    uint32_t id_;
+    core::BoundingBox boundingBox_;
+    core::BoundingSphere boundingSphere_;
+
+    static uint32_t nextId();
 };
 
 /// @brief A shared pointer to a Mesh object, used for managing its lifecycle.
@@ -28,15 +28,17 @@ public:
     ///
     /// The created mesh is initially empty. Vertex and index data must be
     /// uploaded to it using the `Mesh::upload()` method before it can be drawn.
+    /// @param usage Memory usage of the mesh; use Dynamic for meshes re-uploaded often
+    ///              and Shared for meshes that should be drawn from the geometry arena
     /// @return A `MeshHandle` to the newly created, API-specific mesh.
     /// @throws std::runtime_error if the graphics API from the context is unsupported.
-    static MeshHandle createMeshHandle();
+    static MeshHandle createMeshHandle(MeshUsage usage = MeshUsage::Static);
 
-    /// @brief Creates a quad mesh (two triangles forming a rectangle)
+    /// @brief Creates a quad mesh (two triangles forming a rectangle) in the geometry arena
     /// @return A MeshHandle to a quad mesh with predefined vertex data
     static MeshHandle quad();
 
-    /// @brief Creates a cube mesh
+    /// @brief Creates a cube mesh in the geometry arena
     /// @return A MeshHandle to a cube mesh with predefined vertex data
     static MeshHandle cube();
 
@@ -2,13 +2,25 @@
 
 #include "mesh.hpp"
 #include "material.hpp"
+#include "render_queue.hpp"
 
 #include "jelly/jelly_export.hpp"
 #include "jelly/core/camera.hpp"
+#include "jelly/core/frustum.hpp"
+#include "jelly/core/pool_allocator.hpp"
+#include "jelly/core/spatial_index_system.hpp"
 #include "jelly/core/transform.hpp"
 #include "jelly/core/game_system_interface.hpp"
 
 #include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
 
 namespace jelly::graphics {
 
@@ -22,16 +34,191 @@ struct MaterialComponent {
     std::shared_ptr<MaterialInterface> material;
 };
 
+/// @brief Frustum culling counters of one frame
+struct CullingStats {
+    uint32_t testedCount = 0;  ///< Renderable entities tested against the camera frustum
+    uint32_t visibleCount = 0; ///< Entities at least partially inside the frustum
+    uint32_t culledCount = 0;  ///< Entities skipped before reaching the render queue
+    uint32_t gpuCount = 0;     ///< Entities handed to the GPU culling pass, not counted above
+    uint32_t pendingCount = 0; ///< Visible entities skipped because their material is still compiling
+    uint32_t indexedCount = 0; ///< Visible entities found by the spatial index query, not counted above
+};
+
 /// @brief Renders entities with mesh and material components
 class JELLY_EXPORT MeshRendererSystem : public core::GameSystemInterface {
 public:
     explicit MeshRendererSystem(entt::registry& registry);
 
-    /// @brief Renders all visible entities that have a mesh and material.
-    void render() override;
+    /// @brief Copies the camera and the world matrices of every renderable entity into a snapshot.
+    ///
+    /// Entities are grouped by (mesh, material) while copying. With a spatial
+    /// index, the indexed entities are culled here by a frustum query of the
+    /// tree and only the visible ones are copied. The snapshot keeps
+    /// its meshes and materials alive, so render() never touches the registry and
+    /// may run on the render thread while the next frame is simulated. Snapshots
+    /// are double-buffered: one is filled while the previous one is rendered.
+    void extractRenderData(uint64_t frame) override;
+
+    /// @brief Renders all visible entities of the snapshot extracted for a frame.
+    ///
+    /// Does nothing if the system did not extract that frame, e.g. when it was
+    /// added to the scene in between.
+    ///
+    /// The world-space bounds of every entity are first tested against the
+    /// frustum of the active camera; only visible entities are queued.
+    /// Entities are grouped by (mesh, material). Groups whose shader reads a
+    /// per-instance world matrix are drawn with a single instanced draw, the
+    /// others fall back to one draw per entity. All draws go through a sorted
+    /// RenderQueue so redundant state binds are skipped.
+    ///
+    /// With GPU culling enabled and supported by the backend, instanced groups
+    /// whose mesh lives in the shared geometry arena skip the CPU test: their
+    /// matrices go to the culling pass and each material is drawn with one
+    /// indirect-count draw. Everything else is culled on the CPU as before.
+    ///
+    /// Entities whose material is not ready yet (pipeline still compiling) are
+    /// skipped until it is.
+    void render(uint64_t frame) override;
+
+    /// @brief Enables or disables GPU culling (enabled by default, used only if supported).
+    void setGpuCulling(bool enabled) { gpuCulling_ = enabled; }
+
+    /// @brief Returns true if GPU culling is enabled.
+    bool isGpuCulling() const { return gpuCulling_; }
+
+    /// @brief Culls the entities of a spatial index with its tree instead of testing each of them.
+    ///
+    /// Indexed entities are tested with their SpatialBounds box, the others
+    /// keep the per-entity test against their mesh bounds. Extraction only
+    /// visits the query results and the entities without SpatialBounds, so its
+    /// cost follows what is visible. The index must be
+    /// updated before extractRenderData() and outlive this system. Set it
+    /// before the system is added to a scene, which reads declareAccess() then.
+    /// @param index Spatial index of the same registry, or nullptr to test every entity
+    void setSpatialIndex(const core::SpatialIndexSystem* index) { spatialIndex_ = index; }
+
+    /// @brief Only reads components; nothing is touched outside extractRenderData().
+    void declareAccess(core::SystemAccess& access) const override;
+
+    /// @brief Gets the bind/draw counters of the last rendered frame.
+    const RenderQueueStats& getQueueStats() const { return renderQueue_.getStats(); }
+
+    /// @brief Gets the culling counters of the last rendered frame.
+    const CullingStats& getCullingStats() const { return cullingStats_; }
 
 private:
+    struct BatchKey {
+        const Mesh* mesh;
+        const MaterialInterface* material;
+        bool preculled;
+
+        bool operator==(const BatchKey& other) const {
+            return mesh == other.mesh && material == other.material && preculled == other.preculled;
+        }
+    };
+
+    struct BatchKeyHash {
+        size_t operator()(const BatchKey& key) const {
+            size_t h = std::hash<const void*>{}(key.mesh);
+            h ^= std::hash<const void*>{}(key.material) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h ^ static_cast<size_t>(key.preculled);
+        }
+    };
+
+    // Block size of the node pools behind the per-frame hash maps; fits a node of each of them
+    static constexpr size_t LOOKUP_NODE_SIZE = 64;
+
+    static constexpr uint64_t NO_FRAME = ~uint64_t(0);
+
+    /// @brief Draw data of one frame, owned by the snapshot so it outlives the entities
+    struct RenderSnapshot {
+        struct Batch {
+            MeshHandle mesh;
+            std::shared_ptr<MaterialInterface> material;
+            std::vector<glm::mat4> worldMatrices; // Every entity of the batch, unculled unless preculled
+            bool preculled = false;               // Already culled by the spatial index query
+        };
+
+        uint64_t frame = NO_FRAME; // Frame the snapshot was extracted for
+        bool hasCamera = false;
+        uint32_t indexedCount = 0; // Entities of the preculled batches
+        glm::mat4 viewMatrix{1.0f};
+        glm::mat4 projectionMatrix{1.0f};
+
+        // Reused across frames so matrix storage keeps its capacity
+        std::vector<Batch> batches;
+        size_t batchCount = 0;
+        core::PoolAllocator batchNodes{ LOOKUP_NODE_SIZE };
+        std::pmr::unordered_map<BatchKey, size_t, BatchKeyHash> batchLookup{ &batchNodes };
+
+        void clear();
+        Batch& acquireBatch(const MeshHandle& mesh, const std::shared_ptr<MaterialInterface>& material, bool preculled);
+    };
+
+    /// @brief Visible instances of a snapshot batch, collected for one frame
+    struct DrawBatch {
+        Mesh* mesh = nullptr;
+        MaterialInterface* material = nullptr;
+        std::vector<glm::mat4> visibleMatrices;               // Filled by CPU culling
+        const std::vector<glm::mat4>* worldMatrices = nullptr; // visibleMatrices, or the snapshot's when GPU culled
+        bool gpuCulled = false; // Matrices go unculled to the GPU culling pass
+    };
+
+    /// @brief Renderable entity gathered for culling
+    struct CullCandidate {
+        uint32_t batch = 0;
+        const glm::mat4* worldMatrix = nullptr;
+    };
+
+    /// @brief SoA world-space boxes of the candidates, as expected by Frustum::testBoxes
+    struct CandidateBounds {
+        std::vector<float> centerX, centerY, centerZ;
+        std::vector<float> extentX, extentY, extentZ;
+
+        void resize(size_t count);
+        core::BoxSoA view(size_t offset) const;
+    };
+
+    // Entities per culling job
+    static constexpr uint32_t CULLING_GRAIN = 1024;
+
+    /// @brief Tests every entity of the snapshot against the frustum and keeps the visible ones in batches_
+    ///
+    /// Entities of GPU-culled and preculled batches are kept without being tested.
+    void collectBatches(const core::Frustum& frustum, const RenderSnapshot& snapshot);
+
+    /// @brief Commits uniforms and records the draws of every batch into renderQueue_
+    void buildQueue(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix);
+
     entt::registry& registry_;
+    const core::SpatialIndexSystem* spatialIndex_ = nullptr;
+    std::vector<entt::entity> indexedEntities_; // Result of the spatial index query, reused across frames
+
+    static constexpr size_t SNAPSHOT_COUNT = 2;
+    std::array<RenderSnapshot, SNAPSHOT_COUNT> snapshots_; // Frame N is extracted into N % SNAPSHOT_COUNT
+
+    // One per snapshot batch; reused across frames so matrix storage keeps its capacity
+    std::vector<DrawBatch> batches_;
+    size_t batchCount_ = 0;
+
+    std::vector<CullCandidate> candidates_;
+    CandidateBounds candidateBounds_;
+    std::vector<uint8_t> visibility_;
+    CullingStats cullingStats_;
+
+    RenderQueue renderQueue_;
+
+    bool gpuCulling_ = true;
+    bool gpuCullingActive_ = false; // GPU culling is enabled and supported this frame
+
+    // Nodes of the maps below, recycled when they are cleared every frame
+    core::PoolAllocator lookupNodes_{ LOOKUP_NODE_SIZE };
+
+    // GPU culling bucket of each material this frame
+    std::pmr::unordered_map<MaterialInterface*, uint32_t> cullBuckets_{ &lookupNodes_ };
+
+    // Uniform block shared by every instanced draw of a shader this frame
+    std::pmr::unordered_map<ShaderInterface*, uint32_t> instancedUniformOffsets_{ &lookupNodes_ };
 };
 
 } // namespace jelly::graphics
\ No newline at end of file
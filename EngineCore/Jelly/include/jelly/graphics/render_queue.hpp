@@ -0,0 +1,113 @@
+#pragma once
+
+#include "mesh.hpp"
+#include "material.hpp"
+
+#include "jelly/jelly_export.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace jelly::graphics {
+
+/// @brief A single draw recorded into the render queue.
+struct RenderItem {
+    static constexpr uint32_t NO_CULL_BUCKET = UINT32_MAX;
+
+    Mesh* mesh = nullptr;                   // Geometry to draw.
+    MaterialInterface* material = nullptr;  // Pipeline and resources to draw with.
+    uint32_t uniformOffset = 0;             // Offset returned by ShaderInterface::commitUniforms().
+    uint32_t instanceCount = 1;             // Number of instances to draw.
+    uint32_t firstInstance = 0;             // First instance in the frame's instance stream.
+    uint32_t cullBucket = NO_CULL_BUCKET;   // GPU culling bucket drawn instead of mesh (which must be shared).
+};
+
+/// @brief Per-frame submission counters of a RenderQueue.
+struct RenderQueueStats {
+    uint32_t drawCount = 0;                 // Draw commands issued.
+    uint32_t pipelineBinds = 0;             // Pipeline binds issued.
+    uint32_t resourceBinds = 0;             // Descriptor set binds issued.
+    uint32_t meshBinds = 0;                 // Vertex/index buffer binds issued.
+    uint32_t skippedPipelineBinds = 0;      // Pipeline binds elided because the state was already bound.
+    uint32_t skippedResourceBinds = 0;      // Descriptor set binds elided.
+    uint32_t skippedMeshBinds = 0;          // Vertex/index buffer binds elided.
+    uint32_t mergedDraws = 0;               // Items drawn through indirect draws instead of their own draw.
+
+    /// @brief Total number of state binds eliminated this frame
+    uint32_t getSkippedBinds() const {
+        return skippedPipelineBinds + skippedResourceBinds + skippedMeshBinds;
+    }
+
+    RenderQueueStats& operator+=(const RenderQueueStats& other) {
+        drawCount += other.drawCount;
+        pipelineBinds += other.pipelineBinds;
+        resourceBinds += other.resourceBinds;
+        meshBinds += other.meshBinds;
+        skippedPipelineBinds += other.skippedPipelineBinds;
+        skippedResourceBinds += other.skippedResourceBinds;
+        skippedMeshBinds += other.skippedMeshBinds;
+        mergedDraws += other.mergedDraws;
+        return *this;
+    }
+};
+
+/// @brief Sorts draws by state and submits them with redundant binds removed.
+///
+/// Each item gets a 64-bit key laid out (from most to least significant) as
+/// pipeline (16 bits) | material (16 bits) | mesh (16 bits) | depth (16 bits),
+/// so a radix sort groups draws by the most expensive state change first and
+/// orders them front-to-back inside each group. Submission compares the actual
+/// objects, so truncated ids only ever cost sort quality, never correctness.
+///
+/// Consecutive items sharing a material and uniform offset whose meshes live in
+/// the shared geometry arena are drawn with a single indirect draw. Items with a
+/// cull bucket draw the output of the GPU culling pass instead.
+///
+/// Submission may be split into ranges recorded on several threads; each range
+/// starts from unknown state, so the first draw of a range always binds.
+class JELLY_EXPORT RenderQueue {
+public:
+    /// @brief Removes all items recorded for the previous frame.
+    void clear();
+
+    /// @brief Records a draw.
+    /// @param item Draw to record
+    /// @param viewDepth Distance from the camera along the view direction
+    void push(const RenderItem& item, float viewDepth);
+
+    /// @brief Radix-sorts the recorded items by their sort keys.
+    void sort();
+
+    /// @brief Binds state and issues draws in sorted order, skipping redundant binds.
+    ///
+    /// Recording goes through GraphicAPIInterface::recordDraws(), which may spread
+    /// the sorted items over several recording threads.
+    void submit();
+
+    /// @brief Gets the counters of the last submission.
+    const RenderQueueStats& getStats() const { return stats_; }
+
+    /// @brief Gets the number of recorded items.
+    size_t size() const { return items_.size(); }
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    std::vector<RenderItem> items_;
+    std::vector<SortEntry> entries_;
+    std::vector<SortEntry> scratch_;
+    RenderQueueStats stats_;
+    std::mutex statsMutex_;
+
+    /// @brief Builds the sort key of an item
+    static uint64_t buildKey(const RenderItem& item, float viewDepth);
+
+    /// @brief Records the sorted items [begin, end) starting from unknown bind state
+    void submitRange(uint32_t begin, uint32_t end, RenderQueueStats& stats) const;
+};
+
+} // namespace jelly::graphics
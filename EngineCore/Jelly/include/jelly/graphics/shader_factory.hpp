@@ -30,6 +30,19 @@ public:
     /// @return A shared pointer to a ShaderInterface implementation.
     static std::shared_ptr<ShaderInterface> createFromFiles(const std::string& vertexPath);
 
+    /// @brief Reads the compiled binary of a single shader stage.
+    ///
+    /// Used for stages that are not part of a material, such as compute passes.
+    ///
+    /// @param shaderName Base name or logical name of the shader.
+    /// @param stage Shader stage (e.g., "compute").
+    /// @param backend Backend name (e.g., "vulkan").
+    /// @return Contents of the stage binary.
+    static std::vector<uint8_t> readStageBinary(
+        const std::string& shaderName,
+        const std::string& stage,
+        const std::string& backend);
+
     /// @brief Releases all cached shader resources
     static void releaseAll();
 
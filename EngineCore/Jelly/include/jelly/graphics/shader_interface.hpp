@@ -2,6 +2,8 @@
 
 #include "jelly/jelly_export.hpp"
 
+#include <cstdint>
+
 namespace jelly::graphics {
 
 /// @brief Abstract base class for GPU shader programs. Implemented per backend (OpenGL, Vulkan, etc.).
@@ -28,6 +30,14 @@ public:
     /// @param name Uniform variable name in shader
     /// @param matrix Pointer to 16 consecutive float values (column-major)
     virtual void setUniformMat4(const char* name, const float* matrix) {}
+
+    /// @brief Whether the vertex stage reads a per-instance world matrix
+    /// @return True if instanced draws can be used with this shader
+    virtual bool supportsInstancing() const { return false; }
+
+    /// @brief Publishes the currently staged uniform values for one draw
+    /// @return Backend-specific offset identifying the published uniform block
+    virtual uint32_t commitUniforms() { return 0; }
 };
 
 } // namespace jelly::graphics
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace jelly::graphics::vulkan {
+
+/// @brief Placement strategy of a memory block
+enum class MemoryStrategy {
+    Tlsf,  ///< Two-level segregated fit: O(1) allocate and free with neighbour coalescing
+    Linear ///< Bump allocation; the block is rewound once every allocation is freed
+};
+
+/// @brief Offset bookkeeping of one device memory block.
+///
+/// Only tracks ranges inside [0, size); it never touches Vulkan so the same
+/// code manages every memory type.
+class JELLY_EXPORT MemoryBlockMetadata {
+public:
+    /// @brief Returned by allocate() when the block has no room
+    static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+    /// @param size Size of the block in bytes
+    /// @param strategy Placement strategy
+    MemoryBlockMetadata(uint64_t size, MemoryStrategy strategy);
+
+    /// @brief Reserves an aligned range
+    /// @param size Number of bytes
+    /// @param alignment Power-of-two alignment of the returned offset
+    /// @param outOffset Receives the offset of the range
+    /// @return Node to pass to free(), or INVALID_NODE if the block is full
+    uint32_t allocate(uint64_t size, uint64_t alignment, uint64_t& outOffset);
+
+    /// @brief Releases a range returned by allocate()
+    /// @param node Node returned by allocate()
+    /// @param size Size passed to allocate()
+    void free(uint32_t node, uint64_t size);
+
+    /// @brief Gets the size of the block
+    uint64_t getSize() const { return size_; }
+
+    /// @brief Gets the number of bytes handed out, excluding alignment padding
+    uint64_t getAllocatedBytes() const { return allocatedBytes_; }
+
+    /// @brief Gets the number of live allocations
+    uint32_t getAllocationCount() const { return allocationCount_; }
+
+    /// @brief Returns true if the block holds no allocation
+    bool isEmpty() const { return allocationCount_ == 0; }
+
+    /// @brief Gets the number of bytes that can still be allocated
+    uint64_t getFreeBytes() const;
+
+    /// @brief Gets the size of the largest contiguous free range
+    uint64_t getLargestFreeRange() const;
+
+    MemoryStrategy getStrategy() const { return strategy_; }
+
+private:
+    // Sizes below SMALL_SIZE share the first level, split in steps of SMALL_SIZE / SECOND_LEVEL_COUNT
+    static constexpr uint32_t SECOND_LEVEL_LOG2 = 4;
+    static constexpr uint32_t SECOND_LEVEL_COUNT = 1u << SECOND_LEVEL_LOG2;
+    static constexpr uint32_t SMALL_SIZE_LOG2 = 8;
+    static constexpr uint64_t SMALL_SIZE = 1ull << SMALL_SIZE_LOG2;
+    static constexpr uint32_t FIRST_LEVEL_COUNT = 64 - SMALL_SIZE_LOG2 + 1;
+
+    static constexpr uint32_t NULL_INDEX = UINT32_MAX;
+
+    /// @brief Range of the block, linked to its neighbours in address order
+    struct Node {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t prevPhysical = NULL_INDEX;
+        uint32_t nextPhysical = NULL_INDEX;
+        uint32_t prevFree = NULL_INDEX;
+        uint32_t nextFree = NULL_INDEX; // Also links unused nodes
+        bool free = false;
+    };
+
+    uint64_t size_;
+    MemoryStrategy strategy_;
+
+    uint64_t allocatedBytes_ = 0;
+    uint32_t allocationCount_ = 0;
+
+    // === Linear ===
+    uint64_t linearHead_ = 0;
+
+    // === TLSF ===
+    std::vector<Node> nodes_;
+    uint32_t unusedNodes_ = NULL_INDEX;
+    uint64_t firstLevelBitmap_ = 0;
+    std::array<uint32_t, FIRST_LEVEL_COUNT> secondLevelBitmaps_{};
+    std::array<uint32_t, FIRST_LEVEL_COUNT * SECOND_LEVEL_COUNT> freeLists_{};
+
+    uint32_t createNode();
+    void destroyNode(uint32_t index);
+
+    /// @brief Gets the bucket a free range of this size is stored in
+    static void mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+
+    /// @brief Finds a non-empty bucket whose ranges are all at least size bytes
+    uint32_t findSuitableNode(uint64_t size) const;
+
+    void insertFree(uint32_t index);
+    void removeFree(uint32_t index);
+
+    /// @brief Merges a free node into its free neighbours and returns the survivor
+    uint32_t coalesce(uint32_t index);
+};
+
+} // namespace jelly::graphics::vulkan
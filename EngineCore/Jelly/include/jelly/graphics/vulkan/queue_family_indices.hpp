@@ -13,6 +13,10 @@ struct QueueFamilyIndices {
     /// Index of a queue family that supports presentation to a surface.
     std::optional<std::uint32_t> presentFamily;
 
+    /// Index of a queue family used for buffer uploads.
+    /// Prefers a transfer-only family, falls back to the graphics family.
+    std::optional<std::uint32_t> transferFamily;
+
     /// Returns true if both graphics and presentation queue families are found.
     [[nodiscard]] bool IsComplete() const {
         return graphicsFamily.has_value() && presentFamily.has_value();
@@ -1,18 +1,24 @@
 #pragma once
+#include "vulkan_memory_allocator.hpp"
+
 #include <vulkan/vulkan.h>
 
 namespace jelly::graphics::vulkan {
 
 class VulkanBufferUtils {
 public:
+    /// @brief Creates an exclusive buffer bound to memory from the allocator
+    /// @param allocation Receives the memory; host-visible memory is already mapped
+    /// @param strategy Linear for short-lived buffers such as staging copies
     static void createBuffer(
+        VulkanMemoryAllocator& allocator,
         VkDevice device,
-        VkPhysicalDevice physicalDevice,
         VkDeviceSize size,
         VkBufferUsageFlags usage,
         VkMemoryPropertyFlags properties,
         VkBuffer& buffer,
-        VkDeviceMemory& memory
+        MemoryAllocation*& allocation,
+        MemoryStrategy strategy = MemoryStrategy::Tlsf
     );
 
     static void copyBuffer(
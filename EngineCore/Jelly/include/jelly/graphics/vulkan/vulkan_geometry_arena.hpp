@@ -0,0 +1,113 @@
+#pragma once
+
+#include "memory_block_metadata.hpp"
+#include "vulkan_memory_allocator.hpp"
+
+#include "jelly/jelly_export.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace jelly::graphics::vulkan {
+
+class VulkanStagingUploader;
+
+/// @brief Vertices and indices a mesh occupies inside a VulkanGeometryArena
+struct GeometryArenaRange {
+    uint32_t vertexOffset = 0; ///< First vertex, used as the draw's vertexOffset
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;   ///< First index, used as the draw's firstIndex
+    uint32_t indexCount = 0;
+
+private:
+    friend class VulkanGeometryArena;
+
+    uint32_t vertexNode = MemoryBlockMetadata::INVALID_NODE;
+    uint32_t indexNode = MemoryBlockMetadata::INVALID_NODE;
+};
+
+/// @brief One device-local vertex buffer and one index buffer shared by many meshes.
+///
+/// Meshes sub-allocate vertex and index ranges and draw with firstIndex and
+/// vertexOffset, so every mesh of the arena is drawn after a single bind and
+/// whole material buckets can be merged into one indirect draw. Ranges are
+/// counted in elements (Vertex and uint32_t index) and filled through the
+/// staging uploader. Freed ranges are only reused once the frames that may
+/// still read them have completed. All methods are thread-safe.
+class JELLY_EXPORT VulkanGeometryArena {
+public:
+    /// @param device Logical Vulkan device
+    /// @param allocator Allocator providing the device-local memory
+    /// @param uploader Uploader filling the ranges; its queue families share the buffers
+    /// @param vertexCapacity Number of vertices the arena can hold
+    /// @param indexCapacity Number of indices the arena can hold
+    /// @param frameCount Number of frames in flight
+    VulkanGeometryArena(
+        VkDevice device,
+        VulkanMemoryAllocator& allocator,
+        VulkanStagingUploader& uploader,
+        uint32_t vertexCapacity,
+        uint32_t indexCapacity,
+        uint32_t frameCount
+    );
+    ~VulkanGeometryArena();
+
+    VulkanGeometryArena(const VulkanGeometryArena&) = delete;
+    VulkanGeometryArena& operator=(const VulkanGeometryArena&) = delete;
+
+    /// @brief Reserves vertex and index ranges
+    /// @param vertexCount Number of vertices
+    /// @param indexCount Number of indices
+    /// @param outRange Receives the ranges
+    /// @return False if the arena has no room, in which case outRange is untouched
+    bool allocate(uint32_t vertexCount, uint32_t indexCount, GeometryArenaRange& outRange);
+
+    /// @brief Queues copies of a mesh's data into its ranges
+    /// @param range Range returned by allocate()
+    /// @param vertices range.vertexCount interleaved vertices
+    /// @param indices range.indexCount indices, relative to the mesh's first vertex
+    void upload(const GeometryArenaRange& range, const void* vertices, const uint32_t* indices);
+
+    /// @brief Releases a range once the frames that may still draw from it are done
+    void free(GeometryArenaRange& range);
+
+    /// @brief Reclaims the ranges freed the last time this frame index was recorded
+    /// @param frameIndex Index of the frame in flight whose fence was just waited on
+    void beginFrame(uint32_t frameIndex);
+
+    /// @brief Binds the arena's vertex buffer at binding 0 and its index buffer
+    void bind(VkCommandBuffer commandBuffer) const;
+
+    /// @brief Gets the number of vertices in use
+    uint32_t getUsedVertices() const;
+
+    /// @brief Gets the number of indices in use
+    uint32_t getUsedIndices() const;
+
+    /// @brief Destroys the buffers; ranges still held by meshes become invalid
+    void release();
+
+private:
+    VkDevice device_ = VK_NULL_HANDLE;
+    VulkanMemoryAllocator& allocator_;
+    VulkanStagingUploader& uploader_;
+
+    VkBuffer vertexBuffer_ = VK_NULL_HANDLE;
+    MemoryAllocation* vertexMemory_ = nullptr;
+    VkBuffer indexBuffer_ = VK_NULL_HANDLE;
+    MemoryAllocation* indexMemory_ = nullptr;
+
+    mutable std::mutex mutex_;
+    MemoryBlockMetadata vertexRanges_;
+    MemoryBlockMetadata indexRanges_;
+    uint32_t currentFrame_ = 0;
+    std::vector<std::vector<GeometryArenaRange>> retiredRanges_; // Per frame in flight
+
+    /// @brief Creates a device-local buffer shared with the uploader's queue family
+    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, MemoryAllocation*& memory);
+};
+
+} // namespace jelly::graphics::vulkan
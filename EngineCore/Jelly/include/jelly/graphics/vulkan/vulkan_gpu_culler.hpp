@@ -0,0 +1,183 @@
+#pragma once
+
+#include "vulkan_gpu_timer.hpp"
+#include "vulkan_memory_allocator.hpp"
+
+#include "jelly/jelly_export.hpp"
+#include "jelly/graphics/graphic_api_interface.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace jelly::graphics::vulkan {
+
+/// @brief Frustum culling and indirect draw generation in a compute pass.
+///
+/// Draws and their candidate world matrices are written into host-visible
+/// storage buffers. A compute shader (gpu_cull.comp) tests every instance,
+/// appends the visible matrices to a device-local instance stream and compacts
+/// the draws with visible instances into one command range per bucket, with the
+/// number of commands in a count buffer consumed by vkCmdDrawIndexedIndirectCount.
+///
+/// The pass is recorded into its own command buffer; submit() queues it ahead of
+/// the frame and returns the semaphore the frame must wait on. Buffers belong to
+/// a frame in flight and grow as needed once their fence has been waited on.
+class JELLY_EXPORT VulkanGpuCuller {
+public:
+    /// @param device Logical Vulkan device
+    /// @param allocator Allocator providing the storage buffers
+    /// @param queueFamily Family of the queue passed to submit(); must support compute
+    /// @param spirvCode SPIR-V of gpu_cull.comp
+    /// @param drawIndexedIndirectCount vkCmdDrawIndexedIndirectCount(KHR) entry point
+    /// @param frameCount Number of frames in flight
+    VulkanGpuCuller(
+        VkDevice device,
+        VulkanMemoryAllocator& allocator,
+        uint32_t queueFamily,
+        const std::vector<uint8_t>& spirvCode,
+        PFN_vkCmdDrawIndexedIndirectCountKHR drawIndexedIndirectCount,
+        uint32_t frameCount
+    );
+    ~VulkanGpuCuller();
+
+    VulkanGpuCuller(const VulkanGpuCuller&) = delete;
+    VulkanGpuCuller& operator=(const VulkanGpuCuller&) = delete;
+
+    /// @brief Starts the input of a frame
+    /// @param frameIndex Index of the frame in flight being recorded (its fence has been waited on)
+    /// @param frustumPlanes Six normalized inward-facing planes (24 floats)
+    void begin(uint32_t frameIndex, const float* frustumPlanes);
+
+    /// @brief Opens a bucket drawn by a single drawBucket()
+    uint32_t addBucket();
+
+    /// @brief Adds a draw and its candidate instances to a bucket
+    void addDraw(uint32_t bucket, const CulledDrawDesc& draw, const float* worldMatrices, uint32_t instanceCount);
+
+    /// @brief Records the culling pass of the frame's draws
+    void dispatch();
+
+    /// @brief Submits the pass recorded by dispatch()
+    /// @param queue Queue of the family given to the constructor
+    /// @return Semaphore signaled when the pass is done, or VK_NULL_HANDLE if nothing was dispatched
+    VkSemaphore submit(VkQueue queue);
+
+    /// @brief Binds the culled instance stream and draws a bucket
+    /// @param commandBuffer Command buffer inside the render pass, shared geometry bound
+    /// @param bucket Bucket returned by addBucket()
+    /// @param instanceBinding Vertex binding of the per-instance stream
+    void drawBucket(VkCommandBuffer commandBuffer, uint32_t bucket, uint32_t instanceBinding) const;
+
+    /// @brief Times the pass as the "GpuCulling" scope
+    /// @param timer Timer of the frames the pass runs in, or null
+    void setGpuTimer(VulkanGpuTimer* timer) { gpuTimer_ = timer; }
+
+    /// @brief Allocates the shader outputs in host-visible memory so readResults() can copy them
+    ///
+    /// The outputs are reallocated on the next dispatch; the GPU must be done with every frame.
+    void setHostReadable(bool readable);
+
+    /// @brief Returns true if a pass was submitted since the last begin()
+    bool hasResults() const { return resultsReady_; }
+
+    /// @brief Gets the frame in flight of the latest pass, whose fence covers it
+    uint32_t getFrameIndex() const { return currentFrame_; }
+
+    /// @brief Copies the compacted commands and the instance stream of the latest pass
+    /// @param results Receives one command list per bucket and the instance matrices
+    /// @return False unless host-readable and a pass was submitted; the pass must be complete
+    bool readResults(GpuCullingResults& results) const;
+
+    /// @brief Gets the number of instances handed to the pass this frame
+    uint32_t getInstanceCount() const { return instanceCount_; }
+
+    /// @brief Destroys every Vulkan object
+    void release();
+
+private:
+    /// @brief Per-draw record read by the shader (std430 CullDraw)
+    struct GpuDraw {
+        float center[4];
+        float extents[4];
+        uint32_t bucket;
+        uint32_t commandBase;
+        uint32_t instanceBase;
+        uint32_t padding;
+    };
+
+    /// @brief Push constants of the shader
+    struct PushConstants {
+        float planes[24];
+        uint32_t instanceCount;
+        uint32_t drawCount;
+        uint32_t pass;
+    };
+
+    struct StorageBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        MemoryAllocation* memory = nullptr;
+        VkDeviceSize capacity = 0;
+    };
+
+    struct FrameResources {
+        // Written by the CPU
+        StorageBuffer draws;
+        StorageBuffer commands;
+        StorageBuffer drawIndices;
+        StorageBuffer worlds;
+        // Written by the shader
+        StorageBuffer compacted;
+        StorageBuffer counts;
+        StorageBuffer instances;
+
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        bool descriptorsDirty = true;
+        bool dispatched = false;
+    };
+
+    static constexpr uint32_t WORKGROUP_SIZE = 64;
+    static constexpr uint32_t BINDING_COUNT = 7;
+    static constexpr VkDeviceSize MIN_BUFFER_SIZE = 64 * 1024;
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VulkanMemoryAllocator& allocator_;
+    PFN_vkCmdDrawIndexedIndirectCountKHR drawIndexedIndirectCount_;
+    VulkanGpuTimer* gpuTimer_ = nullptr;
+
+    VkDescriptorSetLayout descriptorSetLayout_ = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool_ = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE;
+    VkPipeline pipeline_ = VK_NULL_HANDLE;
+    VkCommandPool commandPool_ = VK_NULL_HANDLE;
+
+    std::vector<FrameResources> frames_;
+    uint32_t currentFrame_ = 0;
+
+    PushConstants params_{};
+    uint32_t instanceCount_ = 0;
+    uint32_t drawCount_ = 0;
+    std::vector<uint32_t> bucketDrawCounts_;
+    std::vector<uint32_t> bucketBases_;
+    bool hostReadable_ = false;
+    bool resultsReady_ = false;
+
+    void createPipeline(const std::vector<uint8_t>& spirvCode);
+    void createFrameResources(uint32_t frameCount);
+
+    /// @brief Grows a buffer to hold at least size bytes, keeping the first keepBytes if host-visible
+    void reserve(
+        StorageBuffer& storage, VkDeviceSize size, VkDeviceSize keepBytes,
+        VkBufferUsageFlags usage, bool hostVisible, FrameResources& frame
+    );
+
+    void destroyBuffer(StorageBuffer& storage);
+
+    /// @brief Points the frame's descriptor set at its current buffers
+    void updateDescriptors(FrameResources& frame);
+};
+
+} // namespace jelly::graphics::vulkan
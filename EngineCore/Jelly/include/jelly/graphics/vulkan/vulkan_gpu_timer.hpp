@@ -0,0 +1,119 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+#include "jelly/graphics/graphic_api_interface.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace jelly::graphics::vulkan {
+
+/// @brief Measures GPU time of named scopes with timestamp queries.
+///
+/// Every frame in flight owns a query pool split into fixed blocks, one per
+/// command buffer that writes timestamps. Each command buffer resets its own
+/// block when it starts, so command buffers may be submitted in any order.
+///
+/// Results are read when the frame slot comes around again, right after its
+/// fence has been waited on, so reading them never stalls. The timings are
+/// framesInFlight frames old by then.
+///
+/// Resolved scopes are also added to a "GPU" track of the CPU profiler while a
+/// capture runs. With VK_EXT_calibrated_timestamps and a CLOCK_MONOTONIC host
+/// domain, the GPU clock is mapped exactly. Otherwise the first timestamp of a
+/// frame is placed at the CPU time of its submission, which is only a lower bound.
+///
+/// Not thread-safe: scopes are opened from the thread recording the frame.
+class JELLY_EXPORT VulkanGpuTimer {
+public:
+    static constexpr uint32_t INVALID_SCOPE = UINT32_MAX;
+    static constexpr uint32_t MAX_COMMAND_BUFFERS = 4;            // Command buffers timed per frame
+    static constexpr uint32_t QUERIES_PER_COMMAND_BUFFER = 64;    // Two queries per scope
+
+    /// @param device Logical Vulkan device
+    /// @param timestampPeriod Nanoseconds per timestamp tick (VkPhysicalDeviceLimits::timestampPeriod)
+    /// @param timestampValidBits Valid bits of the queue family's timestamps
+    /// @param frameCount Number of frames in flight
+    /// @param getCalibratedTimestamps vkGetCalibratedTimestampsEXT, or null to anchor frames at submission
+    VulkanGpuTimer(
+        VkDevice device,
+        float timestampPeriod,
+        uint32_t timestampValidBits,
+        uint32_t frameCount,
+        PFN_vkGetCalibratedTimestampsEXT getCalibratedTimestamps
+    );
+    ~VulkanGpuTimer();
+
+    VulkanGpuTimer(const VulkanGpuTimer&) = delete;
+    VulkanGpuTimer& operator=(const VulkanGpuTimer&) = delete;
+
+    /// @brief Reads back the previous use of a frame slot and starts recording it
+    /// @param frameIndex Frame in flight about to be recorded; its fence must have been waited on
+    /// @param frameNumber Running number of the frame
+    void beginFrame(uint32_t frameIndex, uint64_t frameNumber);
+
+    /// @brief Resets the query block of a command buffer of the current frame
+    /// @param commandBuffer Command buffer in the recording state, outside a render pass
+    /// @return Block index for beginScope(), or INVALID_SCOPE if every block is taken
+    uint32_t beginCommandBuffer(VkCommandBuffer commandBuffer);
+
+    /// @brief Writes the start timestamp of a scope
+    /// @param commandBuffer Command buffer the block was reset in
+    /// @param block Block returned by beginCommandBuffer()
+    /// @param name Scope name, must outlive the frame
+    /// @return Scope id for endScope(), or INVALID_SCOPE if the block is full
+    uint32_t beginScope(VkCommandBuffer commandBuffer, uint32_t block, const char* name);
+
+    /// @brief Writes the end timestamp of a scope
+    void endScope(VkCommandBuffer commandBuffer, uint32_t scope);
+
+    /// @brief Records the CPU time the current frame was submitted, for the uncalibrated timeline
+    void setSubmitTime(uint64_t profilerTime);
+
+    /// @brief Gets the timings of the latest resolved frame
+    /// @return False until a frame has been resolved
+    bool getLastFrameStats(GpuFrameStats& stats) const;
+
+    /// @brief Destroys the query pools
+    void release();
+
+private:
+    struct Scope {
+        const char* name = nullptr;
+        uint32_t beginQuery = 0;
+        uint32_t endQuery = INVALID_SCOPE;
+    };
+
+    struct Frame {
+        VkQueryPool pool = VK_NULL_HANDLE;
+        std::vector<Scope> scopes;
+        uint32_t blockUsed[MAX_COMMAND_BUFFERS] = {};
+        uint32_t blockCount = 0;
+        uint64_t frameNumber = 0;
+        uint64_t submitTime = 0;
+        bool recorded = false;
+    };
+
+    VkDevice device_;
+    double nanosecondsPerTick_;
+    uint64_t timestampMask_;
+    PFN_vkGetCalibratedTimestampsEXT getCalibratedTimestamps_;
+    uint32_t profilerTrack_;
+
+    std::vector<Frame> frames_;
+    uint32_t currentFrame_ = 0;
+    std::vector<uint64_t> results_;
+
+    GpuFrameStats lastStats_;
+    bool hasStats_ = false;
+
+    /// @brief Turns the query results of a frame into stats and profiler zones
+    void resolve(Frame& frame);
+
+    /// @brief Gets the profiler time of GPU tick 0, or false without calibration
+    bool calibrate(int64_t& gpuZeroProfilerTime) const;
+};
+
+} // namespace jelly::graphics::vulkan
@@ -2,6 +2,14 @@
 
 #include "queue_family_indices.hpp"
 #include "swap_chain_support_details.hpp"
+#include "vulkan_ring_buffer.hpp"
+#include "vulkan_geometry_arena.hpp"
+#include "vulkan_gpu_culler.hpp"
+#include "vulkan_gpu_timer.hpp"
+#include "vulkan_memory_allocator.hpp"
+#include "vulkan_parallel_recorder.hpp"
+#include "vulkan_pipeline_registry.hpp"
+#include "vulkan_staging_uploader.hpp"
 
 #include "jelly/jelly_export.hpp"
 #include "jelly/core/managed_resource.hpp"
@@ -10,6 +18,10 @@
 #include "jelly/windowing/vulkan_native_window_handle_provider.hpp"
 
 #include <vulkan/vulkan.h>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <set>
 
@@ -40,6 +52,117 @@ public:
     /// @brief Ends the current frame (submits commands and presents the image).
     void endFrame() override;
 
+    /// @brief Copies world matrices into this frame's per-instance vertex stream.
+    /// @param worldMatrices Pointer to count column-major 4x4 matrices
+    /// @param count Number of instances to write
+    /// @return Index of the first written instance (firstInstance of the draw)
+    uint32_t writeInstanceData(const float* worldMatrices, uint32_t count) override;
+
+    /// @brief Renders into offscreen images instead of a swapchain; call before initialize().
+    ///
+    /// No window, surface or swapchain is created and frames are never presented,
+    /// so the backend runs on display-less machines and software devices such as lavapipe.
+    /// @param width Width of the color and depth targets in pixels
+    /// @param height Height of the color and depth targets in pixels
+    /// @param readback Copy every frame into a host-visible buffer for readFramePixels()
+    /// @return Always true
+    bool setOffscreenTarget(uint32_t width, uint32_t height, bool readback) override;
+
+    /// @brief Copies the last submitted offscreen frame, waiting for its fence
+    /// @param pixels Receives width * height RGBA8 pixels, top row first
+    /// @return False unless running offscreen with readback and a frame has been submitted
+    bool readFramePixels(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) override;
+
+    /// @brief Returns true when rendering into offscreen images instead of a swapchain
+    bool isOffscreen() const { return offscreen_; }
+
+    /// @brief Sets how many frames the CPU may record ahead of the GPU; call before initialize().
+    ///
+    /// Every per-frame resource (fences, command buffers, ring buffers, shader
+    /// descriptor sets, query pools) is sized from this count.
+    /// @param count Clamped to [1, MAX_FRAMES_IN_FLIGHT]
+    void setFramesInFlight(uint32_t count) override;
+
+    /// @brief Returns the number of frames in flight
+    uint32_t getFramesInFlight() const { return framesInFlight_; }
+
+    /// @brief Selects the swapchain present mode; call before initialize().
+    ///
+    /// Modes the surface does not support fall back to FIFO, which is always available.
+    void setPresentMode(core::PresentMode mode) override;
+
+    /// @brief Upper bound of setFramesInFlight()
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+    /// @brief Sets the number of threads recording secondary command buffers.
+    ///
+    /// With a non-zero count the render pass is begun with secondary contents,
+    /// so all draws of a frame must go through recordDraws().
+    /// @param count Number of recording threads (0 records inline on the main thread)
+    void setRecordingThreadCount(uint32_t count) override;
+
+    /// @brief Records draws inline, or into per-worker secondaries executed by the primary
+    /// @param itemCount Number of draws to record
+    /// @param record Callback recording the draws [begin, end)
+    void recordDraws(uint32_t itemCount, const std::function<void(uint32_t begin, uint32_t end)>& record) override;
+
+    /// @brief Binds the geometry arena's vertex and index buffers to the current command buffer
+    /// @return False if the arena could not be created
+    bool bindSharedGeometry() override;
+
+    /// @brief Writes the commands into this frame's indirect buffer and draws them
+    ///
+    /// Uses one vkCmdDrawIndexedIndirect per maxDrawIndirectCount commands when
+    /// multiDrawIndirect is available, one per command otherwise, and plain
+    /// vkCmdDrawIndexed when the device lacks drawIndirectFirstInstance.
+    /// @param commands Draws against the shared geometry
+    /// @param commandCount Number of commands
+    /// @return Number of draw calls recorded
+    uint32_t drawIndexedIndirect(const DrawIndexedCommand* commands, uint32_t commandCount) override;
+
+    /// @brief Returns true if the culling shader loaded and the device has
+    /// VK_KHR_draw_indirect_count, drawIndirectFirstInstance and compute on the graphics queue
+    bool supportsGpuCulling() const override { return gpuCuller_ != nullptr; }
+
+    /// @brief Starts this frame's GPU culling input
+    /// @param frustumPlanes Six normalized inward-facing planes (24 floats)
+    void beginGpuCulling(const float* frustumPlanes) override;
+
+    /// @brief Opens a bucket of draws sharing a material
+    uint32_t addCulledBucket() override;
+
+    /// @brief Writes a draw and its candidate instances into the culling input
+    void addCulledDraw(uint32_t bucket, const CulledDrawDesc& draw, const float* worldMatrices, uint32_t instanceCount) override;
+
+    /// @brief Records the culling pass; it is submitted ahead of the frame in endFrame()
+    void dispatchGpuCulling() override;
+
+    /// @brief Draws a bucket's visible instances with one vkCmdDrawIndexedIndirectCountKHR
+    /// @return Number of draw calls recorded
+    uint32_t drawCulledBucket(uint32_t bucket) override;
+
+    /// @brief Moves the culling outputs to host-visible memory, after waiting for the device to be idle
+    void setGpuCullingReadback(bool enabled) override;
+
+    /// @brief Waits for the fence of the latest culling pass and copies its outputs
+    bool readGpuCullingResults(GpuCullingResults& results) override;
+
+    /// @brief Writes a start timestamp into the frame's primary command buffer
+    ///
+    /// The frame's render pass is always open while scenes record, so scopes are
+    /// only available when draws are recorded inline (no recording threads).
+    /// @return Scope id, or VulkanGpuTimer::INVALID_SCOPE if the scope cannot be timed
+    uint32_t beginGpuScope(const char* name) override;
+
+    /// @brief Writes the end timestamp of a scope
+    void endGpuScope(uint32_t scope) override;
+
+    /// @brief Copies the GPU timings of the latest frame read back, framesInFlight frames old.
+    ///
+    /// Every frame has the built-in scopes "Frame" (the primary command buffer),
+    /// "RenderPass" and, when GPU culling ran, "GpuCulling".
+    bool getGpuFrameStats(GpuFrameStats& stats) const override;
+
     /// @brief Cleans up all Vulkan resources.
     void shutdown() override;
 
@@ -57,7 +180,9 @@ public:
     VkPhysicalDevice getPhysicalDevice() const { return physicalDevice_.get(); }
 
     /// @brief Returns the command buffer currently being recorded.
-    VkCommandBuffer getCurrentCommandBuffer() const { return commandBuffers_[currentImageIndex_]; }
+    ///
+    /// On a recording worker this is the worker's secondary command buffer.
+    VkCommandBuffer getCurrentCommandBuffer() const;
 
     /// @brief Gets the extent (resolution) of the swapchain.
     VkExtent2D getSwapchainExtent() const { return swapchainExtent_; }
@@ -73,9 +198,41 @@ public:
         return graphicsQueue_;
     }
 
+    /// @brief Returns the pipeline cache shared by every pipeline compile
+    VkPipelineCache getPipelineCache() const { return pipelineCache_.get(); }
+
+    /// @brief Compiles a graphics pipeline through the pipeline cache
+    ///
+    /// Records the compile time and, with VK_EXT_pipeline_creation_feedback,
+    /// whether the driver found the pipeline in the cache. Safe to call from any thread.
+    /// @param createInfo Complete pipeline description; its pNext chain is left untouched
+    /// @return The new pipeline, owned by the caller
+    VkPipeline compileGraphicsPipeline(const VkGraphicsPipelineCreateInfo& createInfo);
+
+    /// @brief Returns the registry materials get their shared pipelines from
+    VulkanPipelineRegistry* getPipelineRegistry() const { return pipelineRegistry_.get(); }
+
+    /// @brief Returns the allocator every buffer and image takes its memory from
+    VulkanMemoryAllocator* getMemoryAllocator() const { return memoryAllocator_.get(); }
+
+    /// @brief Returns the uploader that copies static mesh data into device-local memory
+    VulkanStagingUploader* getStagingUploader() const { return stagingUploader_.get(); }
+
+    /// @brief Returns the arena shared meshes sub-allocate from, or nullptr if it could not be created
+    VulkanGeometryArena* getGeometryArena() const { return geometryArena_.get(); }
+
     /// @brief Returns the current frame index for synchronization
     uint32_t getCurrentFrameIndex() const { return currentFrame_; }
 
+    /// @brief Returns the per-frame ring buffer used for dynamic uniform data
+    VulkanRingBuffer* getUniformRingBuffer() const { return uniformRingBuffer_.get(); }
+
+    /// @brief Vertex binding that carries per-instance world matrices
+    static constexpr uint32_t INSTANCE_BINDING = 1;
+
+    /// @brief Size in bytes of one per-instance record (a column-major 4x4 matrix)
+    static constexpr uint32_t INSTANCE_STRIDE = sizeof(float) * 16;
+
 private:
     // === Window system ===
     jelly::windowing::VulkanNativeWindowHandleProvider* windowProvider_ = nullptr;
@@ -84,10 +241,30 @@ private:
     ManagedResource<VkInstance> instance_;
     ManagedResource<VkPhysicalDevice> physicalDevice_;
     ManagedResource<VkDevice> device_;
+    std::unique_ptr<VulkanMemoryAllocator> memoryAllocator_;
 
     // === Queues ===
     VkQueue graphicsQueue_ = VK_NULL_HANDLE;
     VkQueue presentQueue_ = VK_NULL_HANDLE;
+    VkQueue transferQueue_ = VK_NULL_HANDLE; // Same as graphicsQueue_ without a transfer-only family
+    uint32_t graphicsFamily_ = 0;
+    uint32_t transferFamily_ = 0;
+
+    // === Optional device features ===
+    bool multiDrawIndirect_ = false;
+    bool drawIndirectFirstInstance_ = false;
+    uint32_t maxDrawIndirectCount_ = 1;
+    PFN_vkCmdDrawIndexedIndirectCountKHR cmdDrawIndexedIndirectCount_ = nullptr; // Null without VK_KHR_draw_indirect_count
+    bool pipelineCreationFeedback_ = false; // VK_EXT_pipeline_creation_feedback enabled
+    PFN_vkGetCalibratedTimestampsEXT getCalibratedTimestamps_ = nullptr; // Null without a CLOCK_MONOTONIC calibration
+
+    // === Pipeline cache ===
+    ManagedResource<VkPipelineCache> pipelineCache_;
+    std::filesystem::path pipelineCachePath_;
+    std::atomic<uint32_t> pipelineCompileCount_ = 0;
+    std::atomic<uint32_t> pipelineCacheHitCount_ = 0;
+    std::atomic<uint64_t> pipelineCompileNanoseconds_ = 0;
+    std::unique_ptr<VulkanPipelineRegistry> pipelineRegistry_;
 
     // === Surface and swapchain ===
     ManagedResource<VkSurfaceKHR> surface_;
@@ -116,11 +293,54 @@ private:
     // === Frame state ===
     size_t currentFrame_ = 0;
     uint32_t currentImageIndex_ = 0;
-    static constexpr int maxFramesInFlight_ = 2;
+    uint32_t framesInFlight_ = 2;
+    core::PresentMode presentMode_ = core::PresentMode::Auto;
+
+    // === Per-frame streaming buffers ===
+    static constexpr VkDeviceSize uniformRingCapacity_ = 8 * 1024 * 1024;
+    static constexpr VkDeviceSize instanceRingCapacity_ = 16 * 1024 * 1024;
+    static constexpr VkDeviceSize indirectRingCapacity_ = 1024 * 1024;
+    std::unique_ptr<VulkanRingBuffer> uniformRingBuffer_;
+    std::unique_ptr<VulkanRingBuffer> instanceRingBuffer_;
+    std::unique_ptr<VulkanRingBuffer> indirectRingBuffer_;
+    std::mutex indirectMutex_; // Recording threads share the indirect ring
+
+    // === Parallel recording ===
+    static constexpr uint32_t minDrawsPerRecordingThread_ = 128;
+    uint32_t recordingThreadCount_ = 0;
+    std::unique_ptr<VulkanParallelRecorder> parallelRecorder_;
+    std::vector<VkCommandBuffer> secondaryCommandBuffers_; // Owned by the recorder's pools
+
+    // === Uploads ===
+    std::unique_ptr<VulkanStagingUploader> stagingUploader_;
+
+    // === Shared geometry ===
+    static constexpr uint32_t geometryArenaVertexCapacity_ = 1u << 20;
+    static constexpr uint32_t geometryArenaIndexCapacity_ = 1u << 22;
+    std::unique_ptr<VulkanGeometryArena> geometryArena_;
+
+    // === GPU culling ===
+    std::unique_ptr<VulkanGpuCuller> gpuCuller_; // Null when culling stays on the CPU
+
+    // === GPU timing ===
+    std::unique_ptr<VulkanGpuTimer> gpuTimer_;   // Null when the graphics queue has no timestamps
+    uint32_t gpuTimerBlock_ = VulkanGpuTimer::INVALID_SCOPE;  // Query block of the primary command buffer
+    uint32_t frameScope_ = VulkanGpuTimer::INVALID_SCOPE;
+    uint32_t renderPassScope_ = VulkanGpuTimer::INVALID_SCOPE;
+    uint64_t frameNumber_ = 0;
+
+    // === Offscreen target (no surface or swapchain) ===
+    static constexpr VkFormat offscreenFormat_ = VK_FORMAT_R8G8B8A8_SRGB;
+    bool offscreen_ = false;
+    bool offscreenReadback_ = false;
+    std::vector<MemoryAllocation*> offscreenImageMemory_; // One per image in swapchainImages_
+    std::vector<VkBuffer> readbackBuffers_;                // One per frame in flight
+    std::vector<MemoryAllocation*> readbackMemory_;
+    int readbackFrame_ = -1;                               // Frame slot holding the last copied frame
 
     // === Depth resources ===
     VkImage depthImage_ = VK_NULL_HANDLE;
-    VkDeviceMemory depthImageMemory_ = VK_NULL_HANDLE;
+    MemoryAllocation* depthImageMemory_ = nullptr;
     VkImageView depthImageView_ = VK_NULL_HANDLE;
 
 #ifdef JELLY_DEBUG
@@ -141,7 +361,7 @@ private:
     /// @brief Creates Vulkan instance with appropriate extensions and layers
     void createInstance();
     
-    /// @brief Creates window surface for presentation
+    /// @brief Creates window surface for presentation (skipped offscreen)
     void createSurface();
     
     /// @brief Selects suitable physical device (GPU)
@@ -149,6 +369,21 @@ private:
     
     /// @brief Creates logical device and retrieves queues
     void createLogicalDevice();
+
+    /// @brief Creates the pipeline cache, seeded from disk when a valid file exists for this device
+    void createPipelineCache();
+
+    /// @brief Creates the registry deduplicating graphics pipelines
+    void createPipelineRegistry();
+
+    /// @brief Logs how many pipelines the materials shared and drops the registry
+    void destroyPipelineRegistry();
+
+    /// @brief Writes the pipeline cache to disk and logs its hit rate and compile time
+    void savePipelineCache();
+
+    /// @brief Creates the device memory sub-allocator
+    void createMemoryAllocator();
     
     /// @brief Creates swapchain for image presentation
     void createSwapchain();
@@ -159,6 +394,9 @@ private:
     /// @brief Creates depth buffer resources (image, memory, and view)
     void createDepthResources();
 
+    /// @brief Destroys the depth image, view and memory
+    void destroyDepthResources();
+
     /// @brief Creates render pass defining attachment operations
     void createRenderPass();
     
@@ -173,11 +411,55 @@ private:
     
     /// @brief Creates synchronization primitives (semaphores, fences)
     void createSyncObjects();
+
+    /// @brief Recreates the per-swapchain-image semaphores and fence slots
+    ///
+    /// Leaves the per-frame fences alone: other components (e.g. the staging
+    /// uploader) keep them to track GPU progress.
+    void createImageSyncObjects();
+
+    /// @brief Creates the persistently-mapped per-frame ring buffers
+    void createRingBuffers();
+
+    /// @brief Creates the secondary command buffer recorder if recording threads are enabled
+    void createParallelRecorder();
+
+    /// @brief Creates the staging uploader on the transfer queue
+    void createStagingUploader();
+
+    /// @brief Creates the shared vertex and index arena
+    void createGeometryArena();
+
+    /// @brief Creates the compute culling pass if the device and assets allow it
+    void createGpuCuller();
+
+    /// @brief Creates the timestamp queries when the graphics queue supports them
+    void createGpuTimer();
+
+    /// @brief Creates the offscreen color images standing in for swapchain images, and the readback buffers
+    void createOffscreenTargets();
+
+    /// @brief Destroys the offscreen images and readback buffers
+    void destroyOffscreenTargets();
+
+    /// @brief Copies the frame's color image into its readback buffer, after the render pass
+    void recordFrameReadback(VkCommandBuffer commandBuffer);
+
+    /// @brief Binds the per-frame state every command buffer of the render pass needs
+    ///
+    /// Sets the instance stream and the dynamic viewport and scissor; secondaries
+    /// inherit none of it, so each one calls this before drawing.
+    /// @param commandBuffer Primary or secondary command buffer inside the render pass
+    void bindFrameState(VkCommandBuffer commandBuffer);
     
     /// @brief Recreates swapchain on window resize or other changes
+    ///
+    /// Pipelines use dynamic viewport and scissor, so a resize only rebuilds the
+    /// swapchain, its views, framebuffers and depth buffer. The render pass, and
+    /// with it every material pipeline, is rebuilt only if the surface format changed.
     void recreateSwapchain();
     
-    /// @brief Cleans up swapchain-related resources
+    /// @brief Cleans up swapchain-related resources (the render pass is kept)
     void cleanupSwapchain();
 
     // === Helper functions ===
@@ -193,12 +475,6 @@ private:
     /// @return First supported format from candidates
     VkFormat findSupportedFormat(const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
-    /// @brief Finds a suitable memory type for allocation
-    /// @param typeFilter Memory type filter
-    /// @param properties Required memory properties
-    /// @return Index of suitable memory type
-    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
-
     /// @brief Queries swapchain capabilities for given device and surface
     /// @param device Physical device to query
     /// @param surface Surface to check compatibility with
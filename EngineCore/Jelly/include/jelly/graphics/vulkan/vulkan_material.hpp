@@ -24,11 +24,26 @@ public:
     /// @brief Creates material with specified shader
     explicit VulkanMaterial(std::shared_ptr<jelly::graphics::ShaderInterface> shader);
 
-    /// @brief Initializes Vulkan pipeline for this material
-    void createPipeline(VulkanGraphicAPI* api);
+    /// @brief Acquires the shared pipeline for this material's shader and state
+    /// @param api Graphics API owning the pipeline registry
+    /// @param async Compile on a job worker instead of blocking the calling thread
+    void createPipeline(VulkanGraphicAPI* api, bool async = false);
+
+    /// @brief Gets the registry id of the shared pipeline
+    uint32_t getPipelineId() const override { return pipeline_ ? pipeline_->id : getId(); }
+
+    /// @brief Returns true once the shared pipeline has finished compiling
+    bool isReady() const override { return pipeline_ && pipeline_->isReady(); }
 
     /// @brief Binds the material's pipeline for rendering
-    void bind() override;    
+    void bind() override;
+
+    /// @brief Binds the graphics pipeline to the current command buffer
+    void bindPipeline() override;
+
+    /// @brief Binds the shader's descriptor set for the current frame
+    /// @param uniformOffset Dynamic offset of the draw's uniform slice
+    void bindResources(uint32_t uniformOffset) override;
 
     /// @brief Sets the albedo (base color) texture
     /// @param texture The texture to use as albedo map
@@ -55,19 +70,8 @@ private:
     std::shared_ptr<jelly::graphics::ShaderInterface> shader_;
     std::unordered_map<TextureType, std::shared_ptr<VulkanTexture>> textures_;
 
-    // Auto-managed Vulkan resources
-    jelly::core::ManagedResource<VkPipeline> pipeline_;
-    jelly::core::ManagedResource<VkPipelineLayout> pipelineLayout_;
-
-    /// @brief Creates Vulkan graphics pipeline
-    VkPipeline createGraphicsPipeline(
-        VkDevice device,
-        VkRenderPass renderPass,
-        VkPipelineLayout pipelineLayout,
-        VkShaderModule vertShaderModule,
-        VkShaderModule fragShaderModule,
-        VkExtent2D extent
-    );
+    // Shared with every material of the same pipeline key
+    std::shared_ptr<const VulkanPipeline> pipeline_;
 
     /// @brief Updates texture descriptor sets for all frames
     /// 
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "memory_block_metadata.hpp"
+
+#include "jelly/jelly_export.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace jelly::graphics::vulkan {
+
+class VulkanMemoryAllocator;
+struct MemoryBlock; // One vkAllocateMemory shared by many allocations
+
+/// @brief Range of device memory handed out by VulkanMemoryAllocator.
+///
+/// The pointer stays valid until it is passed to VulkanMemoryAllocator::free().
+struct MemoryAllocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE; ///< Block the range lives in
+    VkDeviceSize offset = 0;                ///< Offset of the range inside memory
+    VkDeviceSize size = 0;                  ///< Size of the range
+    uint8_t* mapped = nullptr;              ///< Host pointer to the range, null if not host-visible
+
+private:
+    friend class VulkanMemoryAllocator;
+
+    MemoryBlock* block = nullptr; // Null for dedicated allocations
+    VkDeviceSize alignment = 1;
+    uint32_t node = 0;
+    uint32_t memoryType = 0;
+};
+
+/// @brief Usage statistics of one memory heap
+struct MemoryHeapStats {
+    VkDeviceSize heapSize = 0;           ///< Size reported by the device
+    VkDeviceSize blockBytes = 0;         ///< Bytes obtained with vkAllocateMemory
+    VkDeviceSize allocatedBytes = 0;     ///< Bytes handed out to resources
+    uint32_t blockCount = 0;             ///< Pooled blocks
+    uint32_t dedicatedCount = 0;         ///< Resources that own their vkAllocateMemory
+    uint32_t allocationCount = 0;        ///< Live allocations, dedicated included
+    VkDeviceSize largestFreeRange = 0;   ///< Largest range a pooled allocation could still get
+    float fragmentation = 0.0f;          ///< 1 - largestFreeRange / free bytes of the pooled blocks
+};
+
+/// @brief Sparsely used pooled block whose allocations fit elsewhere in their pool
+struct DefragmentationCandidate {
+    VkDeviceMemory memory = VK_NULL_HANDLE;       ///< Block that would be released once empty
+    VkDeviceSize allocatedBytes = 0;              ///< Bytes still in use in the block
+    std::vector<MemoryAllocation*> allocations;   ///< Live allocations to relocate
+};
+
+/// @brief Sub-allocates device memory from large per-memory-type blocks.
+///
+/// Resources are placed into pooled blocks keyed by memory type, resource kind
+/// (buffers and optimal images never share a block, which sidesteps
+/// bufferImageGranularity) and strategy. Requests larger than half a block get
+/// a dedicated vkAllocateMemory. Host-visible blocks are mapped once for their
+/// whole lifetime, so callers must use MemoryAllocation::mapped instead of
+/// vkMapMemory. All methods are thread-safe.
+class JELLY_EXPORT VulkanMemoryAllocator {
+public:
+    /// @brief Kind of resource bound to an allocation
+    enum class ResourceKind : uint32_t { Buffer = 0, Image = 1 };
+
+    /// @param device Logical Vulkan device
+    /// @param physicalDevice Physical Vulkan device
+    VulkanMemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice);
+    ~VulkanMemoryAllocator();
+
+    VulkanMemoryAllocator(const VulkanMemoryAllocator&) = delete;
+    VulkanMemoryAllocator& operator=(const VulkanMemoryAllocator&) = delete;
+
+    /// @brief Allocates memory for requirements reported by Vulkan
+    /// @param requirements Size, alignment and allowed memory types
+    /// @param properties Required memory properties
+    /// @param kind Resource the memory will be bound to
+    /// @param strategy Tlsf for long-lived resources, Linear for short-lived ones released together
+    MemoryAllocation* allocate(
+        const VkMemoryRequirements& requirements,
+        VkMemoryPropertyFlags properties,
+        ResourceKind kind,
+        MemoryStrategy strategy = MemoryStrategy::Tlsf
+    );
+
+    /// @brief Allocates and binds memory for a buffer
+    MemoryAllocation* allocateForBuffer(
+        VkBuffer buffer,
+        VkMemoryPropertyFlags properties,
+        MemoryStrategy strategy = MemoryStrategy::Tlsf
+    );
+
+    /// @brief Allocates and binds memory for an image
+    MemoryAllocation* allocateForImage(VkImage image, VkMemoryPropertyFlags properties);
+
+    /// @brief Releases an allocation; the resource bound to it must already be destroyed
+    void free(MemoryAllocation* allocation);
+
+    /// @brief Lists the blocks defragmentation should empty
+    ///
+    /// The allocator never moves memory itself: an owner that can recreate its
+    /// resource asks allocateRelocation() for a new range, binds a new resource
+    /// to it, copies the contents and frees the old allocation. A block is
+    /// released once its last allocation is gone.
+    /// @param maxUsage Blocks used above this fraction are left alone
+    /// @return Candidates from the least used block up; only Tlsf pools with free room in other blocks
+    std::vector<DefragmentationCandidate> getDefragmentationCandidates(float maxUsage = 0.25f);
+
+    /// @brief Allocates a range like an existing allocation, in another block of its pool
+    ///
+    /// Never creates a block, so moving an allocation never grows the pool.
+    /// @param allocation Pooled allocation to move
+    /// @return The new range, or nullptr if no other block has room
+    MemoryAllocation* allocateRelocation(const MemoryAllocation* allocation);
+
+    /// @brief Gets the usage of every memory heap, indexed like VkPhysicalDeviceMemoryProperties::memoryHeaps
+    std::vector<MemoryHeapStats> getHeapStats() const;
+
+    /// @brief Gets the number of live vkAllocateMemory calls (blocks plus dedicated allocations)
+    uint32_t getDeviceAllocationCount() const;
+
+private:
+    /// @brief Blocks sharing a memory type, resource kind and strategy
+    struct Pool {
+        uint32_t memoryType = 0;
+        ResourceKind kind = ResourceKind::Buffer;
+        MemoryStrategy strategy = MemoryStrategy::Tlsf;
+        std::vector<std::unique_ptr<MemoryBlock>> blocks;
+    };
+
+    VkDevice device_;
+    VkPhysicalDeviceMemoryProperties memoryProperties_{};
+
+    mutable std::mutex mutex_;
+    std::vector<Pool> pools_;                          // memoryType * 4 + kind * 2 + strategy
+    std::deque<MemoryAllocation> allocations_;         // Stable storage for handed-out records
+    std::vector<MemoryAllocation*> freeAllocations_;
+    std::vector<MemoryAllocation*> dedicated_;
+    uint32_t deviceAllocationCount_ = 0;
+
+    /// @brief Gets the size of new blocks for a memory type
+    VkDeviceSize getBlockSize(uint32_t memoryType) const;
+
+    /// @brief Finds the first memory type allowed by typeBits with the properties
+    uint32_t findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const;
+
+    Pool& getPool(uint32_t memoryType, ResourceKind kind, MemoryStrategy strategy);
+
+    /// @brief Allocates a VkDeviceMemory, mapping it when host-visible
+    VkDeviceMemory allocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, uint8_t*& outMapped);
+    void freeDeviceMemory(VkDeviceMemory memory, uint8_t* mapped);
+
+    /// @brief Places a range in an existing or new block of the pool
+    bool allocateFromPool(Pool& pool, VkDeviceSize size, VkDeviceSize alignment, MemoryAllocation& out);
+
+    /// @brief Places a range in an existing block, skipping one
+    bool placeInBlocks(Pool& pool, VkDeviceSize size, VkDeviceSize alignment, const MemoryBlock* skipped, MemoryAllocation& out);
+
+    /// @brief Releases the empty blocks of a pool, keeping the last one to absorb churn
+    void trimPool(Pool& pool);
+
+    MemoryAllocation* newRecord();
+    void releaseRange(MemoryAllocation& allocation);
+};
+
+} // namespace jelly::graphics::vulkan
@@ -5,61 +5,79 @@
 #include "jelly/core/managed_resource.hpp"
 
 #include "jelly/graphics/mesh.hpp"
+#include "jelly/graphics/vulkan/vulkan_geometry_arena.hpp"
+#include "jelly/graphics/vulkan/vulkan_memory_allocator.hpp"
 
 #include <vulkan/vulkan.h>
 
 namespace jelly::graphics::vulkan {
 
+class VulkanStagingUploader;
+
 /// @brief Vulkan implementation of a renderable mesh
 ///
 /// Manages vertex/index buffers and their associated GPU memory.
+/// Static meshes live in device-local memory filled by the staging uploader;
+/// dynamic meshes are written directly into host-visible memory; shared meshes
+/// take ranges of the geometry arena and own no buffers.
 /// Uses ManagedResource for automatic Vulkan resource cleanup.
 class JELLY_EXPORT VulkanMesh : public Mesh {
 public:
     /// @brief Constructs a Vulkan mesh instance
     /// @param device Logical Vulkan device
-    /// @param physicalDevice Physical Vulkan device
-    VulkanMesh(VkDevice device, VkPhysicalDevice physicalDevice);
+    /// @param allocator Allocator providing the buffer memory
+    VulkanMesh(VkDevice device, VulkanMemoryAllocator* allocator);
     ~VulkanMesh() override;
 
     /// @brief Uploads vertex and index data to GPU
+    ///
+    /// For static meshes the copy is batched and completes before the next frame's draws.
     void upload() override;
 
-    /// @brief Issues draw commands for this mesh
-    void draw() const override;
+    /// @brief Binds the vertex and index buffers (or the arena's) to the current command buffer
+    void bind() const override;
+
+    /// @brief Issues an indexed draw reading per-instance data from the instance stream
+    /// @param instanceCount Number of instances to draw
+    /// @param firstInstance Index of the first instance in the instance stream
+    void drawIndexed(uint32_t instanceCount, uint32_t firstInstance) const override;
 
     /// @brief Releases all Vulkan resources immediately
     void release() override;
 
 private:
     VkDevice device_;
-    VkPhysicalDevice physicalDevice_;
+    VulkanMemoryAllocator* allocator_;
     uint32_t indexCount_{0};
+    GeometryArenaRange arenaRange_{};
 
-    // Managed Vulkan resources
+    // Managed Vulkan resources; memory is declared first so buffers are destroyed before it
+    core::ManagedResource<MemoryAllocation*> vertexMemory_{};
     core::ManagedResource<VkBuffer> vertexBuffer_{};
-    core::ManagedResource<VkDeviceMemory> vertexMemory_{};
+    core::ManagedResource<MemoryAllocation*> indexMemory_{};
     core::ManagedResource<VkBuffer> indexBuffer_{};
-    core::ManagedResource<VkDeviceMemory> indexMemory_{};
+
+    /// @brief Places the mesh in the geometry arena
+    /// @return False if there is no arena or it has no room
+    bool uploadShared(const std::pmr::vector<Vertex>& vertices);
+
+    /// @brief Returns the mesh's arena range, if any, to the arena
+    void releaseShared();
 
     /// @brief Creates a Vulkan buffer with allocated memory
     /// @param size Buffer size in bytes
     /// @param usage Buffer usage flags
     /// @param properties Memory property flags
+    /// @param uploader Uploader whose queue families share the buffer, or nullptr for exclusive access
     /// @param buffer Output buffer handle
-    /// @param memory Output memory handle
+    /// @param memory Output memory allocation
     void createBuffer(
         VkDeviceSize size, VkBufferUsageFlags usage,
         VkMemoryPropertyFlags properties,
+        const VulkanStagingUploader* uploader,
         core::ManagedResource<VkBuffer>& buffer,
-        core::ManagedResource<VkDeviceMemory>& memory
+        core::ManagedResource<MemoryAllocation*>& memory
     );
-
-    /// @brief Finds suitable memory type for allocation
-    /// @param typeFilter Supported memory types
-    /// @param properties Desired memory properties
-    /// @return Index of suitable memory type
-    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 };
 
 } // namespace jelly::graphics::vulkan
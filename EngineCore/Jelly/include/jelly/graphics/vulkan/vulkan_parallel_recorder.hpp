@@ -0,0 +1,102 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jelly::graphics::vulkan {
+
+/// @brief Records secondary command buffers on a fixed set of worker threads.
+///
+/// Every worker owns one command pool per frame in flight, so workers never
+/// share a pool and a frame's pools can be reset as a whole once its fence
+/// has been waited on. Work is handed out as [begin, end) ranges of items.
+class JELLY_EXPORT VulkanParallelRecorder {
+public:
+    /// @brief Callback recording items [begin, end) into the given secondary command buffer
+    using RecordFunction = std::function<void(VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end)>;
+
+    /// @brief Creates the worker threads and their command pools
+    /// @param device Logical Vulkan device
+    /// @param queueFamilyIndex Queue family the secondaries will be executed on
+    /// @param workerCount Number of recording threads
+    /// @param frameCount Number of frames in flight
+    VulkanParallelRecorder(VkDevice device, uint32_t queueFamilyIndex, uint32_t workerCount, uint32_t frameCount);
+    ~VulkanParallelRecorder();
+
+    VulkanParallelRecorder(const VulkanParallelRecorder&) = delete;
+    VulkanParallelRecorder& operator=(const VulkanParallelRecorder&) = delete;
+
+    /// @brief Resets the command pools of a frame whose fence has been signaled
+    /// @param frameIndex Index of the frame in flight being recorded
+    void beginFrame(uint32_t frameIndex);
+
+    /// @brief Splits items across the workers and records one secondary per non-empty range
+    ///
+    /// Blocks until every worker has finished recording.
+    /// @param inheritance Render pass/framebuffer the secondaries continue
+    /// @param itemCount Number of items to record
+    /// @param minItemsPerWorker Smallest range worth handing to a separate worker
+    /// @param record Callback recording a range of items
+    /// @param outCommandBuffers Receives the recorded secondaries in item order
+    void record(
+        const VkCommandBufferInheritanceInfo& inheritance,
+        uint32_t itemCount,
+        uint32_t minItemsPerWorker,
+        const RecordFunction& record,
+        std::vector<VkCommandBuffer>& outCommandBuffers
+    );
+
+    /// @brief Gets the number of recording threads
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(threads_.size()); }
+
+    /// @brief Stops the workers and destroys all command pools
+    void release();
+
+private:
+    struct WorkerFrame {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> buffers; // Freed with the pool
+        size_t used = 0;
+    };
+
+    struct Task {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    };
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    uint32_t currentFrame_ = 0;
+
+    std::vector<std::vector<WorkerFrame>> frames_; // [frame][worker]
+    std::vector<std::thread> threads_;
+    std::vector<Task> tasks_;                      // One slot per worker
+
+    // Dispatch state shared with the workers
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable workDone_;
+    const RecordFunction* currentRecord_ = nullptr;
+    const VkCommandBufferInheritanceInfo* currentInheritance_ = nullptr;
+    uint64_t generation_ = 0;
+    uint32_t pending_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+
+    /// @brief Worker thread main loop
+    void workerLoop(uint32_t workerIndex);
+
+    /// @brief Returns an unused secondary command buffer of a worker for the current frame
+    VkCommandBuffer acquireCommandBuffer(uint32_t workerIndex);
+};
+
+} // namespace jelly::graphics::vulkan
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "jelly/jelly_export.hpp"
+#include "jelly/core/job_system.hpp"
+#include "jelly/core/managed_resource.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace jelly::graphics::vulkan {
+
+class VulkanShader;
+
+/// @brief Rasterization, blend and depth state baked into a graphics pipeline
+struct PipelineStateDesc {
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+    VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    bool blendEnable = false;
+    bool depthTestEnable = true;
+    bool depthWriteEnable = true;
+    VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+
+    bool operator==(const PipelineStateDesc&) const = default;
+};
+
+/// @brief Pipeline and pipeline layout shared by every material with the same key
+struct VulkanPipeline {
+    /// @brief Compilation progress of the pipeline
+    enum class Status : uint8_t {
+        Pending,    // Compiling on a job worker
+        Ready,      // pipeline can be bound
+        Failed      // Compilation threw; the pipeline is never usable
+    };
+
+    jelly::core::ManagedResource<VkPipeline> pipeline; // Valid once the status is Ready
+    jelly::core::ManagedResource<VkPipelineLayout> layout; // Valid once the status is Ready
+    uint32_t id = 0; // Dense index of the pipeline, used in render sort keys
+    std::atomic<Status> status{Status::Pending};
+
+    /// @brief Returns true once the pipeline can be bound
+    bool isReady() const { return status.load(std::memory_order_acquire) == Status::Ready; }
+};
+
+/// @brief Compiles each unique graphics pipeline once and hands out shared references.
+///
+/// Pipelines are keyed by the hashed SPIR-V of the shader stages, the vertex
+/// layout, the render pass and the fixed-function state. Viewport and scissor
+/// are dynamic state set per command buffer, so resizing the swapchain never
+/// invalidates a pipeline. Materials
+/// that only differ by textures or uniforms get the same VulkanPipeline, so they
+/// share one compile, one driver object and one pipeline id.
+///
+/// acquireAsync() returns immediately and creates the layout and the pipeline
+/// on the JobSystem. acquire() creates them on the calling thread. In both
+/// cases the lock is only held to insert the Pending entry, so other lookups
+/// never wait for a driver call.
+///
+/// Shaders built from the same SPIR-V have identically defined descriptor set
+/// layouts, so the pipeline layout made from the first one is compatible with
+/// the descriptor sets of all of them.
+class JELLY_EXPORT VulkanPipelineRegistry {
+public:
+    /// @brief Compiles a fully described pipeline (VulkanGraphicAPI::compileGraphicsPipeline)
+    using CompileFunction = std::function<VkPipeline(const VkGraphicsPipelineCreateInfo&)>;
+
+    /// @param device Logical Vulkan device
+    /// @param compile Function the pipelines are compiled with
+    VulkanPipelineRegistry(VkDevice device, CompileFunction compile);
+
+    /// @brief Waits for the compiles still running
+    ~VulkanPipelineRegistry();
+
+    VulkanPipelineRegistry(const VulkanPipelineRegistry&) = delete;
+    VulkanPipelineRegistry& operator=(const VulkanPipelineRegistry&) = delete;
+
+    /// @brief Returns the pipeline for a shader and state, compiling it on first request
+    /// @param shader Shader providing the stages, vertex layout and descriptor set layout
+    /// @param renderPass Render pass the pipeline draws in (subpass 0)
+    /// @param state Fixed-function state
+    /// @throws jelly::Exception if the layout or the pipeline cannot be created
+    std::shared_ptr<const VulkanPipeline> acquire(
+        const VulkanShader& shader,
+        VkRenderPass renderPass,
+        const PipelineStateDesc& state
+    );
+
+    /// @brief Returns the pipeline for a shader and state, compiling it on a job worker on first request
+    ///
+    /// Falls back to compiling on the calling thread when the JobSystem has no workers.
+    /// The pipeline stays Pending until the job completes; check VulkanPipeline::isReady().
+    /// If an earlier compile of the same key failed, the request starts a new one.
+    /// @param shader Shader kept alive until the compile finishes
+    std::shared_ptr<const VulkanPipeline> acquireAsync(
+        std::shared_ptr<const VulkanShader> shader,
+        VkRenderPass renderPass,
+        const PipelineStateDesc& state
+    );
+
+    /// @brief Blocks until every background compile has finished, helping with queued jobs
+    void waitForCompiles();
+
+    /// @brief Gets the number of distinct pipelines compiled or compiling
+    uint32_t getPipelineCount() const;
+
+    /// @brief Gets the number of acquire() calls, including the ones served by an existing pipeline
+    uint32_t getRequestCount() const;
+
+    /// @brief Waits for pending compiles and drops the registry's references;
+    /// pipelines die with their last material
+    void release();
+
+private:
+    struct Key {
+        size_t vertexHash = 0;
+        size_t fragmentHash = 0;
+        bool instanced = false;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        PipelineStateDesc state;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    VkDevice device_;
+    CompileFunction compile_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable compiled_; // Signalled with mutex_ whenever an entry leaves Pending
+    std::unordered_map<Key, std::shared_ptr<VulkanPipeline>, KeyHash> pipelines_;
+    uint32_t nextId_ = 0;
+    uint32_t requestCount_ = 0;
+    jelly::core::JobCounter pendingCompiles_;
+
+    /// @brief Builds the lookup key of a shader and state
+    static Key makeKey(const VulkanShader& shader, VkRenderPass renderPass, const PipelineStateDesc& state);
+
+    /// @brief Returns true if the compile of an entry threw; such entries are replaced on the next request
+    static bool isFailed(const VulkanPipeline& entry);
+
+    /// @brief Creates a Pending entry with the next pipeline id
+    std::shared_ptr<VulkanPipeline> createEntry();
+
+    /// @brief Creates the layout and compiles the pipeline of an entry, then publishes its status
+    void compile(VulkanPipeline& entry, const VulkanShader& shader, const Key& key);
+
+    /// @brief Runs compile() outside the lock, marks the entry Failed if it throws and wakes the waiters
+    void compileEntry(VulkanPipeline& entry, const VulkanShader& shader, const Key& key);
+};
+
+} // namespace jelly::graphics::vulkan
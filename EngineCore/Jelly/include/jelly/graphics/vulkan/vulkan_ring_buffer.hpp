@@ -0,0 +1,87 @@
+#pragma once
+
+#include "vulkan_memory_allocator.hpp"
+
+#include "jelly/jelly_export.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace jelly::graphics::vulkan {
+
+/// @brief A slice of a ring buffer handed out for the current frame.
+struct RingAllocation {
+    void* data = nullptr;               // Persistently mapped CPU pointer to the slice.
+    VkBuffer buffer = VK_NULL_HANDLE;   // Buffer that owns the slice.
+    VkDeviceSize offset = 0;            // Byte offset of the slice inside the buffer.
+};
+
+/// @brief Persistently-mapped linear allocator with one region per frame in flight.
+///
+/// Every frame in flight owns its own host-visible buffer. Allocations are bumped
+/// linearly inside the region of the current frame and the whole region is recycled
+/// when that frame index comes around again (its fence has been waited on by then).
+class JELLY_EXPORT VulkanRingBuffer {
+public:
+    /// @brief Creates and maps one buffer per frame in flight.
+    /// @param device Logical Vulkan device
+    /// @param allocator Allocator providing the host-visible memory
+    /// @param usage Buffer usage flags (e.g. uniform or vertex buffer)
+    /// @param capacityPerFrame Size in bytes of each per-frame region
+    /// @param alignment Alignment applied to every allocation offset
+    /// @param frameCount Number of frames in flight
+    VulkanRingBuffer(
+        VkDevice device,
+        VulkanMemoryAllocator& allocator,
+        VkBufferUsageFlags usage,
+        VkDeviceSize capacityPerFrame,
+        VkDeviceSize alignment,
+        uint32_t frameCount
+    );
+    ~VulkanRingBuffer();
+
+    VulkanRingBuffer(const VulkanRingBuffer&) = delete;
+    VulkanRingBuffer& operator=(const VulkanRingBuffer&) = delete;
+
+    /// @brief Selects the region of the given frame and rewinds it
+    /// @param frameIndex Index of the frame in flight being recorded
+    void beginFrame(uint32_t frameIndex);
+
+    /// @brief Allocates an aligned slice from the current frame region
+    /// @param size Number of bytes to allocate
+    /// @return Mapped pointer, buffer and offset of the slice
+    /// @throws jelly::Exception if the region is exhausted
+    RingAllocation allocate(VkDeviceSize size);
+
+    /// @brief Gets the buffer backing the region of a frame
+    VkBuffer getBuffer(uint32_t frameIndex) const { return buffers_[frameIndex]; }
+
+    /// @brief Gets the size in bytes of each per-frame region
+    VkDeviceSize getCapacity() const { return capacity_; }
+
+    /// @brief Gets the alignment applied to allocation offsets
+    VkDeviceSize getAlignment() const { return alignment_; }
+
+    /// @brief Gets the number of bytes allocated in the current frame
+    VkDeviceSize getUsedBytes() const { return head_; }
+
+    /// @brief Unmaps and destroys all buffers
+    void release();
+
+private:
+    VkDevice device_ = VK_NULL_HANDLE;
+    VulkanMemoryAllocator* allocator_ = nullptr;
+    VkDeviceSize capacity_ = 0;
+    VkDeviceSize alignment_ = 1;
+    VkDeviceSize head_ = 0;
+    uint32_t currentFrame_ = 0;
+
+    // One region per frame in flight (no RAII yet, destroyed in release())
+    std::vector<VkBuffer> buffers_;
+    std::vector<MemoryAllocation*> allocations_;
+    std::vector<uint8_t*> mapped_;
+};
+
+} // namespace jelly::graphics::vulkan
@@ -59,6 +59,14 @@ public:
     /// @param matrix Pointer to 16 consecutive floats (column-major)
     void setUniformMat4(const char* name, const float* matrix) override;
 
+    /// @brief Whether the vertex shader declares the per-instance model matrix input
+    /// @return True if the shader reads a mat4 at INSTANCE_MATRIX_LOCATION
+    bool supportsInstancing() const override { return supportsInstancing_; }
+
+    /// @brief Copies the staged uniform block into this frame's uniform ring buffer
+    /// @return Dynamic offset of the written slice, passed to vkCmdBindDescriptorSets
+    uint32_t commitUniforms() override;
+
     // Texturess / Descriptors
 
     /// @brief Updates texture binding in descriptor set
@@ -72,7 +80,7 @@ public:
     VkDescriptorSetLayout getDescriptorSetLayout() const;
 
     /// @brief Gets descriptor set for specific frame index
-    /// @param frameIndex Index of the frame (0 to MAX_FRAMES_IN_FLIGHT-1)
+    /// @param frameIndex Index of the frame (wraps around the API's frames in flight)
     /// @return Vulkan descriptor set handle
     VkDescriptorSet getDescriptorSet(uint32_t frameIndex) const;
 
@@ -92,8 +100,10 @@ public:
     /// @brief Gets fragment shader module
     const VulkanShaderModule* getFragmentModule() const;
 
+    /// @brief First vertex input location of the per-instance model matrix (occupies 4 locations)
+    static constexpr uint32_t INSTANCE_MATRIX_LOCATION = 2;
+
 private:
-    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
 
     VulkanGraphicAPI* api_;
     std::unique_ptr<VulkanShaderModule> vertex_;
@@ -102,19 +112,18 @@ private:
     std::vector<uint8_t> cpuUniformData;
     size_t uniformBufferSize = 0;
     std::unordered_map<std::string, size_t> uniformOffsets;
+    bool supportsInstancing_ = false;
 
     std::unordered_map<std::string, uint32_t> samplerBindings;
     std::unordered_map<std::string, uint32_t> textureNameToBinding;
     std::unordered_map<uint32_t, TextureBinding> boundTextures;
 
-    std::array<jelly::core::ManagedResource<VkBuffer>, MAX_FRAMES_IN_FLIGHT> uniformBuffers_;
-    std::array<jelly::core::ManagedResource<VkDeviceMemory>, MAX_FRAMES_IN_FLIGHT> uniformBufferMemories_;
     jelly::core::ManagedResource<VkDescriptorSetLayout> descriptorSetLayout_;
     jelly::core::ManagedResource<VkDescriptorPool> descriptorPool_;
-    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> descriptorSets_{};
+    std::vector<VkDescriptorSet> descriptorSets_; // One per frame in flight
 
+    jelly::core::ManagedResource<MemoryAllocation*> defaultTextureMemory_; // Outlives the image
     jelly::core::ManagedResource<VkImage> defaultTextureImage_;
-    jelly::core::ManagedResource<VkDeviceMemory> defaultTextureMemory_;
     jelly::core::ManagedResource<VkImageView> defaultTextureView_;
     jelly::core::ManagedResource<VkSampler> defaultTextureSampler_;
 
@@ -125,8 +134,8 @@ private:
     /// @param code SPIR-V bytecode to analyze
     void reflectShaderCode(const std::vector<uint8_t>& code);
 
-    /// @brief Creates uniform buffers
-    void createUniformBuffers();
+    /// @brief Detects whether the vertex stage consumes per-instance world matrices
+    void reflectVertexInputs();
 
     /// @brief Creates descriptor set layout  
     void createDescriptorSetLayout();
@@ -142,10 +151,6 @@ private:
 
     /// @brief Updates descriptor sets bindings
     void updateDescriptorSets();
-
-    /// @brief Flushes CPU uniform data to GPU buffer for a specific frame
-    /// @param frameIndex Frame index to update (0 or 1)
-    void flushUniforms(uint32_t frameIndex);
 };
 
 } // namespace jelly::graphics::vulkan
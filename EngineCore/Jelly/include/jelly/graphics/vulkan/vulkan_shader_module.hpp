@@ -33,11 +33,16 @@ public:
     /// @return Reference to the SPIR-V bytecode vector
     const std::vector<uint8_t>& getSPIRVCode() const { return spirvCode_; }
 
+    /// @brief Returns a hash of the SPIR-V bytecode
+    /// @return Equal for modules created from the same bytecode
+    size_t getCodeHash() const { return codeHash_; }
+
 private:
     VkDevice device_;                   // Logical device used for module creation.
     VkShaderModule module_;             // Vulkan shader module handle.
     VkShaderStageFlagBits stage_;       // Shader stage associated with this module.
     std::vector<uint8_t> spirvCode_;    // SPIR-V bytecode vector
+    size_t codeHash_ = 0;               // Hash of spirvCode_, used to deduplicate pipelines
 };
 
 } // namespace jelly::graphics::vulkan
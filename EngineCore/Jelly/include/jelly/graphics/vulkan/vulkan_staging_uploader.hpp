@@ -0,0 +1,114 @@
+#pragma once
+
+#include "vulkan_memory_allocator.hpp"
+
+#include "jelly/jelly_export.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace jelly::graphics::vulkan {
+
+/// @brief Batches copies from host memory into device-local buffers.
+///
+/// upload() copies the data into a persistently-mapped staging chunk and records
+/// the buffer copy into the open batch. flush() submits the whole batch to the
+/// transfer queue at once and returns a semaphore the next graphics submission
+/// must wait on. Staging chunks are recycled once both the batch and the
+/// graphics submission that waited on it have completed.
+///
+/// Destination buffers read on another queue family than the transfer queue
+/// must be created with VK_SHARING_MODE_CONCURRENT (see getQueueFamilyIndices()).
+class JELLY_EXPORT VulkanStagingUploader {
+public:
+    /// @brief Creates the command pool used for transfer batches
+    /// @param device Logical Vulkan device
+    /// @param allocator Allocator providing the staging memory
+    /// @param transferQueue Queue the batches are submitted to
+    /// @param transferFamily Queue family of transferQueue
+    /// @param graphicsFamily Queue family that reads the uploaded buffers
+    VulkanStagingUploader(
+        VkDevice device,
+        VulkanMemoryAllocator& allocator,
+        VkQueue transferQueue,
+        uint32_t transferFamily,
+        uint32_t graphicsFamily
+    );
+    ~VulkanStagingUploader();
+
+    VulkanStagingUploader(const VulkanStagingUploader&) = delete;
+    VulkanStagingUploader& operator=(const VulkanStagingUploader&) = delete;
+
+    /// @brief Schedules a copy of host data into a buffer
+    ///
+    /// The data is copied immediately; the GPU copy happens when the batch is flushed.
+    /// @param dstBuffer Destination buffer created with VK_BUFFER_USAGE_TRANSFER_DST_BIT
+    /// @param data Source bytes
+    /// @param size Number of bytes
+    /// @param dstOffset Byte offset inside dstBuffer
+    void upload(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+
+    /// @brief Submits the pending copies and recycles finished batches
+    /// @param consumerFence Fence of the submission that will wait on the returned semaphore
+    /// @return Semaphore signaled when the copies complete, or VK_NULL_HANDLE if nothing was pending
+    VkSemaphore flush(VkFence consumerFence);
+
+    /// @brief Returns true if the transfer queue belongs to another family than the graphics queue
+    bool usesDedicatedTransferQueue() const { return transferFamily_ != graphicsFamily_; }
+
+    /// @brief Gets the queue families that access uploaded buffers
+    /// @param outCount Receives 1 when both families are the same, 2 otherwise
+    const uint32_t* getQueueFamilyIndices(uint32_t& outCount) const;
+
+    /// @brief Frees all resources
+    /// @note The device must be idle
+    void release();
+
+private:
+    // Staging chunks of this size are recycled; larger uploads get a dedicated chunk
+    static constexpr VkDeviceSize CHUNK_SIZE = 4 * 1024 * 1024;
+
+    struct StagingChunk {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        MemoryAllocation* memory = nullptr;
+        uint8_t* mapped = nullptr;
+        VkDeviceSize size = 0;
+        VkDeviceSize used = 0;
+    };
+
+    struct Batch {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        VkFence consumerFence = VK_NULL_HANDLE; // Owned by the graphics frame
+        std::vector<StagingChunk> chunks;
+    };
+
+    VkDevice device_;
+    VulkanMemoryAllocator& allocator_;
+    VkQueue transferQueue_;
+    uint32_t transferFamily_;
+    uint32_t graphicsFamily_;
+    uint32_t queueFamilies_[2];
+
+    VkCommandPool commandPool_ = VK_NULL_HANDLE;
+
+    std::mutex mutex_;
+    Batch openBatch_;                     // Recording, not submitted yet
+    std::vector<Batch> submittedBatches_; // Waiting for their fence
+    std::vector<StagingChunk> freeChunks_;
+
+    /// @brief Gets a chunk of the open batch with room for size bytes
+    StagingChunk& acquireChunk(VkDeviceSize size);
+
+    /// @brief Frees the resources of batches that are no longer in use
+    /// @param deviceIdle True when the device is known to be idle (shutdown)
+    void recycleFinishedBatches(bool deviceIdle);
+
+    void destroyChunk(StagingChunk& chunk);
+};
+
+} // namespace jelly::graphics::vulkan
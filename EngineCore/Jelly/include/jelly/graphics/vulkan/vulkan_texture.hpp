@@ -50,8 +50,8 @@ private:
     uint32_t width_  = 0;
     uint32_t height_ = 0;
 
+    jelly::core::ManagedResource<MemoryAllocation*> imageMemory_; // Outlives image_
     jelly::core::ManagedResource<VkImage>        image_;
-    jelly::core::ManagedResource<VkDeviceMemory> imageMemory_;
     jelly::core::ManagedResource<VkImageView>    imageView_;
     jelly::core::ManagedResource<VkSampler>      sampler_;
 
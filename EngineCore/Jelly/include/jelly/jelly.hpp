@@ -1,13 +1,18 @@
 #pragma once
 
 #include "jelly/jelly_export.hpp"
+#include "jelly/core/fixed_timestep.hpp"
+#include "jelly/core/frame_pacer.hpp"
 #include "jelly/core/graphic_api_type.hpp"
+#include "jelly/core/render_thread.hpp"
 #include "jelly/core/window_settings.hpp"
 #include "jelly/core/scene_manager.hpp"
 #include "jelly/graphics/graphic_api_interface.hpp"
 #include "jelly/windowing/window_system_interface.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace jelly {
 
@@ -38,33 +43,86 @@ public:
     bool initialize(GraphicAPIType graphicAPIType, const WindowSettings& windowSettings);
 
     ///
-    /// @brief Returns true if the engine is running in headless mode (no graphics or window).
+    /// @brief Returns true if the engine runs without a window.
+    ///
+    /// Either rendering is disabled (GraphicAPIType::NoApi) or frames are rendered
+    /// offscreen (WindowSettings::headless).
     bool isHeadless() const;
 
     /// @brief Returns true if the engine should keep running (i.e., window is still open).
     bool isRunning() const;
 
-    /// @brief Polls input and window events (e.g., keyboard, resize, close).
+    /// @brief Starts a frame and polls input and window events (e.g., keyboard, resize, close).
+    ///
+    /// The frame pacer sleeps here first, so input is sampled as late as possible,
+    /// then the frame time is measured and the main thread's FrameAllocator is reset.
     void pollEvents();
 
     /// @brief Updates all engine systems (scene, physics, etc.) for the current frame.
+    ///
+    /// Runs as many fixedUpdate() steps as the elapsed time allows, blends the
+    /// interpolated transforms between the last two steps, then runs update().
     void update();
 
     /// @brief Renders a single frame (calls beginFrame/endFrame internally).
+    ///
+    /// Render data is first extracted from the scene on the calling thread. With
+    /// WindowSettings::renderThread the frame is then recorded and submitted on the
+    /// render thread and this returns as soon as the previous frame is done, so the
+    /// next update() overlaps with recording.
     void render();
 
+    /// @brief Blocks until the render thread finished the frame in flight.
+    ///
+    /// Call before creating or destroying GPU resources, or touching materials,
+    /// from the main thread while a render thread is running. No-op without one.
+    void waitForRender();
+
+    /// @brief Copies the GPU timings of the latest resolved frame, sampled when a frame completes.
+    /// @return False if GPU timing is unavailable or no frame was resolved yet
+    bool getGpuFrameStats(graphics::GpuFrameStats& stats) const;
+
+    /// @brief Copies the last rendered headless frame as RGBA8 pixels, top row first.
+    ///
+    /// Requires WindowSettings::headless and WindowSettings::frameReadback.
+    /// @return False if no frame is available
+    bool readFrame(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height);
+
     /// @brief Shuts down the engine and releases all resources
     void shutdown();
 
     // Getters
     SceneManager& getSceneManager();
 
+    /// @brief Gets the frame pacer, e.g. to change the target frame rate or read its timings
+    core::FramePacer& getFramePacer();
+
+    /// @brief Gets the fixed step scheduler, e.g. to change the tick rate
+    core::FixedTimestep& getFixedTimestep();
+
 private:
     bool isHeadless_ = false;
     
     std::unique_ptr<WindowSystemInterface> windowSystem_;
     std::unique_ptr<GraphicAPIInterface> graphicAPI_;
     std::unique_ptr<SceneManager> sceneManager_;
+    core::FramePacer framePacer_;
+    core::FixedTimestep fixedTimestep_;
+
+    graphics::GpuFrameStats gpuFrameStats_;
+    bool hasGpuFrameStats_ = false;
+
+    uint64_t frameIndex_ = 0; // Index of the next frame extracted by render()
+
+    // Declared last so it stops before anything it renders with is destroyed
+    core::RenderThread renderThread_;
+
+    /// @brief Records and submits the extracted frame (on the render thread when enabled)
+    /// @param frame Index the frame was extracted with
+    void renderFrame(uint64_t frame);
+
+    /// @brief Publishes the frame timings, samples GPU timings and finishes frame pacing once a frame was submitted
+    void completeFrame();
 };
 
 }
@@ -7,6 +7,9 @@
 
 #include "jelly/windowing/vulkan_native_window_handle_provider.hpp"
 
+#include <atomic>
+#include <thread>
+
 namespace jelly::windowing::glfw {
 
 using jelly::windowing::VulkanNativeWindowHandleProvider;
@@ -16,13 +19,26 @@ class GLFWVulkanWindowSystem :
     public VulkanNativeWindowHandleProvider {
 public:
     void createWindow(const WindowSettings& settings) override;
+    void pollEvents() override;
+
+    /// GLFW may only be queried from the thread that created the window; other
+    /// threads (the render thread) get the size cached by the last pollEvents().
     void getFramebufferSize(uint32_t& width, uint32_t& height) override;
+
+    /// Off the window thread this only sleeps briefly, since that thread keeps polling.
     void waitEvents() override;
     
     void* getNativeWindowHandle() override;
     
     std::vector<const char*> getVulkanRequiredExtensions();
     VkSurfaceKHR createVulkanSurface(VkInstance instance);
+
+private:
+    std::thread::id windowThread_;
+    std::atomic<uint32_t> framebufferWidth_{0};
+    std::atomic<uint32_t> framebufferHeight_{0};
+
+    void cacheFramebufferSize();
 };
 
 }
\ No newline at end of file
@@ -9,6 +9,11 @@ CameraSystem::CameraSystem(entt::registry &registry, float viewportWidth, float
 {
 }
 
+void CameraSystem::declareAccess(SystemAccess& access) const
+{
+    access.reads<Transform>().writes<Camera>();
+}
+
 void CameraSystem::update()
 {
     auto view = registry_.view<Transform, Camera>();
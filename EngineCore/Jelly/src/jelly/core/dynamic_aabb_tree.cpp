@@ -0,0 +1,294 @@
+#include "jelly/core/dynamic_aabb_tree.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace jelly::core {
+
+DynamicAabbTree::DynamicAabbTree(float margin)
+    : margin_(margin) {}
+
+int32_t DynamicAabbTree::createProxy(const BoundingBox& box, uint64_t userData) {
+    const int32_t proxyId = allocateNode();
+
+    nodes_[proxyId].box = box.expanded(margin_);
+    nodes_[proxyId].userData = userData;
+    nodes_[proxyId].height = 0;
+
+    insertLeaf(proxyId);
+    ++proxyCount_;
+    return proxyId;
+}
+
+void DynamicAabbTree::destroyProxy(int32_t proxyId) {
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --proxyCount_;
+}
+
+bool DynamicAabbTree::moveProxy(int32_t proxyId, const BoundingBox& box) {
+    if (nodes_[proxyId].box.contains(box)) return false;
+
+    removeLeaf(proxyId);
+    nodes_[proxyId].box = box.expanded(margin_);
+    insertLeaf(proxyId);
+    return true;
+}
+
+void DynamicAabbTree::clear() {
+    nodes_.clear();
+    root_ = NULL_NODE;
+    freeList_ = NULL_NODE;
+    proxyCount_ = 0;
+}
+
+int32_t DynamicAabbTree::getMaxBalance() const {
+    int32_t maxBalance = 0;
+    for (const Node& node : nodes_) {
+        if (node.height < 1) continue;
+        maxBalance = std::max(maxBalance, std::abs(nodes_[node.child2].height - nodes_[node.child1].height));
+    }
+    return maxBalance;
+}
+
+bool DynamicAabbTree::validate() const {
+    size_t freeCount = 0;
+    for (int32_t index = freeList_; index != NULL_NODE; index = nodes_[index].parent) {
+        if (index < 0 || static_cast<size_t>(index) >= nodes_.size() || nodes_[index].height != -1) return false;
+        if (++freeCount > nodes_.size()) return false;
+    }
+
+    if (root_ == NULL_NODE) {
+        return proxyCount_ == 0 && freeCount == nodes_.size();
+    }
+    if (nodes_[root_].parent != NULL_NODE) return false;
+
+    size_t nodeCount = 0;
+    size_t leafCount = 0;
+
+    NodeStack stack;
+    stack.push(root_);
+    while (!stack.empty()) {
+        const int32_t index = stack.pop();
+        const Node& node = nodes_[index];
+        ++nodeCount;
+
+        if (node.isLeaf()) {
+            if (node.child2 != NULL_NODE || node.height != 0) return false;
+            ++leafCount;
+            continue;
+        }
+
+        const Node& child1 = nodes_[node.child1];
+        const Node& child2 = nodes_[node.child2];
+        if (child1.parent != index || child2.parent != index) return false;
+        if (node.height != 1 + std::max(child1.height, child2.height)) return false;
+        if (!node.box.contains(child1.box) || !node.box.contains(child2.box)) return false;
+
+        stack.push(node.child1);
+        stack.push(node.child2);
+    }
+
+    return leafCount == proxyCount_ && nodeCount + freeCount == nodes_.size();
+}
+
+int32_t DynamicAabbTree::allocateNode() {
+    int32_t index;
+    if (freeList_ != NULL_NODE) {
+        index = freeList_;
+        freeList_ = nodes_[index].parent;
+        nodes_[index] = Node{};
+    } else {
+        index = static_cast<int32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    return index;
+}
+
+void DynamicAabbTree::freeNode(int32_t index) {
+    nodes_[index] = Node{};
+    nodes_[index].parent = freeList_;
+    freeList_ = index;
+}
+
+void DynamicAabbTree::insertLeaf(int32_t leaf) {
+    if (root_ == NULL_NODE) {
+        root_ = leaf;
+        nodes_[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Descend towards the sibling whose merge adds the least surface area
+    const BoundingBox leafBox = nodes_[leaf].box;
+    int32_t index = root_;
+    while (!nodes_[index].isLeaf()) {
+        const Node& node = nodes_[index];
+
+        const float area = node.box.getSurfaceArea();
+        const float combinedArea = node.box.merged(leafBox).getSurfaceArea();
+
+        // Cost of making a new parent for this node and the leaf
+        const float cost = 2.0f * combinedArea;
+
+        // Minimum cost of pushing the leaf further down
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t child) {
+            const Node& childNode = nodes_[child];
+            const float mergedArea = childNode.box.merged(leafBox).getSurfaceArea();
+            return childNode.isLeaf()
+                ? mergedArea + inheritanceCost
+                : mergedArea - childNode.box.getSurfaceArea() + inheritanceCost;
+        };
+
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) break;
+
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const int32_t sibling = index;
+    const int32_t oldParent = nodes_[sibling].parent;
+    const int32_t newParent = allocateNode();
+
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].box = leafBox.merged(nodes_[sibling].box);
+    nodes_[newParent].height = nodes_[sibling].height + 1;
+    nodes_[newParent].child1 = sibling;
+    nodes_[newParent].child2 = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        root_ = newParent;
+    } else if (nodes_[oldParent].child1 == sibling) {
+        nodes_[oldParent].child1 = newParent;
+    } else {
+        nodes_[oldParent].child2 = newParent;
+    }
+
+    // Refit and rebalance the ancestors
+    index = nodes_[leaf].parent;
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        Node& node = nodes_[index];
+        node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+        node.box = nodes_[node.child1].box.merged(nodes_[node.child2].box);
+
+        index = node.parent;
+    }
+}
+
+void DynamicAabbTree::removeLeaf(int32_t leaf) {
+    if (leaf == root_) {
+        root_ = NULL_NODE;
+        return;
+    }
+
+    const int32_t parent = nodes_[leaf].parent;
+    const int32_t grandParent = nodes_[parent].parent;
+    const int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    freeNode(parent);
+
+    if (grandParent == NULL_NODE) {
+        root_ = sibling;
+        nodes_[sibling].parent = NULL_NODE;
+        return;
+    }
+
+    // The sibling takes the place of the removed parent
+    if (nodes_[grandParent].child1 == parent) {
+        nodes_[grandParent].child1 = sibling;
+    } else {
+        nodes_[grandParent].child2 = sibling;
+    }
+    nodes_[sibling].parent = grandParent;
+
+    int32_t index = grandParent;
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        Node& node = nodes_[index];
+        node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+        node.box = nodes_[node.child1].box.merged(nodes_[node.child2].box);
+
+        index = node.parent;
+    }
+}
+
+int32_t DynamicAabbTree::balance(int32_t indexA) {
+    Node& a = nodes_[indexA];
+    if (a.isLeaf() || a.height < 2) return indexA;
+
+    const int32_t indexB = a.child1;
+    const int32_t indexC = a.child2;
+    Node& b = nodes_[indexB];
+    Node& c = nodes_[indexC];
+
+    const int32_t heightDifference = c.height - b.height;
+
+    // Rotate the taller child up, keeping its taller grandchild below it
+    auto rotateUp = [&](int32_t indexUp, Node& up, Node& other, bool upWasChild2) {
+        const int32_t indexF = up.child1;
+        const int32_t indexG = up.child2;
+        Node& f = nodes_[indexF];
+        Node& g = nodes_[indexG];
+
+        up.child1 = indexA;
+        up.parent = a.parent;
+        a.parent = indexUp;
+
+        if (up.parent == NULL_NODE) {
+            root_ = indexUp;
+        } else if (nodes_[up.parent].child1 == indexA) {
+            nodes_[up.parent].child1 = indexUp;
+        } else {
+            nodes_[up.parent].child2 = indexUp;
+        }
+
+        const bool keepF = f.height > g.height;
+        const int32_t indexKept = keepF ? indexF : indexG;
+        const int32_t indexMoved = keepF ? indexG : indexF;
+        Node& kept = keepF ? f : g;
+        Node& moved = keepF ? g : f;
+
+        up.child2 = indexKept;
+        if (upWasChild2) {
+            a.child2 = indexMoved;
+        } else {
+            a.child1 = indexMoved;
+        }
+        moved.parent = indexA;
+
+        a.box = other.box.merged(moved.box);
+        up.box = a.box.merged(kept.box);
+        a.height = 1 + std::max(other.height, moved.height);
+        up.height = 1 + std::max(a.height, kept.height);
+    };
+
+    int32_t indexUp;
+    if (heightDifference > 1) {
+        rotateUp(indexC, c, b, true);
+        indexUp = indexC;
+    } else if (heightDifference < -1) {
+        rotateUp(indexB, b, c, false);
+        indexUp = indexB;
+    } else {
+        return indexA;
+    }
+
+    // A leaf inserted next to a tall subtree leaves the demoted node unbalanced as well
+    Node& up = nodes_[indexUp];
+    if (std::abs(nodes_[a.child2].height - nodes_[a.child1].height) > 1) {
+        balance(indexA);
+        up.height = 1 + std::max(nodes_[up.child1].height, nodes_[up.child2].height);
+        up.box = nodes_[up.child1].box.merged(nodes_[up.child2].box);
+    }
+    return indexUp;
+}
+
+} // namespace jelly::core
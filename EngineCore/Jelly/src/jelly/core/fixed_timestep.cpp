@@ -0,0 +1,38 @@
+#include "jelly/core/fixed_timestep.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace jelly::core {
+
+void FixedTimestep::setTickRate(double ticksPerSecond) {
+    if (ticksPerSecond <= 0.0) return;
+    stepNs_ = std::max<int64_t>(1, static_cast<int64_t>(std::llround(1e9 / ticksPerSecond)));
+    accumulatorNs_ = std::min(accumulatorNs_, stepNs_ - 1);
+}
+
+void FixedTimestep::setMaxStepsPerFrame(uint32_t steps) {
+    maxStepsPerFrame_ = std::max(steps, 1u);
+}
+
+uint32_t FixedTimestep::advance(double elapsedSeconds) {
+    if (elapsedSeconds > 0.0) {
+        accumulatorNs_ += static_cast<int64_t>(std::llround(elapsedSeconds * 1e9));
+    }
+
+    const int64_t available = accumulatorNs_ / stepNs_;
+    const uint32_t steps = static_cast<uint32_t>(std::min<int64_t>(available, maxStepsPerFrame_));
+
+    if (available > steps) {
+        // Keep only the partial step so the next frame starts on time
+        droppedSteps_ += static_cast<uint64_t>(available - steps);
+        accumulatorNs_ %= stepNs_;
+    } else {
+        accumulatorNs_ -= static_cast<int64_t>(steps) * stepNs_;
+    }
+
+    tickCount_ += steps;
+    return steps;
+}
+
+} // namespace jelly::core
@@ -0,0 +1,100 @@
+#include "jelly/core/frame_allocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace jelly::core {
+
+namespace {
+
+constexpr size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}
+
+FrameAllocator::Scope::Scope(FrameAllocator& allocator)
+    : allocator_(allocator), block_(allocator.current_), offset_(allocator.offset_) {}
+
+FrameAllocator::Scope::~Scope() {
+    allocator_.current_ = block_;
+    allocator_.offset_ = offset_;
+}
+
+FrameAllocator::FrameAllocator(size_t blockSize, std::pmr::memory_resource* upstream)
+    : upstream_(upstream), blockSize_(std::max<size_t>(blockSize, BLOCK_ALIGNMENT)) {}
+
+FrameAllocator::~FrameAllocator() {
+    releaseBlocks();
+}
+
+FrameAllocator& FrameAllocator::local() {
+    thread_local FrameAllocator allocator;
+    return allocator;
+}
+
+void FrameAllocator::reset() {
+    // A frame that spilled over several blocks gets one block for all of them,
+    // so the same frame fits without taking more blocks next time
+    if (blocks_.size() > 1) {
+        size_t total = getCapacity();
+        releaseBlocks();
+        blocks_.push_back({ static_cast<std::byte*>(upstream_->allocate(total, BLOCK_ALIGNMENT)), total });
+    }
+
+    current_ = 0;
+    offset_ = 0;
+}
+
+size_t FrameAllocator::getUsedBytes() const {
+    size_t used = offset_;
+    for (size_t i = 0; i < current_; ++i) {
+        used += blocks_[i].size;
+    }
+    return used;
+}
+
+size_t FrameAllocator::getCapacity() const {
+    size_t capacity = 0;
+    for (const Block& block : blocks_) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+void* FrameAllocator::do_allocate(size_t bytes, size_t alignment) {
+    bytes = std::max<size_t>(bytes, 1);
+
+    // Try the current block, then the blocks left over from earlier in the frame
+    for (; current_ < blocks_.size(); ++current_, offset_ = 0) {
+        const Block& block = blocks_[current_];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        size_t begin = alignUp(base + offset_, alignment) - base;
+
+        if (begin + bytes <= block.size) {
+            offset_ = begin + bytes;
+            return block.data + begin;
+        }
+    }
+
+    size_t size = std::max(blockSize_, alignUp(bytes + alignment, BLOCK_ALIGNMENT));
+    blocks_.push_back({ static_cast<std::byte*>(upstream_->allocate(size, BLOCK_ALIGNMENT)), size });
+    current_ = blocks_.size() - 1;
+
+    const Block& block = blocks_[current_];
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+    size_t begin = alignUp(base, alignment) - base;
+    offset_ = begin + bytes;
+    return block.data + begin;
+}
+
+void FrameAllocator::releaseBlocks() {
+    for (const Block& block : blocks_) {
+        upstream_->deallocate(block.data, block.size, BLOCK_ALIGNMENT);
+    }
+    blocks_.clear();
+}
+
+} // namespace jelly::core
@@ -0,0 +1,86 @@
+#include "jelly/core/frame_pacer.hpp"
+
+#include "jelly/core/frame_timings.hpp"
+#include "jelly/core/profiler.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace jelly::core {
+
+namespace {
+
+std::chrono::steady_clock::duration fromMilliseconds(double milliseconds) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(milliseconds));
+}
+
+double toMilliseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+void FramePacer::setTargetFrameRate(double framesPerSecond) {
+    targetIntervalMs_ = framesPerSecond > 0.0 ? 1000.0 / framesPerSecond : 0.0;
+}
+
+void FramePacer::setLowLatency(bool enabled) {
+    lowLatency_ = enabled;
+    slackMs_ = 0.0;
+}
+
+void FramePacer::beginFrame() {
+    const Clock::time_point now = Clock::now();
+    Clock::time_point wakeTime = now;
+
+    if (targetIntervalMs_ > 0.0 && started_) {
+        wakeTime = std::max(wakeTime, frameStart_ + fromMilliseconds(targetIntervalMs_));
+    }
+
+    if (lowLatency_) {
+        const double predictedWaitMs = slackMs_ - LATENCY_MARGIN_MS;
+        if (predictedWaitMs > 0.0) {
+            wakeTime = std::max(wakeTime, now + fromMilliseconds(predictedWaitMs));
+        }
+    }
+
+    if (wakeTime > now) {
+        JELLY_PROFILE_SCOPE("FramePacer::sleep");
+        sleepUntil(wakeTime);
+    }
+
+    frameStart_ = Clock::now();
+    sleepMs_ = toMilliseconds(frameStart_ - now);
+    started_ = true;
+}
+
+void FramePacer::endFrame(double gpuMs) {
+    if (!started_) return;
+
+    const double workMs = toMilliseconds(Clock::now() - frameStart_);
+    const double waitMs = static_cast<double>(FrameTimings::get(FramePhase::Present)) * 1e-6;
+
+    lastStats_.frameMs = sleepMs_ + workMs;
+    lastStats_.sleepMs = sleepMs_;
+    lastStats_.waitMs = waitMs;
+    lastStats_.cpuMs = std::max(0.0, workMs - waitMs);
+    lastStats_.gpuMs = gpuMs;
+
+    // Time the frame did not need the CPU; sleeping it up front moves the wait ahead of input
+    const double slackMs = sleepMs_ + waitMs;
+    slackMs_ += (slackMs - slackMs_) * SMOOTHING;
+}
+
+void FramePacer::sleepUntil(Clock::time_point time) {
+    const Clock::time_point spinStart = time - fromMilliseconds(SPIN_MS);
+    if (Clock::now() < spinStart) {
+        std::this_thread::sleep_until(spinStart);
+    }
+
+    while (Clock::now() < time) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace jelly::core
@@ -0,0 +1,181 @@
+#include "jelly/core/frustum.hpp"
+
+#include "jelly/core/transform_kernels.hpp"
+#include "simd.hpp"
+
+#include <bit>
+#include <cmath>
+
+namespace jelly::core {
+
+namespace {
+
+using Planes = std::array<glm::vec4, Frustum::PlaneCount>;
+
+// === Scalar ===
+
+size_t testBoxesScalar(const Planes& planes, const BoxSoA& b, size_t begin, size_t end, uint8_t* out) {
+    size_t visible = 0;
+    for (size_t i = begin; i < end; ++i) {
+        bool inside = true;
+        for (const glm::vec4& p : planes) {
+            const float distance = p.x * b.centerX[i] + p.y * b.centerY[i] + p.z * b.centerZ[i] + p.w;
+            const float radius = std::abs(p.x) * b.extentX[i] + std::abs(p.y) * b.extentY[i] + std::abs(p.z) * b.extentZ[i];
+            inside &= distance + radius >= 0.0f;
+        }
+        out[i] = inside ? 1 : 0;
+        visible += inside ? 1 : 0;
+    }
+    return visible;
+}
+
+#ifdef JELLY_KERNELS_X86
+
+// === SSE: 4 boxes per iteration ===
+
+JELLY_TARGET_SSE
+size_t testBoxesSSE(const Planes& planes, const BoxSoA& b, size_t count, uint8_t* out) {
+    const __m128 zero = _mm_setzero_ps();
+    size_t visible = 0;
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 cx = _mm_loadu_ps(b.centerX + i);
+        const __m128 cy = _mm_loadu_ps(b.centerY + i);
+        const __m128 cz = _mm_loadu_ps(b.centerZ + i);
+        const __m128 ex = _mm_loadu_ps(b.extentX + i);
+        const __m128 ey = _mm_loadu_ps(b.extentY + i);
+        const __m128 ez = _mm_loadu_ps(b.extentZ + i);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const glm::vec4& p : planes) {
+            __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), cx), _mm_set1_ps(p.w));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(p.y), cy));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(p.z), cz));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(std::abs(p.x)), ex));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(std::abs(p.y)), ey));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(std::abs(p.z)), ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+        }
+
+        const int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; ++k) {
+            out[i + k] = static_cast<uint8_t>((mask >> k) & 1);
+        }
+        visible += static_cast<size_t>(std::popcount(static_cast<unsigned>(mask)));
+    }
+
+    return visible + testBoxesScalar(planes, b, i, count, out);
+}
+
+// === AVX2: 8 boxes per iteration ===
+
+JELLY_TARGET_AVX2
+size_t testBoxesAVX2(const Planes& planes, const BoxSoA& b, size_t count, uint8_t* out) {
+    size_t visible = 0;
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 cx = _mm256_loadu_ps(b.centerX + i);
+        const __m256 cy = _mm256_loadu_ps(b.centerY + i);
+        const __m256 cz = _mm256_loadu_ps(b.centerZ + i);
+        const __m256 ex = _mm256_loadu_ps(b.extentX + i);
+        const __m256 ey = _mm256_loadu_ps(b.extentY + i);
+        const __m256 ez = _mm256_loadu_ps(b.extentZ + i);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const glm::vec4& p : planes) {
+            __m256 d = _mm256_fmadd_ps(_mm256_set1_ps(p.x), cx, _mm256_set1_ps(p.w));
+            d = _mm256_fmadd_ps(_mm256_set1_ps(p.y), cy, d);
+            d = _mm256_fmadd_ps(_mm256_set1_ps(p.z), cz, d);
+            d = _mm256_fmadd_ps(_mm256_set1_ps(std::abs(p.x)), ex, d);
+            d = _mm256_fmadd_ps(_mm256_set1_ps(std::abs(p.y)), ey, d);
+            d = _mm256_fmadd_ps(_mm256_set1_ps(std::abs(p.z)), ez, d);
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        const int mask = _mm256_movemask_ps(inside);
+        for (int k = 0; k < 8; ++k) {
+            out[i + k] = static_cast<uint8_t>((mask >> k) & 1);
+        }
+        visible += static_cast<size_t>(std::popcount(static_cast<unsigned>(mask)));
+    }
+
+    return visible + testBoxesScalar(planes, b, i, count, out);
+}
+
+#endif
+
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection) {
+    // glm is column-major: row r of the matrix is (m[0][r], m[1][r], m[2][r], m[3][r])
+    auto row = [&viewProjection](int r) {
+        return glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+    };
+
+    const glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+    planes_[Left]   = r3 + r0;
+    planes_[Right]  = r3 - r0;
+    planes_[Bottom] = r3 + r1;
+    planes_[Top]    = r3 - r1;
+    planes_[Near]   = r2;      // 0 <= z in Vulkan clip space
+    planes_[Far]    = r3 - r2;
+
+    for (glm::vec4& plane : planes_) {
+        const float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) {
+            plane /= length;
+        }
+    }
+}
+
+bool Frustum::intersects(const BoundingBox& box) const {
+    const glm::vec3 center = box.getCenter();
+    const glm::vec3 extents = box.getExtents();
+
+    for (const glm::vec4& plane : planes_) {
+        const glm::vec3 normal(plane);
+        if (glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), extents) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::contains(const BoundingBox& box) const {
+    const glm::vec3 center = box.getCenter();
+    const glm::vec3 extents = box.getExtents();
+
+    for (const glm::vec4& plane : planes_) {
+        const glm::vec3 normal(plane);
+        if (glm::dot(normal, center) + plane.w - glm::dot(glm::abs(normal), extents) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::intersects(const BoundingSphere& sphere) const {
+    for (const glm::vec4& plane : planes_) {
+        if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t Frustum::testBoxes(const BoxSoA& boxes, size_t count, uint8_t* outVisible) const {
+    if (count == 0) return 0;
+
+    switch (TransformKernels::getSimdLevel()) {
+#ifdef JELLY_KERNELS_X86
+        case SimdLevel::AVX2: return testBoxesAVX2(planes_, boxes, count, outVisible);
+        case SimdLevel::SSE: return testBoxesSSE(planes_, boxes, count, outVisible);
+#endif
+        default: return testBoxesScalar(planes_, boxes, 0, count, outVisible);
+    }
+}
+
+} // namespace jelly::core
@@ -0,0 +1,250 @@
+#include "jelly/core/job_system.hpp"
+
+#include "jelly/core/logger.hpp"
+#include "jelly/core/profiler.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace jelly::core {
+
+namespace {
+
+thread_local uint32_t currentThreadIndex = 0;
+
+}
+
+JobSystem& JobSystem::get() {
+    static JobSystem instance;
+    return instance;
+}
+
+JobSystem::JobSystem() {
+    queues_.push_back(std::make_unique<WorkQueue>());
+}
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+void JobSystem::initialize(uint32_t workerCount) {
+    if (running_.load()) return;
+
+    if (workerCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+
+    running_.store(true);
+
+    threads_.reserve(workerCount);
+    for (uint32_t i = 1; i <= workerCount; ++i) {
+        threads_.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    Logger::Log(LogLevel::Info, "Job system started with " + std::to_string(workerCount) + " worker threads");
+}
+
+void JobSystem::shutdown() {
+    if (!running_.load()) return;
+
+    // Drain what is left so no counter is left waiting
+    while (tryRunJob(currentThreadIndex)) {}
+
+    {
+        std::lock_guard lock(sleepMutex_);
+        running_.store(false);
+    }
+    wakeCondition_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+    queues_.resize(1);
+}
+
+uint32_t JobSystem::getThreadIndex() {
+    return currentThreadIndex;
+}
+
+void JobSystem::schedule(std::function<void()> job, JobCounter* counter) {
+    if (counter) {
+        counter->value_.fetch_add(1, std::memory_order_relaxed);
+    }
+    push({ std::move(job), counter });
+}
+
+void JobSystem::scheduleAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter) {
+    if (counter) {
+        counter->value_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard lock(dependency.mutex_);
+        if (dependency.value_.load(std::memory_order_acquire) != 0) {
+            dependency.continuations_.push_back({ std::move(job), counter });
+            return;
+        }
+    }
+
+    push({ std::move(job), counter });
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+        if (!tryRunJob(currentThreadIndex)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // The last job may still hold the counter lock while releasing continuations
+    std::exception_ptr exception;
+    {
+        std::lock_guard lock(counter.mutex_);
+        exception = std::exchange(counter.exception_, nullptr);
+    }
+
+    if (exception) std::rethrow_exception(exception);
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& body) {
+    if (count == 0) return;
+
+    grainSize = std::max(1u, grainSize);
+    uint32_t threadCount = getThreadCount();
+
+    if (threadCount == 1 || count <= grainSize) {
+        body(0, count);
+        return;
+    }
+
+    // A few chunks per thread so stealing can even out uneven work
+    uint32_t chunkSize = std::max(grainSize, count / (threadCount * 4) + 1);
+
+    JobCounter counter;
+    for (uint32_t begin = chunkSize; begin < count; begin += chunkSize) {
+        uint32_t end = std::min(count, begin + chunkSize);
+        schedule([&body, begin, end] { body(begin, end); }, &counter);
+    }
+
+    // The first chunk runs here instead of idling. The jobs reference this
+    // frame, so they have to finish before an exception leaves it.
+    std::exception_ptr exception;
+    try {
+        body(0, std::min(count, chunkSize));
+    } catch (...) {
+        exception = std::current_exception();
+    }
+
+    wait(counter);
+
+    if (exception) std::rethrow_exception(exception);
+}
+
+void JobSystem::push(Job job) {
+    auto& queue = *queues_[currentThreadIndex];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    queuedJobs_.fetch_add(1, std::memory_order_release);
+
+    if (!threads_.empty()) {
+        // Taking the lock orders the notification after a worker's predicate check
+        std::lock_guard lock(sleepMutex_);
+        wakeCondition_.notify_one();
+    }
+}
+
+bool JobSystem::tryPop(uint32_t threadIndex, Job& outJob) {
+    if (queuedJobs_.load(std::memory_order_acquire) == 0) return false;
+
+    // Newest job of our own queue first
+    {
+        auto& queue = *queues_[threadIndex];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            outJob = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Then steal the oldest job of another queue
+    const size_t queueCount = queues_.size();
+    for (size_t offset = 1; offset < queueCount; ++offset) {
+        auto& queue = *queues_[(threadIndex + offset) % queueCount];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            outJob = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::tryRunJob(uint32_t threadIndex) {
+    Job job;
+    if (!tryPop(threadIndex, job)) return false;
+
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(Job& job) {
+    if (!job.counter) {
+        job.function();
+        return;
+    }
+
+    try {
+        job.function();
+    } catch (...) {
+        std::lock_guard lock(job.counter->mutex_);
+        if (!job.counter->exception_) {
+            job.counter->exception_ = std::current_exception();
+        }
+    }
+
+    finish(*job.counter);
+}
+
+void JobSystem::finish(JobCounter& counter) {
+    std::vector<JobCounter::Continuation> continuations;
+    {
+        std::lock_guard lock(counter.mutex_);
+        if (counter.value_.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        continuations.swap(counter.continuations_);
+    }
+
+    for (auto& continuation : continuations) {
+        push({ std::move(continuation.function), continuation.counter });
+    }
+}
+
+void JobSystem::workerLoop(uint32_t threadIndex) {
+    currentThreadIndex = threadIndex;
+    Profiler::setThreadName("Job Worker " + std::to_string(threadIndex));
+
+    while (true) {
+        if (tryRunJob(threadIndex)) continue;
+
+        std::unique_lock lock(sleepMutex_);
+        wakeCondition_.wait(lock, [this] {
+            return !running_.load() || queuedJobs_.load(std::memory_order_acquire) > 0;
+        });
+
+        if (!running_.load() && queuedJobs_.load(std::memory_order_acquire) == 0) break;
+    }
+}
+
+} // namespace jelly::core
@@ -0,0 +1,65 @@
+#include "jelly/core/pool_allocator.hpp"
+
+#include <algorithm>
+
+namespace jelly::core {
+
+namespace {
+
+constexpr size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+}
+
+PoolAllocator::PoolAllocator(size_t blockSize, size_t blocksPerChunk, std::pmr::memory_resource* upstream)
+    : upstream_(upstream),
+      blockSize_((std::max(blockSize, sizeof(FreeBlock)) + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1)),
+      blocksPerChunk_(std::max<size_t>(blocksPerChunk, 1)) {}
+
+PoolAllocator::~PoolAllocator() {
+    for (void* chunk : chunks_) {
+        upstream_->deallocate(chunk, blockSize_ * blocksPerChunk_, BLOCK_ALIGNMENT);
+    }
+}
+
+void* PoolAllocator::do_allocate(size_t bytes, size_t alignment) {
+    if (!fits(bytes, alignment)) {
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    if (!freeList_) {
+        grow();
+    }
+
+    FreeBlock* block = freeList_;
+    freeList_ = block->next;
+    return block;
+}
+
+void PoolAllocator::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    if (!fits(bytes, alignment)) {
+        upstream_->deallocate(pointer, bytes, alignment);
+        return;
+    }
+
+    auto* block = static_cast<FreeBlock*>(pointer);
+    block->next = freeList_;
+    freeList_ = block;
+}
+
+bool PoolAllocator::fits(size_t bytes, size_t alignment) const {
+    return bytes <= blockSize_ && alignment <= BLOCK_ALIGNMENT;
+}
+
+void PoolAllocator::grow() {
+    auto* chunk = static_cast<std::byte*>(upstream_->allocate(blockSize_ * blocksPerChunk_, BLOCK_ALIGNMENT));
+    chunks_.push_back(chunk);
+
+    // Thread the new blocks in address order so they are handed out sequentially
+    for (size_t i = blocksPerChunk_; i-- > 0;) {
+        auto* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize_);
+        block->next = freeList_;
+        freeList_ = block;
+    }
+}
+
+} // namespace jelly::core
@@ -0,0 +1,163 @@
+#include "jelly/core/profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace jelly::core {
+
+namespace {
+
+struct Zone {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+// Written only by its thread; read by writeChromeTrace() once the capture ended
+struct ThreadBuffer {
+    uint32_t id = 0;
+    std::string name;
+    std::unique_ptr<Zone[]> zones{ new Zone[Profiler::RING_CAPACITY] };
+    std::atomic<uint64_t> written{0};
+};
+
+// Buffers outlive their threads so a capture can still be written after a worker exits
+std::mutex buffersMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+std::atomic<uint64_t> captureStart{0};
+std::atomic<uint64_t> captureEnd{UINT64_MAX};
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+thread_local ThreadBuffer* threadBuffer = nullptr;
+
+// Called with buffersMutex held
+ThreadBuffer& addBuffer() {
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->id = static_cast<uint32_t>(buffers.size());
+    buffers.push_back(std::move(buffer));
+    return *buffers.back();
+}
+
+ThreadBuffer& currentThreadBuffer() {
+    if (!threadBuffer) {
+        std::lock_guard lock(buffersMutex);
+        threadBuffer = &addBuffer();
+    }
+    return *threadBuffer;
+}
+
+void append(ThreadBuffer& buffer, const char* name, uint64_t start, uint64_t end) {
+    const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    buffer.zones[index & (Profiler::RING_CAPACITY - 1)] = Zone{ name, start, end };
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void writeEscaped(FILE* file, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+            std::fputc(*c, file);
+        } else if (static_cast<unsigned char>(*c) >= 0x20) {
+            std::fputc(*c, file);
+        }
+    }
+}
+
+} // namespace
+
+void Profiler::beginCapture() {
+    captureEnd.store(UINT64_MAX, std::memory_order_relaxed);
+    captureStart.store(now(), std::memory_order_relaxed);
+    capturing_.store(true, std::memory_order_release);
+}
+
+void Profiler::endCapture() {
+    capturing_.store(false, std::memory_order_release);
+    captureEnd.store(now(), std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now() {
+    return fromSteadyClock(std::chrono::steady_clock::now());
+}
+
+uint64_t Profiler::fromSteadyClock(std::chrono::steady_clock::time_point time) {
+    if (time < epoch) return 0;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - epoch).count());
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = currentThreadBuffer();
+    std::lock_guard lock(buffersMutex);
+    buffer.name = name;
+}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end) {
+    append(currentThreadBuffer(), name, start, end);
+}
+
+uint32_t Profiler::createTrack(const std::string& name) {
+    std::lock_guard lock(buffersMutex);
+    ThreadBuffer& buffer = addBuffer();
+    buffer.name = name;
+    return buffer.id;
+}
+
+void Profiler::recordOnTrack(uint32_t track, const char* name, uint64_t start, uint64_t end) {
+    ThreadBuffer* buffer;
+    {
+        // The vector may grow while another thread registers
+        std::lock_guard lock(buffersMutex);
+        if (track >= buffers.size()) return;
+        buffer = buffers[track].get();
+    }
+    append(*buffer, name, start, end);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+
+    const uint64_t first = captureStart.load(std::memory_order_relaxed);
+    const uint64_t last = captureEnd.load(std::memory_order_relaxed);
+
+    std::lock_guard lock(buffersMutex);
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    std::fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Jelly\"}}");
+
+    for (const auto& buffer : buffers) {
+        std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", buffer->id);
+        if (buffer->name.empty()) {
+            std::fprintf(file, "Thread %u", buffer->id);
+        } else {
+            writeEscaped(file, buffer->name.c_str());
+        }
+        std::fprintf(file, "\"}}");
+
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        const uint64_t count = std::min<uint64_t>(written, RING_CAPACITY);
+
+        for (uint64_t i = written - count; i < written; ++i) {
+            const Zone& zone = buffer->zones[i & (RING_CAPACITY - 1)];
+            if (zone.start < first || zone.start > last) continue;
+
+            std::fprintf(file, ",\n{\"name\":\"");
+            writeEscaped(file, zone.name);
+            std::fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                buffer->id,
+                static_cast<double>(zone.start - first) / 1000.0,
+                static_cast<double>(zone.end - zone.start) / 1000.0);
+        }
+    }
+
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
+
+} // namespace jelly::core
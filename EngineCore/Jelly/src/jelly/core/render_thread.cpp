@@ -0,0 +1,99 @@
+#include "jelly/core/render_thread.hpp"
+
+#include "jelly/exception.hpp"
+#include "jelly/core/profiler.hpp"
+
+namespace jelly::core {
+
+RenderThread::~RenderThread() {
+    // Errors of the last frame can no longer be reported
+    try {
+        stop();
+    } catch (...) {
+    }
+}
+
+void RenderThread::start() {
+    if (thread_.joinable()) {
+        throw Exception("Render thread already started");
+    }
+
+    stopping_ = false;
+    thread_ = std::thread(&RenderThread::run, this);
+}
+
+void RenderThread::stop() {
+    if (!thread_.joinable()) return;
+
+    {
+        std::unique_lock lock(mutex_);
+        frameDone_.wait(lock, [this] { return !busy_; });
+        stopping_ = true;
+    }
+    frameReady_.notify_one();
+    thread_.join();
+
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+void RenderThread::submit(std::function<void()> frame) {
+    {
+        std::lock_guard lock(mutex_);
+        if (busy_) {
+            throw Exception("Render thread still busy with the previous frame");
+        }
+        frame_ = std::move(frame);
+        busy_ = true;
+    }
+    frameReady_.notify_one();
+}
+
+void RenderThread::wait() {
+    std::unique_lock lock(mutex_);
+    frameDone_.wait(lock, [this] { return !busy_; });
+
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+bool RenderThread::waitFor(std::chrono::milliseconds timeout) {
+    std::unique_lock lock(mutex_);
+    if (!frameDone_.wait_for(lock, timeout, [this] { return !busy_; })) {
+        return false;
+    }
+
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+    return true;
+}
+
+void RenderThread::run() {
+    Profiler::setThreadName("Render Thread");
+
+    std::unique_lock lock(mutex_);
+    while (true) {
+        frameReady_.wait(lock, [this] { return busy_ || stopping_; });
+        if (!busy_) return;
+
+        std::function<void()> frame = std::move(frame_);
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            frame();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        error_ = error;
+        busy_ = false;
+        frameDone_.notify_all();
+    }
+}
+
+} // namespace jelly::core
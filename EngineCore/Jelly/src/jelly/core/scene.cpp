@@ -1,9 +1,37 @@
 #include "jelly/core/scene.hpp"
 
+#include "jelly/core/interpolated_transform.hpp"
+#include "jelly/core/job_system.hpp"
+#include "jelly/core/profiler.hpp"
+#include "jelly/core/transform.hpp"
+
+#include <algorithm>
+#include <exception>
 #include <iostream>
 
 namespace jelly::core {
 
+namespace {
+
+TransformState captureState(const Transform& transform) {
+    return { transform.localPosition, transform.localRotation, transform.localScale };
+}
+
+void applyState(Transform& transform, const TransformState& state) {
+    if (transform.localPosition == state.position &&
+        transform.localRotation == state.rotation &&
+        transform.localScale == state.scale) {
+        return;
+    }
+
+    transform.localPosition = state.position;
+    transform.localRotation = state.rotation;
+    transform.localScale = state.scale;
+    transform.markChanged();
+}
+
+} // namespace
+
 Scene::Scene(std::string name)
     : name_(std::move(name)) {}
 
@@ -20,6 +48,7 @@ void Scene::addGameSystem(std::shared_ptr<GameSystemInterface> system) {
         if (gs == system) return;
     }
     gameSystems_.push_back(std::move(system));
+    systemBatchesDirty_ = true;
 }
 
 void Scene::initialize() {
@@ -29,20 +58,59 @@ void Scene::initialize() {
 }
 
 void Scene::update() {
-    for (const auto& system : gameSystems_) {
-        system->update();
-    }
+    JELLY_PROFILE_SCOPE("Scene::update");
+    runSystemBatches(&GameSystemInterface::update);
 }
 
 void Scene::fixedUpdate() {
+    JELLY_PROFILE_SCOPE("Scene::fixedUpdate");
+
+    auto interpolated = registry_.view<Transform, InterpolatedTransform>();
+
+    // Systems step from the last simulated state, never from a blended one
+    interpolated.each([](Transform& transform, InterpolatedTransform& states) {
+        if (!states.initialized) {
+            states.current = captureState(transform);
+            states.initialized = true;
+        }
+        applyState(transform, states.current);
+        states.previous = states.current;
+    });
+
+    runSystemBatches(&GameSystemInterface::fixedUpdate);
+
+    interpolated.each([](Transform& transform, InterpolatedTransform& states) {
+        states.current = captureState(transform);
+    });
+}
+
+void Scene::interpolateTransforms(float alpha) {
+    JELLY_PROFILE_SCOPE("Scene::interpolateTransforms");
+
+    registry_.view<Transform, InterpolatedTransform>().each([alpha](Transform& transform, InterpolatedTransform& states) {
+        if (!states.initialized) return;
+
+        const TransformState& from = states.previous;
+        const TransformState& to = states.current;
+
+        TransformState blended;
+        blended.position = glm::mix(from.position, to.position, alpha);
+        blended.rotation = glm::slerp(from.rotation, to.rotation, alpha);
+        blended.scale = glm::mix(from.scale, to.scale, alpha);
+        applyState(transform, blended);
+    });
+}
+
+void Scene::extractRenderData(uint64_t frame) {
+    JELLY_PROFILE_SCOPE("Scene::extractRenderData");
     for (const auto& system : gameSystems_) {
-        system->fixedUpdate();
+        system->extractRenderData(frame);
     }
 }
 
-void Scene::render() {
+void Scene::render(uint64_t frame) {
     for (const auto& system : gameSystems_) {
-        system->render();
+        system->render(frame);
     }
 }
 
@@ -52,4 +120,66 @@ void Scene::shutdown() {
     }
 }
 
+void Scene::buildSystemBatches() {
+    systemBatches_.clear();
+
+    std::vector<SystemAccess> batchAccess;
+    for (const auto& system : gameSystems_) {
+        SystemAccess access;
+        system->declareAccess(access);
+        access.prepare(registry_);
+
+        // Only consecutive systems are merged so conflicting ones keep their order
+        bool fits = !systemBatches_.empty() && std::none_of(batchAccess.begin(), batchAccess.end(),
+            [&access](const SystemAccess& other) { return access.conflictsWith(other); });
+
+        if (!fits) {
+            systemBatches_.emplace_back();
+            batchAccess.clear();
+        }
+
+        systemBatches_.back().systems.push_back(system.get());
+        batchAccess.push_back(std::move(access));
+    }
+
+    systemBatchesDirty_ = false;
+}
+
+void Scene::runSystemBatches(void (GameSystemInterface::*callback)()) {
+    if (systemBatchesDirty_) {
+        buildSystemBatches();
+    }
+
+    auto& jobSystem = JobSystem::get();
+
+    for (const auto& batch : systemBatches_) {
+        if (batch.systems.size() == 1 || jobSystem.getWorkerCount() == 0) {
+            for (auto* system : batch.systems) {
+                (system->*callback)();
+            }
+            continue;
+        }
+
+        JobCounter counter;
+        for (size_t i = 1; i < batch.systems.size(); ++i) {
+            auto* system = batch.systems[i];
+            // The member pointer is captured by reference so std::function stores the job inline
+            jobSystem.schedule([system, &callback] { (system->*callback)(); }, &counter);
+        }
+
+        // The counter has to outlive the scheduled systems even if this one throws.
+        // wait() rethrows the first error of the scheduled ones.
+        std::exception_ptr error;
+        try {
+            (batch.systems.front()->*callback)();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        jobSystem.wait(counter);
+
+        if (error) std::rethrow_exception(error);
+    }
+}
+
 }
@@ -45,8 +45,16 @@ void SceneManager::fixedUpdate() {
     if (currentScene_) currentScene_->fixedUpdate();
 }
 
-void SceneManager::renderActiveScene() {
-    if (currentScene_) currentScene_->render();
+void SceneManager::interpolateActiveScene(float alpha) {
+    if (currentScene_) currentScene_->interpolateTransforms(alpha);
+}
+
+void SceneManager::extractActiveScene(uint64_t frame) {
+    if (currentScene_) currentScene_->extractRenderData(frame);
+}
+
+void SceneManager::renderActiveScene(uint64_t frame) {
+    if (currentScene_) currentScene_->render(frame);
 }
 
 void SceneManager::shutdownActiveScene() {
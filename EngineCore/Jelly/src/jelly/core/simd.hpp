@@ -0,0 +1,21 @@
+#pragma once
+
+// Internal to the engine sources: instruction set selection for the SIMD kernels.
+//
+// On x86 the kernels of every level are compiled into the same binary, each
+// function tagged with the instruction set it needs, and TransformKernels
+// picks one at runtime from what the CPU supports. Other targets only have
+// the scalar versions.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define JELLY_KERNELS_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define JELLY_TARGET_SSE
+        #define JELLY_TARGET_AVX2
+    #else
+        #define JELLY_TARGET_SSE __attribute__((target("sse2")))
+        #define JELLY_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#endif
@@ -0,0 +1,162 @@
+#include "jelly/core/spatial_index_system.hpp"
+
+#include <algorithm>
+
+namespace jelly::core {
+
+SpatialIndexSystem::SpatialIndexSystem(entt::registry& registry, const TransformSystem& transformSystem, float margin)
+    : registry_(registry), transformSystem_(transformSystem), tree_(margin)
+{
+    for (auto entity : registry_.view<SpatialBounds, Transform>()) {
+        pending_.push_back(entity);
+    }
+
+    registry_.on_construct<SpatialBounds>().connect<&SpatialIndexSystem::onBoundsChanged>(this);
+    registry_.on_update<SpatialBounds>().connect<&SpatialIndexSystem::onBoundsChanged>(this);
+    registry_.on_destroy<SpatialBounds>().connect<&SpatialIndexSystem::onBoundsOrTransformDestroy>(this);
+    registry_.on_destroy<Transform>().connect<&SpatialIndexSystem::onBoundsOrTransformDestroy>(this);
+}
+
+SpatialIndexSystem::~SpatialIndexSystem() {
+    registry_.on_construct<SpatialBounds>().disconnect(this);
+    registry_.on_update<SpatialBounds>().disconnect(this);
+    registry_.on_destroy<SpatialBounds>().disconnect(this);
+    registry_.on_destroy<Transform>().disconnect(this);
+}
+
+void SpatialIndexSystem::declareAccess(SystemAccess& access) const {
+    access.reads<Transform>().writes<SpatialBounds>();
+}
+
+void SpatialIndexSystem::update() {
+    for (auto entity : pending_) {
+        if (registry_.valid(entity)) {
+            refresh(entity);
+        }
+    }
+    pending_.clear();
+
+    for (auto entity : transformSystem_.getChangedEntities()) {
+        if (proxyOf(entity) != DynamicAabbTree::NULL_NODE || registry_.all_of<SpatialBounds>(entity)) {
+            refresh(entity);
+        }
+    }
+}
+
+void SpatialIndexSystem::queryFrustum(const Frustum& frustum, std::vector<entt::entity>& outEntities) const {
+    tree_.query(frustum, [&](int32_t proxyId) {
+        entt::entity entity = entityOf(tree_.getUserData(proxyId));
+        if (frustum.intersects(proxies_[entt::to_entity(entity)].worldBox)) {
+            outEntities.push_back(entity);
+        }
+        return true;
+    });
+}
+
+void SpatialIndexSystem::queryOverlap(const BoundingBox& box, std::vector<entt::entity>& outEntities) const {
+    tree_.query(box, [&](int32_t proxyId) {
+        entt::entity entity = entityOf(tree_.getUserData(proxyId));
+        if (box.overlaps(proxies_[entt::to_entity(entity)].worldBox)) {
+            outEntities.push_back(entity);
+        }
+        return true;
+    });
+}
+
+void SpatialIndexSystem::queryRadius(const glm::vec3& center, float radius, std::vector<entt::entity>& outEntities) const {
+    const BoundingBox searchBox{ center - glm::vec3(radius), center + glm::vec3(radius) };
+    const float radiusSquared = radius * radius;
+
+    tree_.query(searchBox, [&](int32_t proxyId) {
+        entt::entity entity = entityOf(tree_.getUserData(proxyId));
+        const BoundingBox& worldBox = proxies_[entt::to_entity(entity)].worldBox;
+
+        const glm::vec3 offset = glm::clamp(center, worldBox.min, worldBox.max) - center;
+        if (glm::dot(offset, offset) <= radiusSquared) {
+            outEntities.push_back(entity);
+        }
+        return true;
+    });
+}
+
+std::optional<RaycastHit> SpatialIndexSystem::raycast(const Ray& ray, float maxDistance) const {
+    std::optional<RaycastHit> closest;
+
+    tree_.rayCast(ray, maxDistance, [&](int32_t proxyId, float currentMax) {
+        entt::entity entity = entityOf(tree_.getUserData(proxyId));
+
+        float distance = 0.0f;
+        if (!proxies_[entt::to_entity(entity)].worldBox.intersects(ray, currentMax, distance)) {
+            return currentMax;
+        }
+
+        closest = RaycastHit{ entity, distance };
+        // A hit at the origin cannot be beaten
+        return distance > 0.0f ? distance : 0.0f;
+    });
+
+    return closest;
+}
+
+const BoundingBox* SpatialIndexSystem::getWorldBox(entt::entity entity) const {
+    if (proxyOf(entity) == DynamicAabbTree::NULL_NODE) return nullptr;
+    return &proxies_[entt::to_entity(entity)].worldBox;
+}
+
+int32_t SpatialIndexSystem::proxyOf(entt::entity entity) const {
+    const uint32_t slot = entt::to_entity(entity);
+    if (slot >= proxies_.size()) return DynamicAabbTree::NULL_NODE;
+
+    const int32_t proxyId = proxies_[slot].id;
+    // The slot may belong to an older version of the entity
+    if (proxyId == DynamicAabbTree::NULL_NODE || entityOf(tree_.getUserData(proxyId)) != entity) {
+        return DynamicAabbTree::NULL_NODE;
+    }
+    return proxyId;
+}
+
+entt::entity SpatialIndexSystem::entityOf(uint64_t userData) {
+    return static_cast<entt::entity>(userData);
+}
+
+void SpatialIndexSystem::refresh(entt::entity entity) {
+    const auto* bounds = registry_.try_get<SpatialBounds>(entity);
+    const auto* transform = registry_.try_get<Transform>(entity);
+    if (!bounds || !transform) {
+        remove(entity);
+        return;
+    }
+
+    const BoundingBox worldBox = bounds->localBox.transformed(transform->worldMatrix);
+
+    const uint32_t slot = entt::to_entity(entity);
+    if (slot >= proxies_.size()) {
+        proxies_.resize(slot + 1);
+    }
+
+    const int32_t proxyId = proxyOf(entity);
+    if (proxyId == DynamicAabbTree::NULL_NODE) {
+        proxies_[slot].id = tree_.createProxy(worldBox, static_cast<uint64_t>(entt::to_integral(entity)));
+    } else {
+        tree_.moveProxy(proxyId, worldBox);
+    }
+    proxies_[slot].worldBox = worldBox;
+}
+
+void SpatialIndexSystem::remove(entt::entity entity) {
+    const int32_t proxyId = proxyOf(entity);
+    if (proxyId == DynamicAabbTree::NULL_NODE) return;
+
+    tree_.destroyProxy(proxyId);
+    proxies_[entt::to_entity(entity)].id = DynamicAabbTree::NULL_NODE;
+}
+
+void SpatialIndexSystem::onBoundsChanged(entt::registry& /*registry*/, entt::entity entity) {
+    pending_.push_back(entity);
+}
+
+void SpatialIndexSystem::onBoundsOrTransformDestroy(entt::registry& /*registry*/, entt::entity entity) {
+    remove(entity);
+}
+
+} // namespace jelly::core
@@ -0,0 +1,31 @@
+#include "jelly/core/system_access.hpp"
+
+#include <algorithm>
+
+namespace jelly::core {
+
+namespace {
+
+bool intersects(const std::vector<entt::id_type>& lhs, const std::vector<entt::id_type>& rhs) {
+    return std::any_of(lhs.begin(), lhs.end(), [&rhs](entt::id_type id) {
+        return std::find(rhs.begin(), rhs.end(), id) != rhs.end();
+    });
+}
+
+}
+
+bool SystemAccess::conflictsWith(const SystemAccess& other) const {
+    if (!isDeclared() || !other.isDeclared()) return true;
+
+    return intersects(writes_, other.writes_)
+        || intersects(writes_, other.reads_)
+        || intersects(reads_, other.writes_);
+}
+
+void SystemAccess::prepare(entt::registry& registry) const {
+    for (auto prepareFunction : prepareFunctions_) {
+        prepareFunction(registry);
+    }
+}
+
+} // namespace jelly::core
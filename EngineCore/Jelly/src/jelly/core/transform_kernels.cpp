@@ -0,0 +1,354 @@
+#include "jelly/core/transform_kernels.hpp"
+#include "simd.hpp"
+
+#include <atomic>
+
+namespace jelly::core {
+
+namespace {
+
+// === Scalar ===
+
+void composeScalar(const TransformSoA& t, size_t begin, size_t end, float* out) {
+    for (size_t i = begin; i < end; ++i) {
+        const float x = t.rotationX[i], y = t.rotationY[i], z = t.rotationZ[i], w = t.rotationW[i];
+        const float sx = t.scaleX[i], sy = t.scaleY[i], sz = t.scaleZ[i];
+
+        const float xx = x * x, yy = y * y, zz = z * z;
+        const float xy = x * y, xz = x * z, yz = y * z;
+        const float wx = w * x, wy = w * y, wz = w * z;
+
+        float* m = out + i * 16;
+        m[0]  = (1.0f - 2.0f * (yy + zz)) * sx;
+        m[1]  = 2.0f * (xy + wz) * sx;
+        m[2]  = 2.0f * (xz - wy) * sx;
+        m[3]  = 0.0f;
+        m[4]  = 2.0f * (xy - wz) * sy;
+        m[5]  = (1.0f - 2.0f * (xx + zz)) * sy;
+        m[6]  = 2.0f * (yz + wx) * sy;
+        m[7]  = 0.0f;
+        m[8]  = 2.0f * (xz + wy) * sz;
+        m[9]  = 2.0f * (yz - wx) * sz;
+        m[10] = (1.0f - 2.0f * (xx + yy)) * sz;
+        m[11] = 0.0f;
+        m[12] = t.positionX[i];
+        m[13] = t.positionY[i];
+        m[14] = t.positionZ[i];
+        m[15] = 1.0f;
+    }
+}
+
+void multiplyScalar(const float* a, const float* b, float* out) {
+    float result[16];
+    for (int col = 0; col < 4; ++col) {
+        for (int row = 0; row < 4; ++row) {
+            result[col * 4 + row] = a[row]      * b[col * 4]
+                                  + a[4 + row]  * b[col * 4 + 1]
+                                  + a[8 + row]  * b[col * 4 + 2]
+                                  + a[12 + row] * b[col * 4 + 3];
+        }
+    }
+    for (int i = 0; i < 16; ++i) out[i] = result[i];
+}
+
+void multiplyBatchScalar(const float* lhs, const float* rhs, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        multiplyScalar(lhs + i * 16, rhs + i * 16, out + i * 16);
+    }
+}
+
+#ifdef JELLY_KERNELS_X86
+
+// === SSE: 4 transforms per iteration ===
+
+JELLY_TARGET_SSE
+void composeSSE(const TransformSoA& t, size_t count, float* out) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 x = _mm_loadu_ps(t.rotationX + i);
+        const __m128 y = _mm_loadu_ps(t.rotationY + i);
+        const __m128 z = _mm_loadu_ps(t.rotationZ + i);
+        const __m128 w = _mm_loadu_ps(t.rotationW + i);
+        const __m128 sx = _mm_loadu_ps(t.scaleX + i);
+        const __m128 sy = _mm_loadu_ps(t.scaleY + i);
+        const __m128 sz = _mm_loadu_ps(t.scaleZ + i);
+
+        const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        // Rows hold one matrix element for four transforms; transposing yields columns
+        __m128 c0[4] = {
+            _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+            zero
+        };
+        __m128 c1[4] = {
+            _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+            _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+            zero
+        };
+        __m128 c2[4] = {
+            _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+            _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+            zero
+        };
+        __m128 c3[4] = {
+            _mm_loadu_ps(t.positionX + i),
+            _mm_loadu_ps(t.positionY + i),
+            _mm_loadu_ps(t.positionZ + i),
+            one
+        };
+
+        __m128* columns[4] = { c0, c1, c2, c3 };
+        for (int col = 0; col < 4; ++col) {
+            __m128* c = columns[col];
+            _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+            for (int k = 0; k < 4; ++k) {
+                _mm_storeu_ps(out + (i + k) * 16 + col * 4, c[k]);
+            }
+        }
+    }
+
+    composeScalar(t, i, count, out);
+}
+
+JELLY_TARGET_SSE
+void multiplySSE(const float* a, const float* b, float* out) {
+    const __m128 a0 = _mm_loadu_ps(a);
+    const __m128 a1 = _mm_loadu_ps(a + 4);
+    const __m128 a2 = _mm_loadu_ps(a + 8);
+    const __m128 a3 = _mm_loadu_ps(a + 12);
+
+    // Load every column of b first so out may alias b
+    __m128 bc[4] = { _mm_loadu_ps(b), _mm_loadu_ps(b + 4), _mm_loadu_ps(b + 8), _mm_loadu_ps(b + 12) };
+
+    for (int col = 0; col < 4; ++col) {
+        const __m128 v = bc[col];
+        __m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+        _mm_storeu_ps(out + col * 4, r);
+    }
+}
+
+JELLY_TARGET_SSE
+void multiplyBatchSSE(const float* lhs, const float* rhs, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        multiplySSE(lhs + i * 16, rhs + i * 16, out + i * 16);
+    }
+}
+
+// === AVX2: 8 transforms per iteration ===
+
+JELLY_TARGET_AVX2
+inline void transposeStoreAVX2(__m256 r0, __m256 r1, __m256 r2, __m256 r3, float* out, size_t first, int col) {
+    // 4x4 transpose inside each 128-bit lane: low lanes hold transforms first..first+3, high lanes first+4..first+7
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+    const __m256 o[4] = {
+        _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)),
+        _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)),
+        _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+        _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2))
+    };
+
+    for (int k = 0; k < 4; ++k) {
+        _mm_storeu_ps(out + (first + k) * 16 + col * 4, _mm256_castps256_ps128(o[k]));
+        _mm_storeu_ps(out + (first + k + 4) * 16 + col * 4, _mm256_extractf128_ps(o[k], 1));
+    }
+}
+
+JELLY_TARGET_AVX2
+void composeAVX2(const TransformSoA& t, size_t count, float* out) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 x = _mm256_loadu_ps(t.rotationX + i);
+        const __m256 y = _mm256_loadu_ps(t.rotationY + i);
+        const __m256 z = _mm256_loadu_ps(t.rotationZ + i);
+        const __m256 w = _mm256_loadu_ps(t.rotationW + i);
+        const __m256 sx = _mm256_loadu_ps(t.scaleX + i);
+        const __m256 sy = _mm256_loadu_ps(t.scaleY + i);
+        const __m256 sz = _mm256_loadu_ps(t.scaleZ + i);
+
+        const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+        const __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+        const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+        transposeStoreAVX2(
+            _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+            zero, out, i, 0);
+
+        transposeStoreAVX2(
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+            _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+            zero, out, i, 1);
+
+        transposeStoreAVX2(
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+            _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz),
+            zero, out, i, 2);
+
+        transposeStoreAVX2(
+            _mm256_loadu_ps(t.positionX + i),
+            _mm256_loadu_ps(t.positionY + i),
+            _mm256_loadu_ps(t.positionZ + i),
+            one, out, i, 3);
+    }
+
+    composeScalar(t, i, count, out);
+}
+
+JELLY_TARGET_AVX2
+inline __m256 duplicateLanesAVX2(const float* v) {
+    const __m128 lane = _mm_loadu_ps(v);
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lane), lane, 1);
+}
+
+JELLY_TARGET_AVX2
+void multiplyBatchAVX2(const float* lhs, const float* rhs, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const float* a = lhs + i * 16;
+        const float* b = rhs + i * 16;
+        float* o = out + i * 16;
+
+        // Each lhs column duplicated in both lanes; two result columns per iteration
+        const __m256 a0 = duplicateLanesAVX2(a);
+        const __m256 a1 = duplicateLanesAVX2(a + 4);
+        const __m256 a2 = duplicateLanesAVX2(a + 8);
+        const __m256 a3 = duplicateLanesAVX2(a + 12);
+
+        const __m256 b01 = _mm256_loadu_ps(b);
+        const __m256 b23 = _mm256_loadu_ps(b + 8);
+
+        __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0)));
+        r01 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1)), r01);
+        r01 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2)), r01);
+        r01 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3)), r01);
+
+        __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0)));
+        r23 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1)), r23);
+        r23 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2)), r23);
+        r23 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3)), r23);
+
+        _mm256_storeu_ps(o, r01);
+        _mm256_storeu_ps(o + 8, r23);
+    }
+}
+
+#endif // JELLY_KERNELS_X86
+
+SimdLevel detectSimdLevel() {
+#if defined(JELLY_KERNELS_X86) && defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    // The OS must save the YMM registers on context switches
+    const bool ymmEnabled = osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+
+    __cpuidex(info, 7, 0);
+    const bool avx2 = (info[1] & (1 << 5)) != 0;
+
+    if (ymmEnabled && avx2 && fma) return SimdLevel::AVX2;
+    if (sse2) return SimdLevel::SSE;
+    return SimdLevel::Scalar;
+#elif defined(JELLY_KERNELS_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE;
+    return SimdLevel::Scalar;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+const SimdLevel supportedLevel = detectSimdLevel();
+std::atomic<SimdLevel> activeLevel{ supportedLevel };
+
+} // namespace
+
+SimdLevel TransformKernels::getSimdLevel() {
+    return activeLevel.load(std::memory_order_relaxed);
+}
+
+SimdLevel TransformKernels::getSupportedSimdLevel() {
+    return supportedLevel;
+}
+
+void TransformKernels::setSimdLevel(SimdLevel level) {
+    activeLevel.store(level > supportedLevel ? supportedLevel : level, std::memory_order_relaxed);
+}
+
+const char* TransformKernels::getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE: return "SSE";
+        default: return "Scalar";
+    }
+}
+
+void TransformKernels::composeLocalMatrices(const TransformSoA& transforms, size_t count, glm::mat4* outLocal) {
+    if (count == 0) return;
+
+    float* out = &outLocal[0][0][0];
+
+    switch (getSimdLevel()) {
+#ifdef JELLY_KERNELS_X86
+        case SimdLevel::AVX2: composeAVX2(transforms, count, out); return;
+        case SimdLevel::SSE: composeSSE(transforms, count, out); return;
+#endif
+        default: composeScalar(transforms, 0, count, out); return;
+    }
+}
+
+void TransformKernels::multiplyMatrices(const glm::mat4* lhs, const glm::mat4* rhs, glm::mat4* out, size_t count) {
+    if (count == 0) return;
+
+    const float* a = &lhs[0][0][0];
+    const float* b = &rhs[0][0][0];
+    float* o = &out[0][0][0];
+
+    switch (getSimdLevel()) {
+#ifdef JELLY_KERNELS_X86
+        case SimdLevel::AVX2: multiplyBatchAVX2(a, b, o, count); return;
+        case SimdLevel::SSE: multiplyBatchSSE(a, b, o, count); return;
+#endif
+        default: multiplyBatchScalar(a, b, o, count); return;
+    }
+}
+
+void TransformKernels::multiply(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out) {
+#ifdef JELLY_KERNELS_X86
+    // A single pair gains nothing from 256-bit lanes
+    if (getSimdLevel() != SimdLevel::Scalar) {
+        multiplySSE(&lhs[0][0], &rhs[0][0], &out[0][0]);
+        return;
+    }
+#endif
+    multiplyScalar(&lhs[0][0], &rhs[0][0], &out[0][0]);
+}
+
+} // namespace jelly::core
@@ -1,38 +1,495 @@
 #include "jelly/core/transform_system.hpp"
 
+#include "jelly/exception.hpp"
+#include "jelly/core/frame_timings.hpp"
+#include "jelly/core/job_system.hpp"
+#include "jelly/core/profiler.hpp"
+#include "jelly/core/transform_kernels.hpp"
+
+#include <algorithm>
+
 namespace jelly::core {
 
 TransformSystem::TransformSystem(entt::registry& registry)
     : registry_(registry)
 {
+    // Mirror whatever hierarchy already exists, parents before children
+    std::vector<std::pair<entt::entity, uint32_t>> stack;
+
+    auto appendSubtree = [&](entt::entity root) {
+        stack.push_back({ root, 0 });
+        nodes_.push_back(Node{ root, entt::null, 1 });
+        reindex(static_cast<uint32_t>(nodes_.size() - 1), static_cast<uint32_t>(nodes_.size()));
+
+        while (!stack.empty()) {
+            auto& [entity, cursor] = stack.back();
+            auto* hierarchy = registry_.try_get<Hierarchy>(entity);
+
+            if (!hierarchy || cursor >= hierarchy->children.size()) {
+                uint32_t index = indexOf(entity);
+                nodes_[index].subtreeSize = static_cast<uint32_t>(nodes_.size()) - index;
+                stack.pop_back();
+                continue;
+            }
+
+            entt::entity child = hierarchy->children[cursor++];
+            if (!registry_.all_of<Transform>(child) || indexOf(child) != INVALID_INDEX) continue;
+
+            nodes_.push_back(Node{ child, entity, 1 });
+            reindex(static_cast<uint32_t>(nodes_.size() - 1), static_cast<uint32_t>(nodes_.size()));
+            stack.push_back({ child, 0 });
+        }
+    };
+
+    auto view = registry_.view<Transform>();
+    for (auto entity : view) {
+        auto* hierarchy = registry_.try_get<Hierarchy>(entity);
+        bool isRoot = !hierarchy || hierarchy->parent == entt::null ||
+                      !registry_.all_of<Transform>(hierarchy->parent);
+        if (isRoot) appendSubtree(entity);
+    }
+
+    // Anything left over belongs to a broken parent chain; treat it as a root
+    for (auto entity : view) {
+        if (indexOf(entity) == INVALID_INDEX) appendSubtree(entity);
+    }
+
+    for (auto entity : view) {
+        link(entity, view.get<Transform>(entity));
+    }
+
+    registry_.on_construct<Transform>().connect<&TransformSystem::onTransformConstruct>(this);
+    registry_.on_destroy<Transform>().connect<&TransformSystem::onTransformDestroy>(this);
+    registry_.on_construct<Hierarchy>().connect<&TransformSystem::onHierarchyChanged>(this);
+    registry_.on_update<Hierarchy>().connect<&TransformSystem::onHierarchyChanged>(this);
+}
+
+TransformSystem::~TransformSystem() {
+    registry_.view<Transform>().each([](Transform& transform) {
+        transform.changeLink.queue_ = nullptr;
+    });
+
+    registry_.on_construct<Transform>().disconnect(this);
+    registry_.on_destroy<Transform>().disconnect(this);
+    registry_.on_construct<Hierarchy>().disconnect(this);
+    registry_.on_update<Hierarchy>().disconnect(this);
+}
+
+void TransformSystem::declareAccess(SystemAccess& access) const {
+    access.reads<Hierarchy>().writes<Transform>();
 }
 
 void TransformSystem::update() {
-    auto view = registry_.view<Transform>();
-    for (auto e : view) {
-        auto& t = view.get<Transform>(e);
+    JELLY_PROFILE_SCOPE("TransformSystem::update");
+    ScopedFrameTiming timing(FramePhase::Transform);
+    auto& storage = registry_.storage<Transform>();
+
+    for (auto entity : changedLastUpdate_) {
+        if (storage.contains(entity)) {
+            storage.get(entity).hasWorldMatrixChanged = false;
+        }
+    }
+    changedLastUpdate_.clear();
+
+    compact();
+
+    // Collect the roots of every subtree that needs its world matrices rebuilt
+    dirtyRoots_.clear();
+    for (auto entity : forcedDirty_) {
+        uint32_t index = indexOf(entity);
+        if (index != INVALID_INDEX) dirtyRoots_.push_back(index);
+    }
+    forcedDirty_.clear();
+
+    // Entries of destroyed entities, or of a flag another subtree already cleared, are dropped
+    changedEntities_.clear();
+    changeQueue_.drain(changedEntities_);
+    for (auto entity : changedEntities_) {
+        uint32_t index = indexOf(entity);
+        if (index != INVALID_INDEX && storage.get(entity).hasTransformValuesChanged) {
+            dirtyRoots_.push_back(index);
+        }
+    }
+
+    if (dirtyRoots_.empty()) return;
+
+    // Subtree ranges are either nested or disjoint, so merging sorted starts keeps the outermost ones
+    std::sort(dirtyRoots_.begin(), dirtyRoots_.end());
+
+    dirtyRanges_.clear();
+    uint32_t dirtyNodeCount = 0;
+    for (uint32_t index : dirtyRoots_) {
+        if (!dirtyRanges_.empty() && index < dirtyRanges_.back().second) continue;
+
+        uint32_t end = index + nodes_[index].subtreeSize;
+        dirtyRanges_.push_back({ index, end });
+        dirtyNodeCount += end - index;
+    }
+
+    auto& jobSystem = JobSystem::get();
+    uint32_t threadCount = jobSystem.getThreadCount();
+    if (dirtyRanges_.size() == 1 || dirtyNodeCount < MIN_PARALLEL_NODES || threadCount == 1) {
+        for (auto [first, last] : dirtyRanges_) {
+            updateRange(first, last);
+        }
+    } else {
+        // Independent subtrees are split into contiguous groups of roughly equal node count
+        uint32_t nodesPerGroup = std::max(MIN_PARALLEL_NODES, dirtyNodeCount / threadCount + 1);
+        JobCounter counter;
+
+        size_t groupBegin = 0;
+        uint32_t groupNodes = 0;
+        for (size_t i = 0; i < dirtyRanges_.size(); ++i) {
+            groupNodes += dirtyRanges_[i].second - dirtyRanges_[i].first;
+
+            if (groupNodes >= nodesPerGroup || i + 1 == dirtyRanges_.size()) {
+                // 32-bit bounds keep the capture small enough for std::function to store inline
+                jobSystem.schedule([this, begin = static_cast<uint32_t>(groupBegin), end = static_cast<uint32_t>(i + 1)] {
+                    for (uint32_t r = begin; r < end; ++r) {
+                        updateRange(dirtyRanges_[r].first, dirtyRanges_[r].second);
+                    }
+                }, &counter);
+                groupBegin = i + 1;
+                groupNodes = 0;
+            }
+        }
+
+        jobSystem.wait(counter);
+    }
+
+    for (auto [first, last] : dirtyRanges_) {
+        for (uint32_t i = first; i < last; ++i) {
+            changedLastUpdate_.push_back(nodes_[i].entity);
+        }
+    }
+}
+
+void TransformSystem::updateRange(uint32_t first, uint32_t last) {
+    auto& storage = registry_.storage<Transform>();
+
+    // Transforms of the range, so children find their parent without a registry lookup
+    thread_local std::vector<Transform*> transforms;
+    thread_local std::vector<Transform*> dirtyLocals;
+    thread_local LocalBatch batch;
+
+    transforms.resize(last - first);
+    dirtyLocals.clear();
+    batch.clear();
+
+    for (uint32_t i = first; i < last; ++i) {
+        Transform& t = storage.get(nodes_[i].entity);
+        transforms[i - first] = &t;
+
         if (t.hasTransformValuesChanged) {
-            t.rebuildLocalMatrix();
+            dirtyLocals.push_back(&t);
+            batch.push(t);
             t.hasTransformValuesChanged = false;
         }
     }
-    
-    auto rootView = registry_.view<Transform>(entt::exclude<Hierarchy>);
-    for (auto e : rootView) {
-        propagateWorldMatrix(e, glm::mat4(1.0f));
+
+    // Local matrices of the range are rebuilt in one SIMD batch
+    batch.matrices.resize(dirtyLocals.size());
+    TransformKernels::composeLocalMatrices(batch.view(), dirtyLocals.size(), batch.matrices.data());
+    for (size_t i = 0; i < dirtyLocals.size(); ++i) {
+        dirtyLocals[i]->localMatrix = batch.matrices[i];
+    }
+
+    const Node& firstNode = nodes_[first];
+    const Transform* outerParent = firstNode.parent != entt::null ? &storage.get(firstNode.parent) : nullptr;
+
+    for (uint32_t i = first; i < last; ++i) {
+        const Node& node = nodes_[i];
+        Transform& t = *transforms[i - first];
+
+        if (node.parent == entt::null) {
+            t.worldMatrix = t.localMatrix;
+        } else {
+            uint32_t parentIndex = indexOf(node.parent);
+            const Transform* parent = parentIndex >= first ? transforms[parentIndex - first] : outerParent;
+            TransformKernels::multiply(parent->worldMatrix, t.localMatrix, t.worldMatrix);
+        }
+
+        t.hasWorldMatrixChanged = true;
     }
 }
 
-void TransformSystem::propagateWorldMatrix(entt::entity entity, const glm::mat4& parentWorld) {
-    auto& t = registry_.get<Transform>(entity);
-    t.worldMatrix = parentWorld * t.localMatrix;
+void TransformSystem::setParent(entt::entity child, entt::entity parent) {
+    if (!registry_.all_of<Transform>(child)) {
+        throw Exception("TransformSystem::setParent: child has no Transform");
+    }
+    if (parent != entt::null && !registry_.all_of<Transform>(parent)) {
+        throw Exception("TransformSystem::setParent: parent has no Transform");
+    }
+
+    entt::entity oldParent = entt::null;
+    if (auto* hierarchy = registry_.try_get<Hierarchy>(child)) {
+        oldParent = hierarchy->parent;
+    }
+
+    // Validates the new parent before any component is touched
+    moveSubtree(child, parent);
+
+    if (oldParent != entt::null) {
+        if (auto* oldHierarchy = registry_.try_get<Hierarchy>(oldParent)) {
+            auto& children = oldHierarchy->children;
+            children.erase(std::remove(children.begin(), children.end(), child), children.end());
+        }
+    }
 
-    if (auto* h = registry_.try_get<Hierarchy>(entity)) {
-        for (auto child : h->children) {
-            propagateWorldMatrix(child, t.worldMatrix);
+    if (parent != entt::null) {
+        if (auto* parentHierarchy = registry_.try_get<Hierarchy>(parent)) {
+            auto& children = parentHierarchy->children;
+            if (std::find(children.begin(), children.end(), child) == children.end()) {
+                children.push_back(child);
+            }
+        } else {
+            registry_.emplace<Hierarchy>(parent, Hierarchy{ entt::null, { child } });
         }
     }
+
+    if (auto* hierarchy = registry_.try_get<Hierarchy>(child)) {
+        hierarchy->parent = parent;
+    } else {
+        registry_.emplace<Hierarchy>(child, Hierarchy{ parent, {} });
+    }
+}
+
+void TransformSystem::LocalBatch::clear() {
+    positionX.clear(); positionY.clear(); positionZ.clear();
+    rotationX.clear(); rotationY.clear(); rotationZ.clear(); rotationW.clear();
+    scaleX.clear(); scaleY.clear(); scaleZ.clear();
+}
+
+void TransformSystem::LocalBatch::push(const Transform& transform) {
+    positionX.push_back(transform.localPosition.x);
+    positionY.push_back(transform.localPosition.y);
+    positionZ.push_back(transform.localPosition.z);
+    rotationX.push_back(transform.localRotation.x);
+    rotationY.push_back(transform.localRotation.y);
+    rotationZ.push_back(transform.localRotation.z);
+    rotationW.push_back(transform.localRotation.w);
+    scaleX.push_back(transform.localScale.x);
+    scaleY.push_back(transform.localScale.y);
+    scaleZ.push_back(transform.localScale.z);
+}
+
+TransformSoA TransformSystem::LocalBatch::view() const {
+    return TransformSoA{
+        positionX.data(), positionY.data(), positionZ.data(),
+        rotationX.data(), rotationY.data(), rotationZ.data(), rotationW.data(),
+        scaleX.data(), scaleY.data(), scaleZ.data()
+    };
 }
 
+void TransformChangeQueue::push(entt::entity entity) {
+    Bucket& bucket = buckets_[JobSystem::getThreadIndex() % BUCKET_COUNT];
+    std::lock_guard lock(bucket.mutex);
+    bucket.entities.push_back(entity);
+}
+
+void TransformChangeQueue::drain(std::vector<entt::entity>& out) {
+    for (Bucket& bucket : buckets_) {
+        std::lock_guard lock(bucket.mutex);
+        out.insert(out.end(), bucket.entities.begin(), bucket.entities.end());
+        bucket.entities.clear();
+    }
+}
+
+uint32_t TransformSystem::indexOf(entt::entity entity) const {
+    auto id = static_cast<size_t>(entt::to_entity(entity));
+    if (id >= nodeIndices_.size()) return INVALID_INDEX;
+
+    uint32_t index = nodeIndices_[id];
+    if (index == INVALID_INDEX || nodes_[index].entity != entity) return INVALID_INDEX;
+    return index;
+}
+
+void TransformSystem::reindex(uint32_t first, uint32_t last) {
+    for (uint32_t i = first; i < last; ++i) {
+        auto id = static_cast<size_t>(entt::to_entity(nodes_[i].entity));
+        if (id >= nodeIndices_.size()) {
+            nodeIndices_.resize(id + 1, INVALID_INDEX);
+        }
+        nodeIndices_[id] = i;
+    }
+}
+
+void TransformSystem::compact() {
+    if (tombstoneCount_ == 0) return;
+
+    const auto count = static_cast<uint32_t>(nodes_.size());
+
+    // Every live node joins the tree of its root. Keeping the array order within
+    // each tree keeps its subtrees contiguous, with parents first.
+    compactRoots_.resize(count);
+    compactOffsets_.assign(count, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        const Node& node = nodes_[i];
+        if (node.entity == entt::null) continue;
+
+        compactRoots_[i] = node.parent == entt::null ? i : compactRoots_[indexOf(node.parent)];
+        ++compactOffsets_[compactRoots_[i]];
+    }
+
+    // Trees keep the order of their roots
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (nodes_[i].entity == entt::null || compactRoots_[i] != i) continue;
+
+        uint32_t size = compactOffsets_[i];
+        compactOffsets_[i] = offset;
+        offset += size;
+    }
+
+    compactNodes_.resize(offset);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (nodes_[i].entity == entt::null) continue;
+
+        Node& node = compactNodes_[compactOffsets_[compactRoots_[i]]++];
+        node = nodes_[i];
+        node.subtreeSize = 1;
+    }
+
+    nodes_.swap(compactNodes_);
+    reindex(0, offset);
+
+    // Children come after their parent, so a backward pass accumulates complete subtrees
+    for (uint32_t i = offset; i-- > 0;) {
+        if (nodes_[i].parent != entt::null) {
+            nodes_[indexOf(nodes_[i].parent)].subtreeSize += nodes_[i].subtreeSize;
+        }
+    }
+
+    tombstoneCount_ = 0;
+}
+
+void TransformSystem::link(entt::entity entity, Transform& transform) {
+    transform.changeLink.queue_ = &changeQueue_;
+    transform.changeLink.entity_ = entity;
+
+    if (transform.hasTransformValuesChanged) {
+        changeQueue_.push(entity);
+    }
+}
+
+void TransformSystem::adjustAncestorSizes(entt::entity parent, int64_t delta) {
+    for (entt::entity ancestor = parent; ancestor != entt::null;) {
+        Node& node = nodes_[indexOf(ancestor)];
+        node.subtreeSize = static_cast<uint32_t>(node.subtreeSize + delta);
+        ancestor = node.parent;
+    }
+}
+
+void TransformSystem::moveSubtree(entt::entity child, entt::entity parent) {
+    // Subtree sizes are only exact without tombstones
+    compact();
+
+    uint32_t index = indexOf(child);
+    if (index == INVALID_INDEX || nodes_[index].parent == parent) return;
+
+    uint32_t parentIndex = INVALID_INDEX;
+    if (parent != entt::null) {
+        parentIndex = indexOf(parent);
+        if (parentIndex == INVALID_INDEX) {
+            throw Exception("TransformSystem: parent entity has no Transform");
+        }
+
+        for (entt::entity ancestor = parent; ancestor != entt::null; ancestor = nodes_[indexOf(ancestor)].parent) {
+            if (ancestor == child) {
+                throw Exception("TransformSystem: cannot parent an entity to itself or its descendant");
+            }
+        }
+    }
+
+    const uint32_t size = nodes_[index].subtreeSize;
+
+    // Destination in current positions: right after the new parent's subtree, or the end
+    const uint32_t destination = parentIndex == INVALID_INDEX
+        ? static_cast<uint32_t>(nodes_.size())
+        : parentIndex + nodes_[parentIndex].subtreeSize;
+
+    adjustAncestorSizes(nodes_[index].parent, -static_cast<int64_t>(size));
+    nodes_[index].parent = parent;
+    adjustAncestorSizes(parent, size);
+
+    auto begin = nodes_.begin();
+    if (destination > index + size) {
+        std::rotate(begin + index, begin + index + size, begin + destination);
+        reindex(index, destination);
+    } else if (destination < index) {
+        std::rotate(begin + destination, begin + index, begin + index + size);
+        reindex(destination, index + size);
+    }
+
+    forcedDirty_.push_back(child);
+}
+
+void TransformSystem::onTransformConstruct(entt::registry& registry, entt::entity entity) {
+    nodes_.push_back(Node{ entity, entt::null, 1 });
+    reindex(static_cast<uint32_t>(nodes_.size() - 1), static_cast<uint32_t>(nodes_.size()));
+    link(entity, registry.get<Transform>(entity));
+
+    if (auto* hierarchy = registry.try_get<Hierarchy>(entity)) {
+        if (hierarchy->parent != entt::null && registry.all_of<Transform>(hierarchy->parent)) {
+            moveSubtree(entity, hierarchy->parent);
+        }
+    }
+}
+
+void TransformSystem::onTransformDestroy(entt::registry& registry, entt::entity entity) {
+    uint32_t index = indexOf(entity);
+    if (index == INVALID_INDEX) return;
+
+    // Children become roots. Their subtrees stay inside the range of the
+    // tombstone until compact() moves them out; stepping over each child's
+    // subtree visits the direct children only.
+    const uint32_t end = index + nodes_[index].subtreeSize;
+    for (uint32_t i = index + 1; i < end; i += nodes_[i].subtreeSize) {
+        Node& child = nodes_[i];
+        if (child.entity == entt::null) continue;
+
+        child.parent = entt::null;
+        forcedDirty_.push_back(child.entity);
+
+        if (auto* hierarchy = registry.try_get<Hierarchy>(child.entity)) {
+            hierarchy->parent = entt::null;
+        }
+    }
+
+    entt::entity parent = nodes_[index].parent;
+    if (parent != entt::null) {
+        if (auto* parentHierarchy = registry.try_get<Hierarchy>(parent)) {
+            auto& children = parentHierarchy->children;
+            children.erase(std::remove(children.begin(), children.end(), entity), children.end());
+        }
+    }
+
+    // Tombstone keeps its subtree size, so ancestor ranges stay valid until compact()
+    nodes_[index].entity = entt::null;
+    nodes_[index].parent = entt::null;
+    nodeIndices_[static_cast<size_t>(entt::to_entity(entity))] = INVALID_INDEX;
+    ++tombstoneCount_;
+}
+
+void TransformSystem::onHierarchyChanged(entt::registry& registry, entt::entity entity) {
+    entt::entity parent = registry.get<Hierarchy>(entity).parent;
+
+    if (parent != entt::null && !registry.all_of<Transform>(parent)) {
+        parent = entt::null;
+    }
+
+    moveSubtree(entity, parent);
+
+    if (parent == entt::null) return;
+
+    if (auto* parentHierarchy = registry.try_get<Hierarchy>(parent)) {
+        auto& children = parentHierarchy->children;
+        if (std::find(children.begin(), children.end(), entity) == children.end()) {
+            children.push_back(entity);
+        }
+    } else {
+        registry.emplace<Hierarchy>(parent, Hierarchy{ entt::null, { entity } });
+    }
+}
 
 } // namespace jelly::core
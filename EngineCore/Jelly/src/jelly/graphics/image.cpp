@@ -1,6 +1,7 @@
 #include "jelly/graphics/image.hpp"
 #include <fstream>
 #include <stdexcept>
+#include <utility>
 
 namespace jelly::graphics {
 
@@ -29,4 +30,15 @@ Image::Image(const std::string& path) {
     }
 }
 
+Image::Image(uint32_t width, uint32_t height, std::vector<uint8_t> pixels)
+    : width_(width), height_(height), pixels_(std::move(pixels)) {
+    if (width_ == 0 || height_ == 0) {
+        throw std::runtime_error("Imagem inválida (dimensões zero).");
+    }
+
+    if (pixels_.size() != static_cast<size_t>(width_) * static_cast<size_t>(height_) * 4) {
+        throw std::runtime_error("Tamanho dos dados de pixel não corresponde às dimensões.");
+    }
+}
+
 } // namespace jelly::graphics
@@ -0,0 +1,12 @@
+#include "jelly/graphics/material.hpp"
+
+#include <atomic>
+
+namespace jelly::graphics {
+
+uint32_t MaterialInterface::nextId() {
+    static std::atomic<uint32_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace jelly::graphics
@@ -1,4 +1,5 @@
 #include "jelly/graphics/material_factory.hpp"
+#include "jelly/core/profiler.hpp"
 
 #include <stdexcept>
 
@@ -8,11 +9,20 @@ std::vector<std::weak_ptr<MaterialInterface>> MaterialFactory::materials_;
 std::mutex MaterialFactory::mutex_;
 
 MaterialHandle MaterialFactory::create(std::shared_ptr<ShaderInterface> shader) {
+    return createMaterial(std::move(shader), false);
+}
+
+MaterialHandle MaterialFactory::createAsync(std::shared_ptr<ShaderInterface> shader) {
+    return createMaterial(std::move(shader), true);
+}
+
+MaterialHandle MaterialFactory::createMaterial(std::shared_ptr<ShaderInterface> shader, bool async) {
+    JELLY_PROFILE_SCOPE("MaterialFactory::create");
     switch (GraphicContext::get().getAPIType()) {
         case core::GraphicAPIType::Vulkan: {
             auto material = std::make_shared<vulkan::VulkanMaterial>(shader);
             auto api = static_cast<vulkan::VulkanGraphicAPI*>(GraphicContext::get().getAPI());
-            material->createPipeline(api);
+            material->createPipeline(api, async);
             registerMaterial(material);
             return material;
         }
@@ -21,6 +31,23 @@ MaterialHandle MaterialFactory::create(std::shared_ptr<ShaderInterface> shader)
     }
 }
 
+void MaterialFactory::recreatePipelines() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    switch (GraphicContext::get().getAPIType()) {
+        case core::GraphicAPIType::Vulkan: {
+            auto api = static_cast<vulkan::VulkanGraphicAPI*>(GraphicContext::get().getAPI());
+            for (auto& weakMat : materials_) {
+                if (auto mat = weakMat.lock()) {
+                    static_cast<vulkan::VulkanMaterial*>(mat.get())->createPipeline(api);
+                }
+            }
+            break;
+        }
+        default:
+            throw std::runtime_error("Unsupported graphics API in MaterialFactory");
+    }
+}
+
 void MaterialFactory::releaseAll() {
     std::lock_guard<std::mutex> lock(mutex_);
     for (auto& weakMat : materials_) {
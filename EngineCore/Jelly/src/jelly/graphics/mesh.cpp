@@ -1,9 +1,21 @@
 #include "jelly/graphics/mesh.hpp"
 
+#include <atomic>
+
 namespace jelly::graphics {
 
-std::vector<Vertex> Mesh::buildVertexBuffer() const {
-    std::vector<Vertex> vertices;
+uint32_t Mesh::nextId() {
+    static std::atomic<uint32_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Mesh::computeBounds() {
+    boundingBox_ = core::BoundingBox::fromPoints(positions_);
+    boundingSphere_ = core::BoundingSphere::fromPoints(positions_, boundingBox_);
+}
+
+std::pmr::vector<Vertex> Mesh::buildVertexBuffer(std::pmr::memory_resource* memory) const {
+    std::pmr::vector<Vertex> vertices(memory);
     vertices.reserve(positions_.size());
 
     for (size_t i = 0; i < positions_.size(); i++) {
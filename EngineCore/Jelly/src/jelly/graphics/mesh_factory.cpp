@@ -1,4 +1,5 @@
 #include "jelly/graphics/mesh_factory.hpp"
+#include "jelly/core/profiler.hpp"
 
 #include <stdexcept>
 
@@ -7,13 +8,14 @@ namespace jelly::graphics {
 std::vector<std::weak_ptr<Mesh>> MeshFactory::meshes_;
 std::mutex MeshFactory::mutex_;
 
-MeshHandle MeshFactory::createMeshHandle() {
+MeshHandle MeshFactory::createMeshHandle(MeshUsage usage) {
     auto& context = GraphicContext::get();
     switch (context.getAPIType()) {
         case core::GraphicAPIType::Vulkan: {
             auto api = static_cast<vulkan::VulkanGraphicAPI*>(context.getAPI());
             auto mesh = std::make_shared<vulkan::VulkanMesh>(
-                api->getDevice(), api->getPhysicalDevice());
+                api->getDevice(), api->getMemoryAllocator());
+            mesh->setUsage(usage);
             registerMesh(mesh);
             return mesh;
         }
@@ -24,7 +26,8 @@ MeshHandle MeshFactory::createMeshHandle() {
 
 MeshHandle MeshFactory::quad()
 {
-    auto mesh = createMeshHandle();
+    JELLY_PROFILE_SCOPE("MeshFactory::quad");
+    auto mesh = createMeshHandle(MeshUsage::Shared);
 
     mesh->setPositions({
         {-0.5f, -0.5f, 0.0f}, // bottom-left
@@ -52,7 +55,8 @@ MeshHandle MeshFactory::quad()
 
 MeshHandle MeshFactory::cube()
 {
-    auto mesh = createMeshHandle();
+    JELLY_PROFILE_SCOPE("MeshFactory::cube");
+    auto mesh = createMeshHandle(MeshUsage::Shared);
 
     std::vector<glm::vec3> positions = {
         // Front face
@@ -1,32 +1,332 @@
 #include "jelly/graphics/mesh_renderer_system.hpp"
+#include "jelly/graphics/graphic_context.hpp"
+#include "jelly/core/frame_timings.hpp"
+#include "jelly/core/job_system.hpp"
+#include "jelly/core/profiler.hpp"
+
 #include <glm/gtc/type_ptr.hpp>
 
+#include <atomic>
+#include <cstring>
+
 namespace jelly::graphics {
 
 MeshRendererSystem::MeshRendererSystem(entt::registry& registry)
     : registry_(registry) {}
 
-void MeshRendererSystem::render() {
-    auto view = registry_.view<MeshComponent, MaterialComponent, core::Transform>();
-    auto camView = registry_.view<core::Camera, core::Transform>();
+void MeshRendererSystem::declareAccess(core::SystemAccess& access) const {
+    access.reads<MeshComponent, MaterialComponent, core::Transform, core::Camera>();
+    if (spatialIndex_) {
+        access.reads<core::SpatialBounds>();
+    }
+}
+
+void MeshRendererSystem::CandidateBounds::resize(size_t count) {
+    for (auto* values : { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ }) {
+        values->resize(count);
+    }
+}
+
+core::BoxSoA MeshRendererSystem::CandidateBounds::view(size_t offset) const {
+    return {
+        centerX.data() + offset, centerY.data() + offset, centerZ.data() + offset,
+        extentX.data() + offset, extentY.data() + offset, extentZ.data() + offset
+    };
+}
+
+void MeshRendererSystem::RenderSnapshot::clear() {
+    for (size_t i = 0; i < batchCount; ++i) {
+        batches[i].worldMatrices.clear();
+        batches[i].mesh.reset();
+        batches[i].material.reset();
+    }
+    batchLookup.clear();
+    batchCount = 0;
+    hasCamera = false;
+    indexedCount = 0;
+}
+
+MeshRendererSystem::RenderSnapshot::Batch& MeshRendererSystem::RenderSnapshot::acquireBatch(
+    const MeshHandle& mesh, const std::shared_ptr<MaterialInterface>& material, bool preculled) {
+    auto [it, inserted] = batchLookup.try_emplace(BatchKey{ mesh.get(), material.get(), preculled }, batchCount);
+    if (!inserted) {
+        return batches[it->second];
+    }
+
+    if (batchCount == batches.size()) {
+        batches.emplace_back();
+    }
+
+    Batch& batch = batches[batchCount++];
+    batch.mesh = mesh;
+    batch.material = material;
+    batch.preculled = preculled;
+    return batch;
+}
+
+void MeshRendererSystem::extractRenderData(uint64_t frame) {
+    JELLY_PROFILE_SCOPE("MeshRendererSystem::extract");
+
+    // The other snapshot may still be rendered by the render thread
+    RenderSnapshot& snapshot = snapshots_[frame % SNAPSHOT_COUNT];
+    snapshot.clear();
+    snapshot.frame = frame;
 
     // Find first active camera
+    auto camView = registry_.view<core::Camera, core::Transform>();
     for (auto [entity, camera, transform] : camView.each()) {
-        glm::mat4 viewMatrix = camera.view;
-        glm::mat4 projectionMatrix = camera.projection;
+        snapshot.hasCamera = true;
+        snapshot.viewMatrix = camera.view;
+        snapshot.projectionMatrix = camera.projection;
+        break;
+    }
+
+    if (snapshot.hasCamera) {
+        if (spatialIndex_) {
+            JELLY_PROFILE_SCOPE("MeshRendererSystem::queryIndex");
+            core::ScopedFrameTiming timing(core::FramePhase::Culling);
+
+            indexedEntities_.clear();
+            spatialIndex_->queryFrustum(core::Frustum(snapshot.projectionMatrix * snapshot.viewMatrix), indexedEntities_);
+
+            for (auto entity : indexedEntities_) {
+                if (!registry_.all_of<MeshComponent, MaterialComponent>(entity)) continue;
+
+                const auto& mesh = registry_.get<MeshComponent>(entity);
+                const auto& material = registry_.get<MaterialComponent>(entity);
+                snapshot.acquireBatch(mesh.mesh, material.material, true).worldMatrices.push_back(
+                    registry_.get<core::Transform>(entity).worldMatrix);
+                ++snapshot.indexedCount;
+            }
+        }
+
+        auto extract = [&snapshot](MeshComponent& mesh, MaterialComponent& material, core::Transform& transform) {
+            snapshot.acquireBatch(mesh.mesh, material.material, false).worldMatrices.push_back(transform.worldMatrix);
+        };
+
+        // Indexed entities were handled by the query, visible or not, and are not visited again
+        if (spatialIndex_) {
+            registry_.view<MeshComponent, MaterialComponent, core::Transform>(entt::exclude<core::SpatialBounds>).each(extract);
+        } else {
+            registry_.view<MeshComponent, MaterialComponent, core::Transform>().each(extract);
+        }
+    }
+}
+
+void MeshRendererSystem::collectBatches(const core::Frustum& frustum, const RenderSnapshot& snapshot) {
+    batchCount_ = snapshot.batchCount;
+    if (batches_.size() < batchCount_) {
+        batches_.resize(batchCount_);
+    }
+
+    candidates_.clear();
+    cullingStats_.gpuCount = 0;
+    cullingStats_.pendingCount = 0;
+    cullingStats_.indexedCount = snapshot.indexedCount;
+
+    for (uint32_t i = 0; i < batchCount_; ++i) {
+        const RenderSnapshot::Batch& source = snapshot.batches[i];
+        DrawBatch& batch = batches_[i];
+
+        batch.mesh = source.mesh.get();
+        batch.material = source.material.get();
+        batch.visibleMatrices.clear();
+
+        if (source.preculled) {
+            batch.gpuCulled = false;
+            batch.worldMatrices = &source.worldMatrices;
+            continue;
+        }
+
+        batch.gpuCulled = gpuCullingActive_ && batch.mesh->usesSharedGeometry() &&
+                          batch.material->getShader()->supportsInstancing();
+
+        if (batch.gpuCulled) {
+            batch.worldMatrices = &source.worldMatrices;
+            cullingStats_.gpuCount += static_cast<uint32_t>(source.worldMatrices.size());
+            continue;
+        }
+
+        batch.worldMatrices = &batch.visibleMatrices;
+        for (const glm::mat4& worldMatrix : source.worldMatrices) {
+            candidates_.push_back({ i, &worldMatrix });
+        }
+    }
+
+    const uint32_t candidateCount = static_cast<uint32_t>(candidates_.size());
+    candidateBounds_.resize(candidateCount);
+    visibility_.resize(candidateCount);
+
+    std::atomic<uint32_t> visibleCount{0};
+
+    core::JobSystem::get().parallelFor(candidateCount, CULLING_GRAIN, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const CullCandidate& candidate = candidates_[i];
+            const core::BoundingBox worldBox = batches_[candidate.batch].mesh->getBoundingBox().transformed(*candidate.worldMatrix);
+            const glm::vec3 center = worldBox.getCenter();
+            const glm::vec3 extents = worldBox.getExtents();
+
+            candidateBounds_.centerX[i] = center.x;
+            candidateBounds_.centerY[i] = center.y;
+            candidateBounds_.centerZ[i] = center.z;
+            candidateBounds_.extentX[i] = extents.x;
+            candidateBounds_.extentY[i] = extents.y;
+            candidateBounds_.extentZ[i] = extents.z;
+        }
+
+        size_t visible = frustum.testBoxes(candidateBounds_.view(begin), end - begin, visibility_.data() + begin);
+        visibleCount.fetch_add(static_cast<uint32_t>(visible), std::memory_order_relaxed);
+    });
+
+    cullingStats_.testedCount = candidateCount;
+    cullingStats_.visibleCount = visibleCount.load();
+    cullingStats_.culledCount = candidateCount - cullingStats_.visibleCount;
+
+    for (uint32_t i = 0; i < candidateCount; ++i) {
+        if (!visibility_[i]) continue;
+
+        const CullCandidate& candidate = candidates_[i];
+        batches_[candidate.batch].visibleMatrices.push_back(*candidate.worldMatrix);
+    }
+}
+
+void MeshRendererSystem::buildQueue(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) {
+    const glm::mat4 identity(1.0f);
+    auto api = GraphicContext::get().getAPI();
+
+    renderQueue_.clear();
+    instancedUniformOffsets_.clear();
+    cullBuckets_.clear();
+
+    for (size_t i = 0; i < batchCount_; ++i) {
+        DrawBatch& batch = batches_[i];
+        const std::vector<glm::mat4>& worldMatrices = *batch.worldMatrices;
+        if (worldMatrices.empty()) continue; // Every entity was culled
+
+        // Pipeline still compiling on a worker; draw nothing rather than stall
+        if (!batch.material->isReady()) {
+            cullingStats_.pendingCount += static_cast<uint32_t>(worldMatrices.size());
+            continue;
+        }
+
+        auto shader = batch.material->getShader();
+
+        if (shader->supportsInstancing()) {
+            // World matrices come from the instance stream; the uniform block only
+            // depends on the camera, so one slice is shared by all of the shader's draws
+            auto [it, inserted] = instancedUniformOffsets_.try_emplace(shader.get(), 0);
+            if (inserted) {
+                shader->setUniformMat4("model", glm::value_ptr(identity));
+                shader->setUniformMat4("view", glm::value_ptr(viewMatrix));
+                shader->setUniformMat4("projection", glm::value_ptr(projectionMatrix));
+                it->second = shader->commitUniforms();
+            }
+
+            if (batch.gpuCulled) {
+                // One bucket, and one render item, per material
+                auto [bucket, newBucket] = cullBuckets_.try_emplace(batch.material, 0);
+                if (newBucket) {
+                    bucket->second = api->addCulledBucket();
+
+                    RenderItem item;
+                    item.mesh = batch.mesh;
+                    item.material = batch.material;
+                    item.uniformOffset = it->second;
+                    item.cullBucket = bucket->second;
+                    renderQueue_.push(item, 0.0f);
+                }
+
+                const MeshGeometryRange& range = batch.mesh->getGeometryRange();
+                const core::BoundingBox& box = batch.mesh->getBoundingBox();
+                const glm::vec3 center = box.getCenter();
+                const glm::vec3 extents = box.getExtents();
+
+                CulledDrawDesc draw;
+                draw.indexCount = range.indexCount;
+                draw.firstIndex = range.firstIndex;
+                draw.vertexOffset = range.vertexOffset;
+                draw.boundsCenter[0] = center.x;
+                draw.boundsCenter[1] = center.y;
+                draw.boundsCenter[2] = center.z;
+                draw.boundsExtents[0] = extents.x;
+                draw.boundsExtents[1] = extents.y;
+                draw.boundsExtents[2] = extents.z;
+
+                api->addCulledDraw(bucket->second, draw, glm::value_ptr(worldMatrices[0]),
+                    static_cast<uint32_t>(worldMatrices.size()));
+                continue;
+            }
+
+            RenderItem item;
+            item.mesh = batch.mesh;
+            item.material = batch.material;
+            item.uniformOffset = it->second;
+            item.instanceCount = static_cast<uint32_t>(worldMatrices.size());
+            item.firstInstance = api->writeInstanceData(
+                glm::value_ptr(worldMatrices[0]), item.instanceCount);
+
+            float depth = -(viewMatrix * worldMatrices[0][3]).z;
+            renderQueue_.push(item, depth);
+            continue;
+        }
+
+        shader->setUniformMat4("view", glm::value_ptr(viewMatrix));
+        shader->setUniformMat4("projection", glm::value_ptr(projectionMatrix));
+
+        for (const glm::mat4& worldMatrix : worldMatrices) {
+            shader->setUniformMat4("model", glm::value_ptr(worldMatrix));
+
+            RenderItem item;
+            item.mesh = batch.mesh;
+            item.material = batch.material;
+            item.uniformOffset = shader->commitUniforms();
+
+            float depth = -(viewMatrix * worldMatrix[3]).z;
+            renderQueue_.push(item, depth);
+        }
+    }
+}
+
+void MeshRendererSystem::render(uint64_t frame) {
+    JELLY_PROFILE_SCOPE("MeshRendererSystem::render");
+
+    // Draw the snapshot handed over with the frame, not the newest one: the
+    // next frame may already be extracted while this one waits for its fence
+    const RenderSnapshot& snapshot = snapshots_[frame % SNAPSHOT_COUNT];
+    if (snapshot.frame != frame) return;
+
+    if (snapshot.hasCamera) {
+        auto api = GraphicContext::get().getAPI();
+        const core::Frustum frustum(snapshot.projectionMatrix * snapshot.viewMatrix);
+
+        {
+            core::ScopedFrameTiming timing(core::FramePhase::Culling);
+
+            gpuCullingActive_ = gpuCulling_ && api->supportsGpuCulling();
+            if (gpuCullingActive_) {
+                float planes[core::Frustum::PlaneCount * 4];
+                for (int plane = 0; plane < core::Frustum::PlaneCount; ++plane) {
+                    const glm::vec4& p = frustum.getPlane(static_cast<core::Frustum::Plane>(plane));
+                    std::memcpy(planes + plane * 4, &p.x, sizeof(float) * 4);
+                }
+                api->beginGpuCulling(planes);
+            }
+
+            JELLY_PROFILE_SCOPE("MeshRendererSystem::cull");
+            collectBatches(frustum, snapshot);
+        }
+
+        core::ScopedFrameTiming timing(core::FramePhase::Recording);
+
+        buildQueue(snapshot.viewMatrix, snapshot.projectionMatrix);
 
-        view.each([&](auto entity, MeshComponent& mesh, MaterialComponent& material, 
-                     core::Transform& transform) {
-            auto shader = material.material->getShader();
-            shader->setUniformMat4("model", glm::value_ptr(transform.worldMatrix));
-            shader->setUniformMat4("view", glm::value_ptr(viewMatrix));
-            shader->setUniformMat4("projection", glm::value_ptr(projectionMatrix));
+        if (gpuCullingActive_) {
+            api->dispatchGpuCulling();
+        }
 
-            material.material->bind();
-            mesh.mesh->draw();
-        });
-        break; // Only use first camera found
+        renderQueue_.sort();
+        renderQueue_.submit();
     }
 }
 
-} // namespace jelly::graphics
\ No newline at end of file
+} // namespace jelly::graphics
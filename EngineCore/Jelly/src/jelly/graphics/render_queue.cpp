@@ -0,0 +1,166 @@
+#include "jelly/graphics/render_queue.hpp"
+#include "jelly/graphics/graphic_context.hpp"
+#include "jelly/core/frame_allocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory_resource>
+#include <vector>
+
+namespace jelly::graphics {
+
+void RenderQueue::clear() {
+    items_.clear();
+    entries_.clear();
+}
+
+void RenderQueue::push(const RenderItem& item, float viewDepth) {
+    entries_.push_back({ buildKey(item, viewDepth), static_cast<uint32_t>(items_.size()) });
+    items_.push_back(item);
+}
+
+uint64_t RenderQueue::buildKey(const RenderItem& item, float viewDepth) {
+    // Non-negative floats compare like their bit patterns; the top 16 bits keep
+    // the exponent and 7 mantissa bits, plenty for front-to-back ordering
+    float depth = std::max(viewDepth, 0.0f);
+    uint32_t depthBits;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+    uint64_t pipeline = item.material->getPipelineId() & 0xFFFFu;
+    uint64_t material = item.material->getId() & 0xFFFFu;
+    uint64_t mesh = item.mesh->getId() & 0xFFFFu;
+
+    return (pipeline << 48) | (material << 32) | (mesh << 16) | (depthBits >> 16);
+}
+
+void RenderQueue::sort() {
+    const size_t count = entries_.size();
+    if (count < 2) return;
+
+    scratch_.resize(count);
+
+    // LSD radix sort, 8 bits per pass; passes where every key shares the digit are skipped
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        std::array<uint32_t, 256> histogram{};
+        for (const SortEntry& entry : entries_) {
+            ++histogram[(entry.key >> shift) & 0xFF];
+        }
+
+        if (histogram[(entries_[0].key >> shift) & 0xFF] == count) continue;
+
+        uint32_t sum = 0;
+        for (uint32_t& bucket : histogram) {
+            uint32_t bucketCount = bucket;
+            bucket = sum;
+            sum += bucketCount;
+        }
+
+        for (const SortEntry& entry : entries_) {
+            scratch_[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        entries_.swap(scratch_);
+    }
+}
+
+void RenderQueue::submit() {
+    stats_ = {};
+
+    GraphicContext::get().getAPI()->recordDraws(
+        static_cast<uint32_t>(entries_.size()),
+        [this](uint32_t begin, uint32_t end) {
+            RenderQueueStats rangeStats;
+            submitRange(begin, end, rangeStats);
+
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_ += rangeStats;
+        });
+}
+
+void RenderQueue::submitRange(uint32_t begin, uint32_t end, RenderQueueStats& stats) const {
+    auto api = GraphicContext::get().getAPI();
+
+    // Runs on recording threads too, so the scratch memory is scoped to the call
+    core::FrameAllocator::Scope scope;
+    std::pmr::vector<DrawIndexedCommand> commands(scope.resource());
+
+    bool hasPipeline = false;
+    uint32_t lastPipeline = 0;
+    MaterialInterface* lastMaterial = nullptr;
+    uint32_t lastUniformOffset = 0;
+    Mesh* lastMesh = nullptr;
+    bool sharedGeometryBound = false;
+
+    for (uint32_t i = begin; i < end; ++i) {
+        const RenderItem& item = items_[entries_[i].index];
+
+        uint32_t pipeline = item.material->getPipelineId();
+        if (!hasPipeline || pipeline != lastPipeline) {
+            item.material->bindPipeline();
+            hasPipeline = true;
+            lastPipeline = pipeline;
+            // Pipelines may use different layouts, so resources are rebound after a switch
+            lastMaterial = nullptr;
+            ++stats.pipelineBinds;
+        } else {
+            ++stats.skippedPipelineBinds;
+        }
+
+        if (item.material != lastMaterial || item.uniformOffset != lastUniformOffset) {
+            item.material->bindResources(item.uniformOffset);
+            lastMaterial = item.material;
+            lastUniformOffset = item.uniformOffset;
+            ++stats.resourceBinds;
+        } else {
+            ++stats.skippedResourceBinds;
+        }
+
+        if (item.mesh->usesSharedGeometry()) {
+            if (!sharedGeometryBound) {
+                api->bindSharedGeometry();
+                sharedGeometryBound = true;
+                lastMesh = nullptr;
+                ++stats.meshBinds;
+            } else {
+                ++stats.skippedMeshBinds;
+            }
+
+            if (item.cullBucket != RenderItem::NO_CULL_BUCKET) {
+                stats.drawCount += api->drawCulledBucket(item.cullBucket);
+                continue;
+            }
+
+            // Fold the following items with the same state into one indirect draw
+            commands.clear();
+            uint32_t last = i;
+            for (; last < end; ++last) {
+                const RenderItem& next = items_[entries_[last].index];
+                if (next.material != item.material || next.uniformOffset != item.uniformOffset ||
+                    !next.mesh->usesSharedGeometry() || next.cullBucket != RenderItem::NO_CULL_BUCKET) break;
+
+                const MeshGeometryRange& range = next.mesh->getGeometryRange();
+                commands.push_back({ range.indexCount, next.instanceCount, range.firstIndex,
+                                     range.vertexOffset, next.firstInstance });
+            }
+
+            stats.drawCount += api->drawIndexedIndirect(commands.data(), static_cast<uint32_t>(commands.size()));
+            stats.mergedDraws += static_cast<uint32_t>(commands.size());
+            i = last - 1;
+            continue;
+        }
+
+        if (item.mesh != lastMesh) {
+            item.mesh->bind();
+            sharedGeometryBound = false;
+            lastMesh = item.mesh;
+            ++stats.meshBinds;
+        } else {
+            ++stats.skippedMeshBinds;
+        }
+
+        item.mesh->drawIndexed(item.instanceCount, item.firstInstance);
+        ++stats.drawCount;
+    }
+}
+
+} // namespace jelly::graphics
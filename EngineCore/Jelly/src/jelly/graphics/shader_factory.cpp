@@ -3,6 +3,7 @@
 #include "jelly/graphics/graphic_context.hpp"
 #include "jelly/graphics/vulkan/vulkan_shader.hpp"
 #include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+#include "jelly/core/profiler.hpp"
 
 namespace jelly::graphics {
 
@@ -10,6 +11,7 @@ std::vector<std::weak_ptr<ShaderInterface>> ShaderFactory::shaders_;
 std::mutex ShaderFactory::mutex_;
 
 std::shared_ptr<ShaderInterface> ShaderFactory::createFromFiles(const std::string& shaderPath) {
+    JELLY_PROFILE_SCOPE("ShaderFactory::createFromFiles");
 
     auto& context = GraphicContext::get();
     auto api = context.getAPIType();
@@ -40,6 +42,13 @@ std::shared_ptr<ShaderInterface> ShaderFactory::createFromFiles(const std::strin
     return nullptr;
 }
 
+std::vector<uint8_t> ShaderFactory::readStageBinary(
+    const std::string& shaderName,
+    const std::string& stage,
+    const std::string& backend)
+{
+    return readBinaryFile(resolveShaderPath(shaderName, stage, backend));
+}
 
 void ShaderFactory::releaseAll()
 {
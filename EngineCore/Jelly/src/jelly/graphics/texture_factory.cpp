@@ -1,4 +1,5 @@
 #include "jelly/graphics/texture_factory.hpp"
+#include "jelly/core/profiler.hpp"
 #include <stdexcept>
 
 namespace jelly::graphics {
@@ -7,6 +8,7 @@ std::vector<std::weak_ptr<TextureInterface>> TextureFactory::textures_;
 std::mutex TextureFactory::mutex_;
 
 TextureHandle TextureFactory::create(const Image& image) {
+    JELLY_PROFILE_SCOPE("TextureFactory::create");
     switch (GraphicContext::get().getAPIType()) {
         case core::GraphicAPIType::Vulkan: {
             auto api = static_cast<vulkan::VulkanGraphicAPI*>(GraphicContext::get().getAPI());
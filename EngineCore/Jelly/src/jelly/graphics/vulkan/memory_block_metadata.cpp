@@ -0,0 +1,268 @@
+#include "jelly/graphics/vulkan/memory_block_metadata.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace jelly::graphics::vulkan {
+
+namespace {
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+MemoryBlockMetadata::MemoryBlockMetadata(uint64_t size, MemoryStrategy strategy)
+    : size_(size), strategy_(strategy)
+{
+    if (strategy_ != MemoryStrategy::Tlsf) return;
+
+    freeLists_.fill(NULL_INDEX);
+
+    const uint32_t index = createNode();
+    nodes_[index].offset = 0;
+    nodes_[index].size = size_;
+    nodes_[index].free = true;
+    insertFree(index);
+}
+
+uint32_t MemoryBlockMetadata::allocate(uint64_t size, uint64_t alignment, uint64_t& outOffset) {
+    if (size == 0 || size > size_) return INVALID_NODE;
+    if (alignment == 0) alignment = 1;
+
+    if (strategy_ == MemoryStrategy::Linear) {
+        const uint64_t offset = alignUp(linearHead_, alignment);
+        if (offset + size > size_) return INVALID_NODE;
+
+        linearHead_ = offset + size;
+        allocatedBytes_ += size;
+        ++allocationCount_;
+        outOffset = offset;
+        return 0;
+    }
+
+    // The first range of the matching bucket usually fits once aligned; if it
+    // does not, look for a bucket large enough to absorb any padding.
+    uint32_t index = findSuitableNode(size);
+    if (index != NULL_INDEX) {
+        const Node& node = nodes_[index];
+        if (alignUp(node.offset, alignment) + size > node.offset + node.size) {
+            index = NULL_INDEX;
+        }
+    }
+    if (index == NULL_INDEX && alignment > 1 && size + alignment - 1 <= size_) {
+        index = findSuitableNode(size + alignment - 1);
+    }
+    if (index == NULL_INDEX) return INVALID_NODE;
+
+    removeFree(index);
+
+    // Split off the alignment padding as a free range in front
+    const uint64_t alignedOffset = alignUp(nodes_[index].offset, alignment);
+    const uint64_t padding = alignedOffset - nodes_[index].offset;
+    if (padding > 0) {
+        const uint32_t front = createNode();
+        Node& node = nodes_[index];
+        Node& frontNode = nodes_[front];
+
+        frontNode.offset = node.offset;
+        frontNode.size = padding;
+        frontNode.free = true;
+        frontNode.prevPhysical = node.prevPhysical;
+        frontNode.nextPhysical = index;
+        if (node.prevPhysical != NULL_INDEX) nodes_[node.prevPhysical].nextPhysical = front;
+
+        node.prevPhysical = front;
+        node.offset = alignedOffset;
+        node.size -= padding;
+        insertFree(front);
+    }
+
+    // Return the tail to the free lists
+    const uint64_t remainder = nodes_[index].size - size;
+    if (remainder > 0) {
+        const uint32_t back = createNode();
+        Node& node = nodes_[index];
+        Node& backNode = nodes_[back];
+
+        backNode.offset = node.offset + size;
+        backNode.size = remainder;
+        backNode.free = true;
+        backNode.prevPhysical = index;
+        backNode.nextPhysical = node.nextPhysical;
+        if (node.nextPhysical != NULL_INDEX) nodes_[node.nextPhysical].prevPhysical = back;
+
+        node.nextPhysical = back;
+        node.size = size;
+        insertFree(back);
+    }
+
+    nodes_[index].free = false;
+    allocatedBytes_ += size;
+    ++allocationCount_;
+    outOffset = nodes_[index].offset;
+    return index;
+}
+
+void MemoryBlockMetadata::free(uint32_t node, uint64_t size) {
+    allocatedBytes_ -= size;
+    --allocationCount_;
+
+    if (strategy_ == MemoryStrategy::Linear) {
+        if (allocationCount_ == 0) linearHead_ = 0;
+        return;
+    }
+
+    nodes_[node].free = true;
+    insertFree(coalesce(node));
+}
+
+uint64_t MemoryBlockMetadata::getFreeBytes() const {
+    if (strategy_ == MemoryStrategy::Linear) return size_ - linearHead_;
+    return size_ - allocatedBytes_;
+}
+
+uint64_t MemoryBlockMetadata::getLargestFreeRange() const {
+    if (strategy_ == MemoryStrategy::Linear) return size_ - linearHead_;
+    if (firstLevelBitmap_ == 0) return 0;
+
+    // Every range of the highest non-empty bucket beats the ranges of lower buckets
+    const uint32_t firstLevel = 63 - std::countl_zero(firstLevelBitmap_);
+    const uint32_t secondLevel = 31 - std::countl_zero(secondLevelBitmaps_[firstLevel]);
+
+    uint64_t largest = 0;
+    for (uint32_t index = freeLists_[firstLevel * SECOND_LEVEL_COUNT + secondLevel];
+         index != NULL_INDEX;
+         index = nodes_[index].nextFree) {
+        largest = std::max(largest, nodes_[index].size);
+    }
+    return largest;
+}
+
+uint32_t MemoryBlockMetadata::createNode() {
+    if (unusedNodes_ != NULL_INDEX) {
+        const uint32_t index = unusedNodes_;
+        unusedNodes_ = nodes_[index].nextFree;
+        nodes_[index] = Node{};
+        return index;
+    }
+
+    nodes_.emplace_back();
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void MemoryBlockMetadata::destroyNode(uint32_t index) {
+    nodes_[index] = Node{};
+    nodes_[index].nextFree = unusedNodes_;
+    unusedNodes_ = index;
+}
+
+void MemoryBlockMetadata::mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel) {
+    if (size < SMALL_SIZE) {
+        firstLevel = 0;
+        secondLevel = static_cast<uint32_t>(size >> (SMALL_SIZE_LOG2 - SECOND_LEVEL_LOG2));
+        return;
+    }
+
+    const uint32_t msb = 63 - std::countl_zero(size);
+    firstLevel = msb - SMALL_SIZE_LOG2 + 1;
+    secondLevel = static_cast<uint32_t>(size >> (msb - SECOND_LEVEL_LOG2)) & (SECOND_LEVEL_COUNT - 1);
+}
+
+uint32_t MemoryBlockMetadata::findSuitableNode(uint64_t size) const {
+    // Round up to the next bucket boundary so any range found is large enough
+    if (size < SMALL_SIZE) {
+        constexpr uint64_t step = SMALL_SIZE / SECOND_LEVEL_COUNT;
+        size = (size + step - 1) & ~(step - 1);
+    } else {
+        const uint32_t msb = 63 - std::countl_zero(size);
+        size += (1ull << (msb - SECOND_LEVEL_LOG2)) - 1;
+    }
+
+    uint32_t firstLevel = 0;
+    uint32_t secondLevel = 0;
+    mapping(size, firstLevel, secondLevel);
+    if (firstLevel >= FIRST_LEVEL_COUNT) return NULL_INDEX;
+
+    uint32_t secondLevelMap = secondLevelBitmaps_[firstLevel] & (~0u << secondLevel);
+    if (secondLevelMap == 0) {
+        const uint64_t firstLevelMap = firstLevel + 1 < 64 ? firstLevelBitmap_ & (~0ull << (firstLevel + 1)) : 0;
+        if (firstLevelMap == 0) return NULL_INDEX;
+
+        firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+        secondLevelMap = secondLevelBitmaps_[firstLevel];
+    }
+
+    secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+    return freeLists_[firstLevel * SECOND_LEVEL_COUNT + secondLevel];
+}
+
+void MemoryBlockMetadata::insertFree(uint32_t index) {
+    uint32_t firstLevel = 0;
+    uint32_t secondLevel = 0;
+    mapping(nodes_[index].size, firstLevel, secondLevel);
+
+    uint32_t& head = freeLists_[firstLevel * SECOND_LEVEL_COUNT + secondLevel];
+    nodes_[index].prevFree = NULL_INDEX;
+    nodes_[index].nextFree = head;
+    if (head != NULL_INDEX) nodes_[head].prevFree = index;
+    head = index;
+
+    secondLevelBitmaps_[firstLevel] |= 1u << secondLevel;
+    firstLevelBitmap_ |= 1ull << firstLevel;
+}
+
+void MemoryBlockMetadata::removeFree(uint32_t index) {
+    Node& node = nodes_[index];
+
+    if (node.nextFree != NULL_INDEX) nodes_[node.nextFree].prevFree = node.prevFree;
+
+    if (node.prevFree != NULL_INDEX) {
+        nodes_[node.prevFree].nextFree = node.nextFree;
+    } else {
+        uint32_t firstLevel = 0;
+        uint32_t secondLevel = 0;
+        mapping(node.size, firstLevel, secondLevel);
+
+        freeLists_[firstLevel * SECOND_LEVEL_COUNT + secondLevel] = node.nextFree;
+        if (node.nextFree == NULL_INDEX) {
+            secondLevelBitmaps_[firstLevel] &= ~(1u << secondLevel);
+            if (secondLevelBitmaps_[firstLevel] == 0) {
+                firstLevelBitmap_ &= ~(1ull << firstLevel);
+            }
+        }
+    }
+
+    node.prevFree = NULL_INDEX;
+    node.nextFree = NULL_INDEX;
+}
+
+uint32_t MemoryBlockMetadata::coalesce(uint32_t index) {
+    const uint32_t prev = nodes_[index].prevPhysical;
+    if (prev != NULL_INDEX && nodes_[prev].free) {
+        removeFree(prev);
+
+        nodes_[prev].size += nodes_[index].size;
+        nodes_[prev].nextPhysical = nodes_[index].nextPhysical;
+        if (nodes_[index].nextPhysical != NULL_INDEX) nodes_[nodes_[index].nextPhysical].prevPhysical = prev;
+
+        destroyNode(index);
+        index = prev;
+    }
+
+    const uint32_t next = nodes_[index].nextPhysical;
+    if (next != NULL_INDEX && nodes_[next].free) {
+        removeFree(next);
+
+        nodes_[index].size += nodes_[next].size;
+        nodes_[index].nextPhysical = nodes_[next].nextPhysical;
+        if (nodes_[next].nextPhysical != NULL_INDEX) nodes_[nodes_[next].nextPhysical].prevPhysical = index;
+
+        destroyNode(next);
+    }
+
+    return index;
+}
+
+} // namespace jelly::graphics::vulkan
@@ -24,13 +24,14 @@ uint32_t VulkanBufferUtils::findMemoryType(
 }
 
 void VulkanBufferUtils::createBuffer(
+    VulkanMemoryAllocator& allocator,
     VkDevice device,
-    VkPhysicalDevice physicalDevice,
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkBuffer& buffer,
-    VkDeviceMemory& memory
+    MemoryAllocation*& allocation,
+    MemoryStrategy strategy
 ) {
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -42,20 +43,13 @@ void VulkanBufferUtils::createBuffer(
         throw std::runtime_error("Failed to create buffer!");
     }
 
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex =
-        findMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties);
-
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate buffer memory!");
+    try {
+        allocation = allocator.allocateForBuffer(buffer, properties, strategy);
+    } catch (...) {
+        vkDestroyBuffer(device, buffer, nullptr);
+        buffer = VK_NULL_HANDLE;
+        throw;
     }
-
-    vkBindBufferMemory(device, buffer, memory, 0);
 }
 
 void VulkanBufferUtils::copyBuffer(
@@ -0,0 +1,153 @@
+#include "jelly/graphics/vulkan/vulkan_geometry_arena.hpp"
+
+#include "jelly/exception.hpp"
+#include "jelly/graphics/mesh.hpp"
+#include "jelly/graphics/vulkan/vulkan_staging_uploader.hpp"
+
+namespace jelly::graphics::vulkan {
+
+VulkanGeometryArena::VulkanGeometryArena(
+    VkDevice device,
+    VulkanMemoryAllocator& allocator,
+    VulkanStagingUploader& uploader,
+    uint32_t vertexCapacity,
+    uint32_t indexCapacity,
+    uint32_t frameCount)
+    : device_(device),
+      allocator_(allocator),
+      uploader_(uploader),
+      vertexRanges_(vertexCapacity, MemoryStrategy::Tlsf),
+      indexRanges_(indexCapacity, MemoryStrategy::Tlsf),
+      retiredRanges_(frameCount)
+{
+    createBuffer(
+        static_cast<VkDeviceSize>(vertexCapacity) * sizeof(Vertex),
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        vertexBuffer_, vertexMemory_
+    );
+
+    createBuffer(
+        static_cast<VkDeviceSize>(indexCapacity) * sizeof(uint32_t),
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        indexBuffer_, indexMemory_
+    );
+}
+
+VulkanGeometryArena::~VulkanGeometryArena() {
+    release();
+}
+
+bool VulkanGeometryArena::allocate(uint32_t vertexCount, uint32_t indexCount, GeometryArenaRange& outRange) {
+    std::lock_guard lock(mutex_);
+
+    // Ranges are counted in elements, so no alignment is needed
+    uint64_t vertexOffset = 0;
+    const uint32_t vertexNode = vertexRanges_.allocate(vertexCount, 1, vertexOffset);
+    if (vertexNode == MemoryBlockMetadata::INVALID_NODE) return false;
+
+    uint64_t firstIndex = 0;
+    const uint32_t indexNode = indexRanges_.allocate(indexCount, 1, firstIndex);
+    if (indexNode == MemoryBlockMetadata::INVALID_NODE) {
+        vertexRanges_.free(vertexNode, vertexCount);
+        return false;
+    }
+
+    outRange.vertexOffset = static_cast<uint32_t>(vertexOffset);
+    outRange.vertexCount = vertexCount;
+    outRange.firstIndex = static_cast<uint32_t>(firstIndex);
+    outRange.indexCount = indexCount;
+    outRange.vertexNode = vertexNode;
+    outRange.indexNode = indexNode;
+    return true;
+}
+
+void VulkanGeometryArena::upload(const GeometryArenaRange& range, const void* vertices, const uint32_t* indices) {
+    uploader_.upload(
+        vertexBuffer_, vertices,
+        static_cast<VkDeviceSize>(range.vertexCount) * sizeof(Vertex),
+        static_cast<VkDeviceSize>(range.vertexOffset) * sizeof(Vertex)
+    );
+
+    uploader_.upload(
+        indexBuffer_, indices,
+        static_cast<VkDeviceSize>(range.indexCount) * sizeof(uint32_t),
+        static_cast<VkDeviceSize>(range.firstIndex) * sizeof(uint32_t)
+    );
+}
+
+void VulkanGeometryArena::free(GeometryArenaRange& range) {
+    if (range.vertexNode == MemoryBlockMetadata::INVALID_NODE) return;
+
+    std::lock_guard lock(mutex_);
+
+    // Draws recorded this frame may still read the range until its fence comes around
+    retiredRanges_[currentFrame_].push_back(range);
+    range = GeometryArenaRange{};
+}
+
+void VulkanGeometryArena::beginFrame(uint32_t frameIndex) {
+    std::lock_guard lock(mutex_);
+
+    currentFrame_ = frameIndex;
+
+    for (const GeometryArenaRange& range : retiredRanges_[frameIndex]) {
+        vertexRanges_.free(range.vertexNode, range.vertexCount);
+        indexRanges_.free(range.indexNode, range.indexCount);
+    }
+    retiredRanges_[frameIndex].clear();
+}
+
+void VulkanGeometryArena::bind(VkCommandBuffer commandBuffer) const {
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer_, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer_, 0, VK_INDEX_TYPE_UINT32);
+}
+
+uint32_t VulkanGeometryArena::getUsedVertices() const {
+    std::lock_guard lock(mutex_);
+    return static_cast<uint32_t>(vertexRanges_.getAllocatedBytes());
+}
+
+uint32_t VulkanGeometryArena::getUsedIndices() const {
+    std::lock_guard lock(mutex_);
+    return static_cast<uint32_t>(indexRanges_.getAllocatedBytes());
+}
+
+void VulkanGeometryArena::release() {
+    if (device_ == VK_NULL_HANDLE) return;
+
+    if (vertexBuffer_) vkDestroyBuffer(device_, vertexBuffer_, nullptr);
+    if (indexBuffer_) vkDestroyBuffer(device_, indexBuffer_, nullptr);
+    allocator_.free(vertexMemory_);
+    allocator_.free(indexMemory_);
+
+    vertexBuffer_ = VK_NULL_HANDLE;
+    indexBuffer_ = VK_NULL_HANDLE;
+    vertexMemory_ = nullptr;
+    indexMemory_ = nullptr;
+    device_ = VK_NULL_HANDLE;
+}
+
+void VulkanGeometryArena::createBuffer(
+    VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, MemoryAllocation*& memory)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // Concurrent sharing avoids ownership transfers between the transfer and graphics queues
+    if (uploader_.usesDedicatedTransferQueue()) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.pQueueFamilyIndices = uploader_.getQueueFamilyIndices(bufferInfo.queueFamilyIndexCount);
+    }
+
+    if (vkCreateBuffer(device_, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+        throw Exception("Failed to create geometry arena buffer!");
+    }
+
+    memory = allocator_.allocateForBuffer(buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+} // namespace jelly::graphics::vulkan
@@ -0,0 +1,463 @@
+#include "jelly/graphics/vulkan/vulkan_gpu_culler.hpp"
+
+#include "jelly/exception.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace jelly::graphics::vulkan {
+
+VulkanGpuCuller::VulkanGpuCuller(
+    VkDevice device,
+    VulkanMemoryAllocator& allocator,
+    uint32_t queueFamily,
+    const std::vector<uint8_t>& spirvCode,
+    PFN_vkCmdDrawIndexedIndirectCountKHR drawIndexedIndirectCount,
+    uint32_t frameCount)
+    : device_(device),
+      allocator_(allocator),
+      drawIndexedIndirectCount_(drawIndexedIndirectCount)
+{
+    createPipeline(spirvCode);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = queueFamily;
+
+    if (vkCreateCommandPool(device_, &poolInfo, nullptr, &commandPool_) != VK_SUCCESS) {
+        throw Exception("Failed to create culling command pool!");
+    }
+
+    createFrameResources(frameCount);
+}
+
+VulkanGpuCuller::~VulkanGpuCuller() {
+    release();
+}
+
+void VulkanGpuCuller::begin(uint32_t frameIndex, const float* frustumPlanes) {
+    currentFrame_ = frameIndex;
+    frames_[currentFrame_].dispatched = false;
+    resultsReady_ = false;
+
+    std::memcpy(params_.planes, frustumPlanes, sizeof(params_.planes));
+    instanceCount_ = 0;
+    drawCount_ = 0;
+    bucketDrawCounts_.clear();
+    bucketBases_.clear();
+}
+
+uint32_t VulkanGpuCuller::addBucket() {
+    bucketDrawCounts_.push_back(0);
+    return static_cast<uint32_t>(bucketDrawCounts_.size() - 1);
+}
+
+void VulkanGpuCuller::addDraw(
+    uint32_t bucket, const CulledDrawDesc& draw, const float* worldMatrices, uint32_t instanceCount)
+{
+    if (instanceCount == 0) return;
+
+    FrameResources& frame = frames_[currentFrame_];
+    const VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+    reserve(frame.draws, (drawCount_ + 1) * sizeof(GpuDraw), drawCount_ * sizeof(GpuDraw), usage, true, frame);
+    reserve(frame.commands, (drawCount_ + 1) * sizeof(DrawIndexedCommand),
+        drawCount_ * sizeof(DrawIndexedCommand), usage, true, frame);
+    reserve(frame.drawIndices, VkDeviceSize(instanceCount_ + instanceCount) * sizeof(uint32_t),
+        VkDeviceSize(instanceCount_) * sizeof(uint32_t), usage, true, frame);
+    reserve(frame.worlds, VkDeviceSize(instanceCount_ + instanceCount) * sizeof(float) * 16,
+        VkDeviceSize(instanceCount_) * sizeof(float) * 16, usage, true, frame);
+
+    GpuDraw& gpuDraw = reinterpret_cast<GpuDraw*>(frame.draws.memory->mapped)[drawCount_];
+    gpuDraw = GpuDraw{};
+    std::copy_n(draw.boundsCenter, 3, gpuDraw.center);
+    std::copy_n(draw.boundsExtents, 3, gpuDraw.extents);
+    gpuDraw.bucket = bucket;
+    gpuDraw.instanceBase = instanceCount_;
+
+    // The shader counts the visible instances into instanceCount
+    DrawIndexedCommand& command = reinterpret_cast<DrawIndexedCommand*>(frame.commands.memory->mapped)[drawCount_];
+    command = { draw.indexCount, 0, draw.firstIndex, draw.vertexOffset, instanceCount_ };
+
+    uint32_t* drawIndices = reinterpret_cast<uint32_t*>(frame.drawIndices.memory->mapped) + instanceCount_;
+    std::fill_n(drawIndices, instanceCount, drawCount_);
+
+    float* worlds = reinterpret_cast<float*>(frame.worlds.memory->mapped) + size_t(instanceCount_) * 16;
+    std::memcpy(worlds, worldMatrices, size_t(instanceCount) * sizeof(float) * 16);
+
+    ++bucketDrawCounts_[bucket];
+    instanceCount_ += instanceCount;
+    ++drawCount_;
+}
+
+void VulkanGpuCuller::dispatch() {
+    if (drawCount_ == 0) return;
+
+    FrameResources& frame = frames_[currentFrame_];
+    const uint32_t bucketCount = static_cast<uint32_t>(bucketDrawCounts_.size());
+
+    // Bucket command ranges are laid out back to back
+    bucketBases_.resize(bucketCount);
+    uint32_t base = 0;
+    for (uint32_t bucket = 0; bucket < bucketCount; ++bucket) {
+        bucketBases_[bucket] = base;
+        base += bucketDrawCounts_[bucket];
+    }
+
+    GpuDraw* draws = reinterpret_cast<GpuDraw*>(frame.draws.memory->mapped);
+    for (uint32_t i = 0; i < drawCount_; ++i) {
+        draws[i].commandBase = bucketBases_[draws[i].bucket];
+    }
+
+    reserve(frame.compacted, drawCount_ * sizeof(DrawIndexedCommand), 0,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, hostReadable_, frame);
+    reserve(frame.counts, bucketCount * sizeof(uint32_t), 0,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        hostReadable_, frame);
+    reserve(frame.instances, VkDeviceSize(instanceCount_) * sizeof(float) * 16, 0,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, hostReadable_, frame);
+
+    if (frame.descriptorsDirty) {
+        updateDescriptors(frame);
+    }
+
+    VkCommandBuffer commandBuffer = frame.commandBuffer;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    uint32_t timerScope = VulkanGpuTimer::INVALID_SCOPE;
+    if (gpuTimer_) {
+        timerScope = gpuTimer_->beginScope(commandBuffer, gpuTimer_->beginCommandBuffer(commandBuffer), "GpuCulling");
+    }
+
+    vkCmdFillBuffer(commandBuffer, frame.counts.buffer, 0, bucketCount * sizeof(uint32_t), 0);
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+        pipelineLayout_, 0, 1, &frame.descriptorSet, 0, nullptr);
+
+    // Pass 0: per-instance visibility
+    params_.instanceCount = instanceCount_;
+    params_.drawCount = drawCount_;
+    params_.pass = 0;
+    vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &params_);
+    vkCmdDispatch(commandBuffer, (instanceCount_ + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    // Pass 1: per-draw compaction
+    params_.pass = 1;
+    vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &params_);
+    vkCmdDispatch(commandBuffer, (drawCount_ + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+    if (hostReadable_) {
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    if (gpuTimer_) {
+        gpuTimer_->endScope(commandBuffer, timerScope);
+    }
+
+    vkEndCommandBuffer(commandBuffer);
+    frame.dispatched = true;
+}
+
+VkSemaphore VulkanGpuCuller::submit(VkQueue queue) {
+    FrameResources& frame = frames_[currentFrame_];
+    if (!frame.dispatched) return VK_NULL_HANDLE;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &frame.commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &frame.semaphore;
+
+    // The frame's fence covers this submission: the frame waits on its semaphore
+    if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw Exception("Failed to submit culling pass!");
+    }
+
+    frame.dispatched = false;
+    resultsReady_ = true;
+    return frame.semaphore;
+}
+
+void VulkanGpuCuller::drawBucket(VkCommandBuffer commandBuffer, uint32_t bucket, uint32_t instanceBinding) const {
+    if (bucket >= bucketBases_.size() || bucketDrawCounts_[bucket] == 0) return;
+
+    const FrameResources& frame = frames_[currentFrame_];
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, instanceBinding, 1, &frame.instances.buffer, &offset);
+
+    drawIndexedIndirectCount_(
+        commandBuffer,
+        frame.compacted.buffer, bucketBases_[bucket] * sizeof(DrawIndexedCommand),
+        frame.counts.buffer, bucket * sizeof(uint32_t),
+        bucketDrawCounts_[bucket],
+        sizeof(DrawIndexedCommand)
+    );
+}
+
+void VulkanGpuCuller::setHostReadable(bool readable) {
+    if (readable == hostReadable_) return;
+    hostReadable_ = readable;
+
+    // Reallocated with the new memory type by the next dispatch()
+    for (FrameResources& frame : frames_) {
+        destroyBuffer(frame.compacted);
+        destroyBuffer(frame.counts);
+        destroyBuffer(frame.instances);
+        frame.descriptorsDirty = true;
+    }
+}
+
+bool VulkanGpuCuller::readResults(GpuCullingResults& results) const {
+    if (!hostReadable_ || !resultsReady_) return false;
+
+    const FrameResources& frame = frames_[currentFrame_];
+    const uint32_t* counts = reinterpret_cast<const uint32_t*>(frame.counts.memory->mapped);
+    const DrawIndexedCommand* compacted = reinterpret_cast<const DrawIndexedCommand*>(frame.compacted.memory->mapped);
+
+    results.buckets.resize(bucketDrawCounts_.size());
+    for (size_t bucket = 0; bucket < bucketDrawCounts_.size(); ++bucket) {
+        const uint32_t count = std::min(counts[bucket], bucketDrawCounts_[bucket]);
+        const DrawIndexedCommand* first = compacted + bucketBases_[bucket];
+        results.buckets[bucket].assign(first, first + count);
+    }
+
+    const float* instances = reinterpret_cast<const float*>(frame.instances.memory->mapped);
+    results.instances.assign(instances, instances + size_t(instanceCount_) * 16);
+    return true;
+}
+
+void VulkanGpuCuller::release() {
+    if (device_ == VK_NULL_HANDLE) return;
+
+    for (FrameResources& frame : frames_) {
+        for (StorageBuffer* storage : { &frame.draws, &frame.commands, &frame.drawIndices, &frame.worlds,
+                                        &frame.compacted, &frame.counts, &frame.instances }) {
+            destroyBuffer(*storage);
+        }
+        if (frame.semaphore) vkDestroySemaphore(device_, frame.semaphore, nullptr);
+    }
+    frames_.clear();
+
+    // Command buffers and descriptor sets go with their pools
+    if (commandPool_) vkDestroyCommandPool(device_, commandPool_, nullptr);
+    if (descriptorPool_) vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
+    if (pipeline_) vkDestroyPipeline(device_, pipeline_, nullptr);
+    if (pipelineLayout_) vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
+    if (descriptorSetLayout_) vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
+
+    commandPool_ = VK_NULL_HANDLE;
+    descriptorPool_ = VK_NULL_HANDLE;
+    pipeline_ = VK_NULL_HANDLE;
+    pipelineLayout_ = VK_NULL_HANDLE;
+    descriptorSetLayout_ = VK_NULL_HANDLE;
+    device_ = VK_NULL_HANDLE;
+}
+
+void VulkanGpuCuller::createPipeline(const std::vector<uint8_t>& spirvCode) {
+    std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT> bindings{};
+    for (uint32_t i = 0; i < BINDING_COUNT; ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = BINDING_COUNT;
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device_, &layoutInfo, nullptr, &descriptorSetLayout_) != VK_SUCCESS) {
+        throw Exception("Failed to create culling descriptor set layout!");
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout_;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device_, &pipelineLayoutInfo, nullptr, &pipelineLayout_) != VK_SUCCESS) {
+        throw Exception("Failed to create culling pipeline layout!");
+    }
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = spirvCode.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(spirvCode.data());
+
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(device_, &moduleInfo, nullptr, &module) != VK_SUCCESS) {
+        throw Exception("Failed to create culling shader module!");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = pipelineLayout_;
+
+    VkResult result = vkCreateComputePipelines(device_, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline_);
+    vkDestroyShaderModule(device_, module, nullptr);
+
+    if (result != VK_SUCCESS) {
+        throw Exception("Failed to create culling pipeline!");
+    }
+}
+
+void VulkanGpuCuller::createFrameResources(uint32_t frameCount) {
+    frames_.resize(frameCount);
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = BINDING_COUNT * frameCount;
+
+    VkDescriptorPoolCreateInfo descriptorPoolInfo{};
+    descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptorPoolInfo.maxSets = frameCount;
+    descriptorPoolInfo.poolSizeCount = 1;
+    descriptorPoolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(device_, &descriptorPoolInfo, nullptr, &descriptorPool_) != VK_SUCCESS) {
+        throw Exception("Failed to create culling descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(frameCount, descriptorSetLayout_);
+    std::vector<VkDescriptorSet> descriptorSets(frameCount);
+
+    VkDescriptorSetAllocateInfo setInfo{};
+    setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    setInfo.descriptorPool = descriptorPool_;
+    setInfo.descriptorSetCount = frameCount;
+    setInfo.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device_, &setInfo, descriptorSets.data()) != VK_SUCCESS) {
+        throw Exception("Failed to allocate culling descriptor sets!");
+    }
+
+    std::vector<VkCommandBuffer> commandBuffers(frameCount);
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = commandPool_;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = frameCount;
+
+    if (vkAllocateCommandBuffers(device_, &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
+        throw Exception("Failed to allocate culling command buffers!");
+    }
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        frames_[i].descriptorSet = descriptorSets[i];
+        frames_[i].commandBuffer = commandBuffers[i];
+
+        if (vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &frames_[i].semaphore) != VK_SUCCESS) {
+            throw Exception("Failed to create culling semaphore!");
+        }
+    }
+}
+
+void VulkanGpuCuller::reserve(
+    StorageBuffer& storage, VkDeviceSize size, VkDeviceSize keepBytes,
+    VkBufferUsageFlags usage, bool hostVisible, FrameResources& frame)
+{
+    if (size <= storage.capacity) return;
+
+    StorageBuffer grown;
+    grown.capacity = std::max({ size, storage.capacity * 2, MIN_BUFFER_SIZE });
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = grown.capacity;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(device_, &bufferInfo, nullptr, &grown.buffer) != VK_SUCCESS) {
+        throw Exception("Failed to create culling buffer!");
+    }
+
+    grown.memory = allocator_.allocateForBuffer(grown.buffer, hostVisible
+        ? VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    // Only this frame's earlier CPU writes can be live; the GPU is done with the old buffer
+    if (hostVisible && keepBytes > 0) {
+        std::memcpy(grown.memory->mapped, storage.memory->mapped, static_cast<size_t>(keepBytes));
+    }
+
+    destroyBuffer(storage);
+    storage = grown;
+    frame.descriptorsDirty = true;
+}
+
+void VulkanGpuCuller::destroyBuffer(StorageBuffer& storage) {
+    if (storage.buffer) vkDestroyBuffer(device_, storage.buffer, nullptr);
+    allocator_.free(storage.memory);
+    storage = StorageBuffer{};
+}
+
+void VulkanGpuCuller::updateDescriptors(FrameResources& frame) {
+    const std::array<const StorageBuffer*, BINDING_COUNT> buffers = {
+        &frame.draws, &frame.commands, &frame.drawIndices, &frame.worlds,
+        &frame.compacted, &frame.counts, &frame.instances
+    };
+
+    std::array<VkDescriptorBufferInfo, BINDING_COUNT> bufferInfos{};
+    std::array<VkWriteDescriptorSet, BINDING_COUNT> writes{};
+
+    for (uint32_t i = 0; i < BINDING_COUNT; ++i) {
+        bufferInfos[i].buffer = buffers[i]->buffer;
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = frame.descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+
+    vkUpdateDescriptorSets(device_, BINDING_COUNT, writes.data(), 0, nullptr);
+    frame.descriptorsDirty = false;
+}
+
+} // namespace jelly::graphics::vulkan
@@ -0,0 +1,203 @@
+#include "jelly/graphics/vulkan/vulkan_gpu_timer.hpp"
+
+#include "jelly/exception.hpp"
+#include "jelly/core/profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace jelly::graphics::vulkan {
+
+using jelly::core::Profiler;
+
+VulkanGpuTimer::VulkanGpuTimer(
+    VkDevice device,
+    float timestampPeriod,
+    uint32_t timestampValidBits,
+    uint32_t frameCount,
+    PFN_vkGetCalibratedTimestampsEXT getCalibratedTimestamps)
+    : device_(device),
+      nanosecondsPerTick_(timestampPeriod),
+      timestampMask_(timestampValidBits >= 64 ? ~uint64_t(0) : (uint64_t(1) << timestampValidBits) - 1),
+      getCalibratedTimestamps_(getCalibratedTimestamps),
+      profilerTrack_(Profiler::createTrack("GPU"))
+{
+    frames_.resize(frameCount);
+    results_.resize(MAX_COMMAND_BUFFERS * QUERIES_PER_COMMAND_BUFFER);
+
+    for (Frame& frame : frames_) {
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = MAX_COMMAND_BUFFERS * QUERIES_PER_COMMAND_BUFFER;
+
+        if (vkCreateQueryPool(device_, &poolInfo, nullptr, &frame.pool) != VK_SUCCESS) {
+            release();
+            throw Exception("Failed to create timestamp query pool!");
+        }
+    }
+}
+
+VulkanGpuTimer::~VulkanGpuTimer() {
+    release();
+}
+
+void VulkanGpuTimer::release() {
+    for (Frame& frame : frames_) {
+        if (frame.pool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device_, frame.pool, nullptr);
+            frame.pool = VK_NULL_HANDLE;
+        }
+    }
+    frames_.clear();
+}
+
+void VulkanGpuTimer::beginFrame(uint32_t frameIndex, uint64_t frameNumber) {
+    currentFrame_ = frameIndex;
+    Frame& frame = frames_[frameIndex];
+
+    // The slot's fence was just waited on, so its previous results are available
+    resolve(frame);
+
+    frame.scopes.clear();
+    std::fill(std::begin(frame.blockUsed), std::end(frame.blockUsed), 0u);
+    frame.blockCount = 0;
+    frame.frameNumber = frameNumber;
+    frame.submitTime = 0;
+}
+
+uint32_t VulkanGpuTimer::beginCommandBuffer(VkCommandBuffer commandBuffer) {
+    Frame& frame = frames_[currentFrame_];
+    if (frame.blockCount == MAX_COMMAND_BUFFERS) return INVALID_SCOPE;
+
+    const uint32_t block = frame.blockCount++;
+    vkCmdResetQueryPool(commandBuffer, frame.pool, block * QUERIES_PER_COMMAND_BUFFER, QUERIES_PER_COMMAND_BUFFER);
+    frame.recorded = true;
+    return block;
+}
+
+uint32_t VulkanGpuTimer::beginScope(VkCommandBuffer commandBuffer, uint32_t block, const char* name) {
+    Frame& frame = frames_[currentFrame_];
+    if (block >= frame.blockCount || frame.blockUsed[block] + 2 > QUERIES_PER_COMMAND_BUFFER) {
+        return INVALID_SCOPE;
+    }
+
+    Scope scope;
+    scope.name = name;
+    scope.beginQuery = block * QUERIES_PER_COMMAND_BUFFER + frame.blockUsed[block]++;
+
+    // Keep room for the end timestamp
+    frame.blockUsed[block]++;
+    scope.endQuery = scope.beginQuery + 1;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.pool, scope.beginQuery);
+
+    frame.scopes.push_back(scope);
+    return static_cast<uint32_t>(frame.scopes.size() - 1);
+}
+
+void VulkanGpuTimer::endScope(VkCommandBuffer commandBuffer, uint32_t scope) {
+    Frame& frame = frames_[currentFrame_];
+    if (scope >= frame.scopes.size()) return;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.pool, frame.scopes[scope].endQuery);
+}
+
+void VulkanGpuTimer::setSubmitTime(uint64_t profilerTime) {
+    frames_[currentFrame_].submitTime = profilerTime;
+}
+
+bool VulkanGpuTimer::getLastFrameStats(GpuFrameStats& stats) const {
+    if (!hasStats_) return false;
+    stats = lastStats_;
+    return true;
+}
+
+void VulkanGpuTimer::resolve(Frame& frame) {
+    if (!frame.recorded) return;
+    frame.recorded = false;
+
+    // Only the written range of each block; an unwritten query would make the call return VK_NOT_READY
+    for (uint32_t block = 0; block < frame.blockCount; ++block) {
+        const uint32_t used = frame.blockUsed[block];
+        if (used == 0) continue;
+
+        const uint32_t first = block * QUERIES_PER_COMMAND_BUFFER;
+        VkResult result = vkGetQueryPoolResults(
+            device_, frame.pool, first, used,
+            used * sizeof(uint64_t), &results_[first], sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT
+        );
+
+        if (result != VK_SUCCESS) return;
+    }
+
+    if (frame.scopes.empty()) return;
+
+    uint64_t frameBegin = UINT64_MAX;
+    uint64_t frameEnd = 0;
+    for (const Scope& scope : frame.scopes) {
+        frameBegin = std::min(frameBegin, results_[scope.beginQuery] & timestampMask_);
+        frameEnd = std::max(frameEnd, results_[scope.endQuery] & timestampMask_);
+    }
+
+    auto toMilliseconds = [this](uint64_t ticks) {
+        return static_cast<double>(ticks) * nanosecondsPerTick_ * 1e-6;
+    };
+
+    lastStats_.frameNumber = frame.frameNumber;
+    lastStats_.frameMs = toMilliseconds((frameEnd - frameBegin) & timestampMask_);
+    lastStats_.scopes.clear();
+
+    for (const Scope& scope : frame.scopes) {
+        const uint64_t begin = results_[scope.beginQuery] & timestampMask_;
+        const uint64_t end = results_[scope.endQuery] & timestampMask_;
+
+        GpuScopeTiming timing;
+        timing.name = scope.name;
+        timing.startMs = toMilliseconds((begin - frameBegin) & timestampMask_);
+        timing.durationMs = toMilliseconds((end - begin) & timestampMask_);
+        lastStats_.scopes.push_back(timing);
+    }
+    hasStats_ = true;
+
+    if (!Profiler::isCapturing()) return;
+
+    // Profiler time of the frame's first timestamp
+    int64_t gpuZero = 0;
+    const uint64_t frameBeginTime = calibrate(gpuZero)
+        ? static_cast<uint64_t>(gpuZero + static_cast<int64_t>(static_cast<double>(frameBegin) * nanosecondsPerTick_))
+        : frame.submitTime;
+
+    for (const GpuScopeTiming& timing : lastStats_.scopes) {
+        const uint64_t start = frameBeginTime + static_cast<uint64_t>(timing.startMs * 1e6);
+        Profiler::recordOnTrack(profilerTrack_, timing.name, start, start + static_cast<uint64_t>(timing.durationMs * 1e6));
+    }
+}
+
+bool VulkanGpuTimer::calibrate(int64_t& gpuZeroProfilerTime) const {
+    if (!getCalibratedTimestamps_) return false;
+
+    VkCalibratedTimestampInfoEXT infos[2]{};
+    infos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+    infos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    infos[1].timeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+
+    uint64_t timestamps[2] = {};
+    uint64_t maxDeviation = 0;
+    if (getCalibratedTimestamps_(device_, 2, infos, timestamps, &maxDeviation) != VK_SUCCESS) {
+        return false;
+    }
+
+    // steady_clock counts CLOCK_MONOTONIC on the platforms the extension is enabled for
+    const uint64_t hostTime = Profiler::fromSteadyClock(
+        std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(timestamps[1]))));
+    const double gpuTime = static_cast<double>(timestamps[0] & timestampMask_) * nanosecondsPerTick_;
+
+    gpuZeroProfilerTime = static_cast<int64_t>(hostTime) - static_cast<int64_t>(gpuTime);
+    return true;
+}
+
+} // namespace jelly::graphics::vulkan
@@ -6,6 +6,10 @@
 #include "jelly/graphics/shader_factory.hpp"
 #include "jelly/graphics/material_factory.hpp"
 #include "jelly/graphics/texture_factory.hpp"
+#include "jelly/core/frame_timings.hpp"
+#include "jelly/core/profiler.hpp"
+
+#include <optional>
 
 namespace jelly::graphics::vulkan {
 
@@ -38,6 +42,24 @@ void VulkanGraphicAPI::initialize() {
         Error::Print(e);
     }
 
+    try {
+        createPipelineCache();
+    } catch (const Exception& e) {
+        Error::Print(e);
+    }
+
+    try {
+        createPipelineRegistry();
+    } catch (const Exception& e) {
+        Error::Print(e);
+    }
+
+    try {
+        createMemoryAllocator();
+    } catch (const Exception& e) {
+        Error::Print(e);
+    }
+
     try {
         createSwapchain();
     } catch (const Exception& e) {
@@ -85,26 +107,70 @@ void VulkanGraphicAPI::initialize() {
     } catch (const Exception& e) {
         Error::Print(e);
     }
+
+    try {
+        createRingBuffers();
+    } catch (const Exception& e) {
+        Error::Print(e);
+    }
+
+    try {
+        createParallelRecorder();
+    } catch (const Exception& e) {
+        Error::Print(e);
+    }
+
+    try {
+        createStagingUploader();
+    } catch (const Exception& e) {
+        Error::Print(e);
+    }
+
+    try {
+        createGeometryArena();
+    } catch (const Exception& e) {
+        Error::Print(e);
+    }
+
+    try {
+        createGpuCuller();
+    } catch (const Exception& e) {
+        Error::Print(e);
+    }
+
+    try {
+        createGpuTimer();
+    } catch (const Exception& e) {
+        Error::Print(e);
+    }
 }
 
 void VulkanGraphicAPI::beginFrame() {
+    JELLY_PROFILE_SCOPE("VulkanGraphicAPI::beginFrame");
+    std::optional<core::ScopedFrameTiming> waitTiming(std::in_place, core::FramePhase::Present);
+
     vkWaitForFences(device_, 1, &inFlightFences_[currentFrame_], VK_TRUE, UINT64_MAX);
 
-    uint32_t imageIndex = 0;
-    VkResult result = vkAcquireNextImageKHR(
-        device_,
-        swapchain_,
-        UINT64_MAX,
-        imageAvailableSemaphores_[currentFrame_],
-        VK_NULL_HANDLE,
-        &imageIndex
-    );
-
-    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-        recreateSwapchain();
-        return;
-    } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-        throw Exception("Failed to acquire swap chain image!");
+    uint32_t imageIndex = static_cast<uint32_t>(currentFrame_);
+    VkResult result = offscreen_ ? VK_SUCCESS : VK_ERROR_OUT_OF_DATE_KHR;
+
+    // Offscreen frames render into a fixed target per frame slot. A stale swapchain
+    // is rebuilt and acquired again so the frame always has a command buffer to record into
+    while (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        result = vkAcquireNextImageKHR(
+            device_,
+            swapchain_,
+            UINT64_MAX,
+            imageAvailableSemaphores_[currentFrame_],
+            VK_NULL_HANDLE,
+            &imageIndex
+        );
+
+        if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+            recreateSwapchain();
+        } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+            throw Exception("Failed to acquire swap chain image!");
+        }
     }
 
     currentImageIndex_ = imageIndex;
@@ -116,30 +182,82 @@ void VulkanGraphicAPI::beginFrame() {
     imagesInFlight_[currentImageIndex_] = inFlightFences_[currentFrame_];
 
     vkResetFences(device_, 1, &inFlightFences_[currentFrame_]);
+    waitTiming.reset();
+
+    if (gpuTimer_) {
+        gpuTimer_->beginFrame(static_cast<uint32_t>(currentFrame_), frameNumber_);
+    }
+
+    uniformRingBuffer_->beginFrame(static_cast<uint32_t>(currentFrame_));
+    instanceRingBuffer_->beginFrame(static_cast<uint32_t>(currentFrame_));
+    indirectRingBuffer_->beginFrame(static_cast<uint32_t>(currentFrame_));
+
+    if (geometryArena_) {
+        geometryArena_->beginFrame(static_cast<uint32_t>(currentFrame_));
+    }
+
+    if (parallelRecorder_) {
+        parallelRecorder_->beginFrame(static_cast<uint32_t>(currentFrame_));
+    }
 
     beginCommandBuffer(commandBuffers_[currentImageIndex_], currentImageIndex_);
 }
 
 
 void VulkanGraphicAPI::endFrame() {
+    JELLY_PROFILE_SCOPE("VulkanGraphicAPI::endFrame");
+    std::optional<core::ScopedFrameTiming> submitTiming(std::in_place, core::FramePhase::Submit);
+
     endCommandBuffer(commandBuffers_[currentImageIndex_]);
 
+    VkSemaphore waitSemaphores[3] = { imageAvailableSemaphores_[currentFrame_] };
+    VkPipelineStageFlags waitStages[3] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    uint32_t waitCount = offscreen_ ? 0 : 1; // Offscreen targets are never acquired
+
+    // Meshes uploaded since the last frame must land before vertex input
+    VkSemaphore uploadSemaphore = stagingUploader_->flush(inFlightFences_[currentFrame_]);
+    if (uploadSemaphore != VK_NULL_HANDLE) {
+        waitSemaphores[waitCount] = uploadSemaphore;
+        waitStages[waitCount++] = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    }
+
+    // The culling pass writes the indirect commands and the culled instance stream
+    VkSemaphore cullSemaphore = gpuCuller_ ? gpuCuller_->submit(graphicsQueue_) : VK_NULL_HANDLE;
+    if (cullSemaphore != VK_NULL_HANDLE) {
+        waitSemaphores[waitCount] = cullSemaphore;
+        waitStages[waitCount++] = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    }
+
     VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-    VkSemaphore waitSemaphores[]  = { imageAvailableSemaphores_[currentFrame_] };
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
     VkSemaphore signalSemaphores[] = { renderFinishedSemaphoresPerImage_[currentImageIndex_] };
 
-    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.waitSemaphoreCount = waitCount;
     submitInfo.pWaitSemaphores    = waitSemaphores;
     submitInfo.pWaitDstStageMask  = waitStages;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers    = &commandBuffers_[currentImageIndex_];
-    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.signalSemaphoreCount = offscreen_ ? 0 : 1;
     submitInfo.pSignalSemaphores    = signalSemaphores;
 
     if (vkQueueSubmit(graphicsQueue_, 1, &submitInfo, inFlightFences_[currentFrame_]) != VK_SUCCESS) {
         throw Exception("Failed to submit draw command buffer!");
     }
+    submitTiming.reset();
+
+    if (gpuTimer_) {
+        gpuTimer_->setSubmitTime(core::Profiler::now());
+    }
+    ++frameNumber_;
+
+    if (offscreen_) {
+        if (offscreenReadback_) {
+            readbackFrame_ = static_cast<int>(currentFrame_);
+        }
+        currentFrame_ = (currentFrame_ + 1) % framesInFlight_;
+        return;
+    }
+
+    core::ScopedFrameTiming presentTiming(core::FramePhase::Present);
 
     VkSwapchainKHR swapchains[] = { swapchain_.get() };
 
@@ -157,7 +275,7 @@ void VulkanGraphicAPI::endFrame() {
         throw Exception("Failed to present swap chain image!");
     }
 
-    currentFrame_ = (currentFrame_ + 1) % maxFramesInFlight_;
+    currentFrame_ = (currentFrame_ + 1) % framesInFlight_;
 }
 
 void VulkanGraphicAPI::shutdown() {
@@ -165,11 +283,33 @@ void VulkanGraphicAPI::shutdown() {
         vkDeviceWaitIdle(device_);
     }
 
+    // Background compiles still reference shaders about to be released
+    if (pipelineRegistry_) {
+        pipelineRegistry_->waitForCompiles();
+    }
+
     jelly::graphics::MeshFactory::releaseAll();
     jelly::graphics::ShaderFactory::releaseAll();
     jelly::graphics::MaterialFactory::releaseAll();
     jelly::graphics::TextureFactory::releaseAll();
 
+    destroyPipelineRegistry();
+    savePipelineCache();
+    pipelineCache_.reset();
+
+    gpuCuller_.reset();
+    gpuTimer_.reset();
+    geometryArena_.reset();
+    stagingUploader_.reset();
+
+    uniformRingBuffer_.reset();
+    instanceRingBuffer_.reset();
+    indirectRingBuffer_.reset();
+    parallelRecorder_.reset();
+
+    destroyDepthResources();
+    destroyOffscreenTargets();
+
     for (VkSemaphore sem : imageAvailableSemaphores_)
         if (sem) vkDestroySemaphore(device_, sem, nullptr);
 
@@ -210,6 +350,8 @@ void VulkanGraphicAPI::shutdown() {
     commandPool_.reset();
     commandBuffers_.clear();
 
+    memoryAllocator_.reset();
+
     device_.reset();
 
     surface_.reset();
@@ -29,6 +29,12 @@ void VulkanGraphicAPI::beginCommandBuffer(VkCommandBuffer commandBuffer, uint32_
     vkResetCommandBuffer(commandBuffer, 0);
     vkBeginCommandBuffer(commandBuffer, &beginInfo);
 
+    if (gpuTimer_) {
+        gpuTimerBlock_ = gpuTimer_->beginCommandBuffer(commandBuffer);
+        frameScope_ = gpuTimer_->beginScope(commandBuffer, gpuTimerBlock_, "Frame");
+        renderPassScope_ = gpuTimer_->beginScope(commandBuffer, gpuTimerBlock_, "RenderPass");
+    }
+
     VkRenderPassBeginInfo renderPassInfo{VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
     renderPassInfo.renderPass = renderPass_;
     renderPassInfo.framebuffer = swapchainFramebuffers_[imageIndex];
@@ -42,11 +48,52 @@ void VulkanGraphicAPI::beginCommandBuffer(VkCommandBuffer commandBuffer, uint32_
     renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
     renderPassInfo.pClearValues = clearValues.data();
 
+    // Secondaries recorded by the workers hold every draw of the pass
+    if (parallelRecorder_) {
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        return;
+    }
+
     vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    bindFrameState(commandBuffer);
+}
+
+void VulkanGraphicAPI::bindFrameState(VkCommandBuffer commandBuffer) {
+    // Per-instance stream stays bound for the whole frame; draws select it via firstInstance
+    VkBuffer instanceBuffer = instanceRingBuffer_->getBuffer(static_cast<uint32_t>(currentFrame_));
+    VkDeviceSize instanceOffset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, INSTANCE_BINDING, 1, &instanceBuffer, &instanceOffset);
+
+    // Dynamic in every pipeline, so a resize never forces a recompile.
+    // Negative height flips Y to match the engine's clip space.
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = static_cast<float>(swapchainExtent_.height);
+    viewport.width = static_cast<float>(swapchainExtent_.width);
+    viewport.height = -static_cast<float>(swapchainExtent_.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{{0, 0}, swapchainExtent_};
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 }
 
 void VulkanGraphicAPI::endCommandBuffer(VkCommandBuffer commandBuffer) {
     vkCmdEndRenderPass(commandBuffer);
+
+    if (gpuTimer_) {
+        gpuTimer_->endScope(commandBuffer, renderPassScope_);
+    }
+
+    if (offscreenReadback_) {
+        recordFrameReadback(commandBuffer);
+    }
+
+    if (gpuTimer_) {
+        gpuTimer_->endScope(commandBuffer, frameScope_);
+    }
+
     vkEndCommandBuffer(commandBuffer);
 }
 
@@ -6,19 +6,6 @@
 
 namespace jelly::graphics::vulkan {
 
-uint32_t VulkanGraphicAPI::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice_, &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-
-    throw std::runtime_error("Failed to find suitable memory type!");
-}
-
 void VulkanGraphicAPI::createDepthResources() {
     VkFormat depthFormat = findDepthFormat();
 
@@ -41,19 +28,7 @@ void VulkanGraphicAPI::createDepthResources() {
         throw Exception("Failed to create depth image!");
     }
 
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(device_, depthImage_, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(device_, &allocInfo, nullptr, &depthImageMemory_) != VK_SUCCESS) {
-        throw Exception("Failed to allocate depth image memory!");
-    }
-
-    vkBindImageMemory(device_, depthImage_, depthImageMemory_, 0);
+    depthImageMemory_ = memoryAllocator_->allocateForImage(depthImage_, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -71,4 +46,19 @@ void VulkanGraphicAPI::createDepthResources() {
     }
 }
 
+void VulkanGraphicAPI::destroyDepthResources() {
+    if (depthImageView_ != VK_NULL_HANDLE) {
+        vkDestroyImageView(device_, depthImageView_, nullptr);
+        depthImageView_ = VK_NULL_HANDLE;
+    }
+
+    if (depthImage_ != VK_NULL_HANDLE) {
+        vkDestroyImage(device_, depthImage_, nullptr);
+        depthImage_ = VK_NULL_HANDLE;
+    }
+
+    memoryAllocator_->free(depthImageMemory_);
+    depthImageMemory_ = nullptr;
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace jelly::graphics::vulkan {
+
+static_assert(sizeof(DrawIndexedCommand) == sizeof(VkDrawIndexedIndirectCommand),
+    "DrawIndexedCommand must match VkDrawIndexedIndirectCommand");
+
+void VulkanGraphicAPI::createGeometryArena() {
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice_, &properties);
+    maxDrawIndirectCount_ = multiDrawIndirect_ ? std::max(properties.limits.maxDrawIndirectCount, 1u) : 1;
+
+    geometryArena_ = std::make_unique<VulkanGeometryArena>(
+        device_.get(),
+        *memoryAllocator_,
+        *stagingUploader_,
+        geometryArenaVertexCapacity_,
+        geometryArenaIndexCapacity_,
+        framesInFlight_
+    );
+}
+
+bool VulkanGraphicAPI::bindSharedGeometry() {
+    if (!geometryArena_) return false;
+
+    geometryArena_->bind(getCurrentCommandBuffer());
+    return true;
+}
+
+uint32_t VulkanGraphicAPI::drawIndexedIndirect(const DrawIndexedCommand* commands, uint32_t commandCount) {
+    if (commandCount == 0) return 0;
+
+    VkCommandBuffer commandBuffer = getCurrentCommandBuffer();
+
+    // Indirect draws would all start at instance 0 and read the wrong matrices
+    if (!drawIndirectFirstInstance_) {
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            const DrawIndexedCommand& command = commands[i];
+            vkCmdDrawIndexed(commandBuffer, command.indexCount, command.instanceCount,
+                command.firstIndex, command.vertexOffset, command.firstInstance);
+        }
+        return commandCount;
+    }
+
+    constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    const VkDeviceSize size = static_cast<VkDeviceSize>(commandCount) * stride;
+
+    RingAllocation slice;
+    {
+        std::lock_guard<std::mutex> lock(indirectMutex_);
+        slice = indirectRingBuffer_->allocate(size);
+    }
+    memcpy(slice.data, commands, static_cast<size_t>(size));
+
+    uint32_t drawCalls = 0;
+    for (uint32_t first = 0; first < commandCount; first += maxDrawIndirectCount_) {
+        const uint32_t count = std::min(commandCount - first, maxDrawIndirectCount_);
+        vkCmdDrawIndexedIndirect(commandBuffer, slice.buffer, slice.offset + first * stride, count, stride);
+        ++drawCalls;
+    }
+    return drawCalls;
+}
+
+}
@@ -0,0 +1,83 @@
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+
+#include "jelly/core/logger.hpp"
+#include "jelly/graphics/shader_factory.hpp"
+
+namespace jelly::graphics::vulkan {
+
+void VulkanGraphicAPI::createGpuCuller() {
+    gpuCuller_.reset();
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &familyCount, families.data());
+
+    const bool computeOnGraphicsQueue = (families[graphicsFamily_].queueFlags & VK_QUEUE_COMPUTE_BIT) != 0;
+    if (!cmdDrawIndexedIndirectCount_ || !drawIndirectFirstInstance_ || !computeOnGraphicsQueue) {
+        core::Logger::Log(core::LogLevel::Info, "GPU culling unsupported by the device, culling on the CPU");
+        return;
+    }
+
+    std::vector<uint8_t> code;
+    try {
+        code = ShaderFactory::readStageBinary("gpu_cull", "compute", "vulkan");
+    } catch (const std::exception&) {
+        core::Logger::Log(core::LogLevel::Warning, "GPU culling shader not found, culling on the CPU");
+        return;
+    }
+
+    gpuCuller_ = std::make_unique<VulkanGpuCuller>(
+        device_.get(),
+        *memoryAllocator_,
+        graphicsFamily_,
+        code,
+        cmdDrawIndexedIndirectCount_,
+        framesInFlight_
+    );
+}
+
+void VulkanGraphicAPI::beginGpuCulling(const float* frustumPlanes) {
+    gpuCuller_->begin(static_cast<uint32_t>(currentFrame_), frustumPlanes);
+}
+
+uint32_t VulkanGraphicAPI::addCulledBucket() {
+    return gpuCuller_->addBucket();
+}
+
+void VulkanGraphicAPI::addCulledDraw(
+    uint32_t bucket, const CulledDrawDesc& draw, const float* worldMatrices, uint32_t instanceCount)
+{
+    gpuCuller_->addDraw(bucket, draw, worldMatrices, instanceCount);
+}
+
+void VulkanGraphicAPI::dispatchGpuCulling() {
+    gpuCuller_->dispatch();
+}
+
+uint32_t VulkanGraphicAPI::drawCulledBucket(uint32_t bucket) {
+    VkCommandBuffer commandBuffer = getCurrentCommandBuffer();
+
+    gpuCuller_->drawBucket(commandBuffer, bucket, INSTANCE_BINDING);
+
+    // Later draws read the frame's instance ring again
+    bindFrameState(commandBuffer);
+    return 1;
+}
+
+void VulkanGraphicAPI::setGpuCullingReadback(bool enabled) {
+    if (!gpuCuller_) return;
+
+    vkDeviceWaitIdle(device_.get());
+    gpuCuller_->setHostReadable(enabled);
+}
+
+bool VulkanGraphicAPI::readGpuCullingResults(GpuCullingResults& results) {
+    if (!gpuCuller_ || !gpuCuller_->hasResults()) return false;
+
+    // The pass is submitted ahead of its frame, whose fence covers both
+    vkWaitForFences(device_.get(), 1, &inFlightFences_[gpuCuller_->getFrameIndex()], VK_TRUE, UINT64_MAX);
+    return gpuCuller_->readResults(results);
+}
+
+} // namespace jelly::graphics::vulkan
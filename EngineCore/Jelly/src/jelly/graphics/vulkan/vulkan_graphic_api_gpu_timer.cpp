@@ -0,0 +1,54 @@
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+
+#include "jelly/core/logger.hpp"
+
+namespace jelly::graphics::vulkan {
+
+void VulkanGraphicAPI::createGpuTimer() {
+    gpuTimer_.reset();
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &familyCount, families.data());
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice_, &properties);
+
+    const uint32_t validBits = families[graphicsFamily_].timestampValidBits;
+    if (validBits == 0 || properties.limits.timestampPeriod <= 0.0f) {
+        core::Logger::Log(core::LogLevel::Info, "Timestamps unsupported by the graphics queue, GPU timing disabled");
+        return;
+    }
+
+    gpuTimer_ = std::make_unique<VulkanGpuTimer>(
+        device_.get(),
+        properties.limits.timestampPeriod,
+        validBits,
+        framesInFlight_,
+        getCalibratedTimestamps_
+    );
+
+    if (gpuCuller_) {
+        gpuCuller_->setGpuTimer(gpuTimer_.get());
+    }
+}
+
+uint32_t VulkanGraphicAPI::beginGpuScope(const char* name) {
+    // Timestamps cannot be written in the primary while the pass expects secondaries
+    if (!gpuTimer_ || parallelRecorder_) return VulkanGpuTimer::INVALID_SCOPE;
+
+    return gpuTimer_->beginScope(commandBuffers_[currentImageIndex_], gpuTimerBlock_, name);
+}
+
+void VulkanGraphicAPI::endGpuScope(uint32_t scope) {
+    if (!gpuTimer_ || parallelRecorder_) return;
+
+    gpuTimer_->endScope(commandBuffers_[currentImageIndex_], scope);
+}
+
+bool VulkanGraphicAPI::getGpuFrameStats(GpuFrameStats& stats) const {
+    return gpuTimer_ && gpuTimer_->getLastFrameStats(stats);
+}
+
+} // namespace jelly::graphics::vulkan
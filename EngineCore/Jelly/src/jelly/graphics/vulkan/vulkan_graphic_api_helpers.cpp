@@ -45,8 +45,12 @@ QueueFamilyIndices VulkanGraphicAPI::findQueueFamilies(VkPhysicalDevice device,
         if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
             indices.graphicsFamily = i;
 
+        // Without a surface nothing is presented; the graphics family stands in
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+        if (surface != VK_NULL_HANDLE)
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+        else
+            presentSupport = (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) ? VK_TRUE : VK_FALSE;
         if (presentSupport)
             indices.presentFamily = i;
 
@@ -54,6 +58,20 @@ QueueFamilyIndices VulkanGraphicAPI::findQueueFamilies(VkPhysicalDevice device,
             break;
     }
 
+    // A family without graphics or compute usually maps to the DMA engine
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const VkQueueFlags flags = families[i].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+        {
+            indices.transferFamily = i;
+            break;
+        }
+    }
+
+    if (!indices.transferFamily.has_value())
+        indices.transferFamily = indices.graphicsFamily;
+
     return indices;
 }
 
@@ -70,9 +88,28 @@ VkSurfaceFormatKHR VulkanGraphicAPI::chooseSurfaceFormat(const std::vector<VkSur
 
 VkPresentModeKHR VulkanGraphicAPI::choosePresentMode(const std::vector<VkPresentModeKHR> &modes)
 {
-    for (VkPresentModeKHR m : modes)
-        if (m == VK_PRESENT_MODE_MAILBOX_KHR) // triplo buffering, suave
-            return m;
+    auto supported = [&modes](VkPresentModeKHR mode) {
+        return std::find(modes.begin(), modes.end(), mode) != modes.end();
+    };
+
+    switch (presentMode_)
+    {
+    case core::PresentMode::Immediate:
+        if (supported(VK_PRESENT_MODE_IMMEDIATE_KHR)) // sem vsync, menor latência
+            return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        break;
+    case core::PresentMode::FifoRelaxed:
+        if (supported(VK_PRESENT_MODE_FIFO_RELAXED_KHR)) // quadro atrasado é exibido na hora
+            return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        break;
+    case core::PresentMode::Mailbox:
+    case core::PresentMode::Auto:
+        if (supported(VK_PRESENT_MODE_MAILBOX_KHR)) // triplo buffering, suave
+            return VK_PRESENT_MODE_MAILBOX_KHR;
+        break;
+    case core::PresentMode::Fifo:
+        break;
+    }
     return VK_PRESENT_MODE_FIFO_KHR; // vs-sync garantido, 100% compat.
 }
 
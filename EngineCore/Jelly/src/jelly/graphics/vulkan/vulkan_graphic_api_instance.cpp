@@ -36,7 +36,11 @@ bool checkValidationLayerSupport(const std::vector<const char*>& validationLayer
 
 void VulkanGraphicAPI::createInstance() {
 
-    std::vector<const char*> extensions = windowProvider_->getVulkanRequiredExtensions();
+    // Offscreen rendering needs no surface extensions
+    std::vector<const char*> extensions;
+    if (!offscreen_) {
+        extensions = windowProvider_->getVulkanRequiredExtensions();
+    }
 
     VkApplicationInfo appInfo{};
     appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -72,7 +76,7 @@ void VulkanGraphicAPI::createInstance() {
         createInfo.ppEnabledLayerNames = validationLayers.data();
         populateDebugCreateInfo(debugCreateInfo);
         createInfo.pNext = &debugCreateInfo;
-#elif
+#else
         createInfo.enabledLayerCount = 0;
         createInfo.ppEnabledLayerNames = nullptr;
         createInfo.pNext = nullptr;
@@ -2,6 +2,9 @@
 
 #include "jelly/exception.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace jelly::graphics::vulkan {
 
 void VulkanGraphicAPI::createLogicalDevice() {
@@ -9,7 +12,7 @@ void VulkanGraphicAPI::createLogicalDevice() {
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t> uniqueFamilies = {
-        indices.graphicsFamily.value(), indices.presentFamily.value()};
+        indices.graphicsFamily.value(), indices.presentFamily.value(), indices.transferFamily.value()};
 
     float queuePriority = 1.0f;
     for (uint32_t family : uniqueFamilies) {
@@ -21,7 +24,13 @@ void VulkanGraphicAPI::createLogicalDevice() {
         queueCreateInfos.push_back(queueInfo);
     }
 
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    vkGetPhysicalDeviceFeatures(physicalDevice_, &supportedFeatures);
+
+    // Merged draws of the shared geometry arena use these when available
     VkPhysicalDeviceFeatures deviceFeatures{};
+    deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+    deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -29,9 +38,59 @@ void VulkanGraphicAPI::createLogicalDevice() {
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
 
-    const char *extensions[] = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
-    createInfo.enabledExtensionCount = 1;
-    createInfo.ppEnabledExtensionNames = extensions;
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice_, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice_, nullptr, &extensionCount, availableExtensions.data());
+
+    auto isExtensionAvailable = [&availableExtensions](const char* name) {
+        for (const auto& extension : availableExtensions) {
+            if (std::strcmp(extension.extensionName, name) == 0) return true;
+        }
+        return false;
+    };
+
+    // GPU culling draws with vkCmdDrawIndexedIndirectCountKHR when the extension is there
+    const bool drawIndirectCountSupported = isExtensionAvailable(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+    // Pipeline compiles report whether they were served from the pipeline cache
+    const bool creationFeedbackSupported = isExtensionAvailable(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+
+    // GPU timestamps are mapped onto the profiler clock (steady_clock, CLOCK_MONOTONIC on Linux)
+    bool calibratedTimestampsSupported = false;
+#if defined(__linux__)
+    if (isExtensionAvailable(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)) {
+        auto getTimeDomains = reinterpret_cast<PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT>(
+            vkGetInstanceProcAddr(instance_, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT"));
+
+        if (getTimeDomains) {
+            uint32_t domainCount = 0;
+            getTimeDomains(physicalDevice_, &domainCount, nullptr);
+            std::vector<VkTimeDomainEXT> domains(domainCount);
+            getTimeDomains(physicalDevice_, &domainCount, domains.data());
+
+            calibratedTimestampsSupported =
+                std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_DEVICE_EXT) != domains.end() &&
+                std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT) != domains.end();
+        }
+    }
+#endif
+
+    std::vector<const char*> extensions;
+    if (!offscreen_) {
+        extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
+    if (drawIndirectCountSupported) {
+        extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    }
+    if (creationFeedbackSupported) {
+        extensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+    }
+    if (calibratedTimestampsSupported) {
+        extensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+    }
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
     VkDevice rawDevice = VK_NULL_HANDLE;
     if (vkCreateDevice(physicalDevice_, &createInfo, nullptr, &rawDevice) != VK_SUCCESS) {
@@ -46,6 +105,24 @@ void VulkanGraphicAPI::createLogicalDevice() {
 
     vkGetDeviceQueue(device_, indices.graphicsFamily.value(), 0, &graphicsQueue_);
     vkGetDeviceQueue(device_, indices.presentFamily.value(), 0, &presentQueue_);
+    vkGetDeviceQueue(device_, indices.transferFamily.value(), 0, &transferQueue_);
+
+    if (drawIndirectCountSupported) {
+        cmdDrawIndexedIndirectCount_ = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+            vkGetDeviceProcAddr(device_, "vkCmdDrawIndexedIndirectCountKHR"));
+    }
+
+    if (calibratedTimestampsSupported) {
+        getCalibratedTimestamps_ = reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT>(
+            vkGetDeviceProcAddr(device_, "vkGetCalibratedTimestampsEXT"));
+    }
+
+    pipelineCreationFeedback_ = creationFeedbackSupported;
+    multiDrawIndirect_ = deviceFeatures.multiDrawIndirect == VK_TRUE;
+    drawIndirectFirstInstance_ = deviceFeatures.drawIndirectFirstInstance == VK_TRUE;
+
+    graphicsFamily_ = indices.graphicsFamily.value();
+    transferFamily_ = indices.transferFamily.value();
 }
 
 }
\ No newline at end of file
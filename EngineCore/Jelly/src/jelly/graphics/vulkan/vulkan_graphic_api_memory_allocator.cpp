@@ -0,0 +1,9 @@
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+
+namespace jelly::graphics::vulkan {
+
+void VulkanGraphicAPI::createMemoryAllocator() {
+    memoryAllocator_ = std::make_unique<VulkanMemoryAllocator>(device_.get(), physicalDevice_.get());
+}
+
+}
@@ -0,0 +1,150 @@
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+#include "jelly/graphics/vulkan/vulkan_buffer_utils.hpp"
+
+#include "jelly/exception.hpp"
+#include "jelly/core/logger.hpp"
+
+#include <cstring>
+
+namespace jelly::graphics::vulkan {
+
+using jelly::core::Logger;
+using jelly::core::LogLevel;
+
+bool VulkanGraphicAPI::setOffscreenTarget(uint32_t width, uint32_t height, bool readback) {
+    offscreen_ = true;
+    offscreenReadback_ = readback;
+    swapchainExtent_ = { width, height };
+    return true;
+}
+
+void VulkanGraphicAPI::createOffscreenTargets() {
+    swapchainImageFormat_ = offscreenFormat_;
+
+    // One target per frame in flight: frame N always renders into image N, guarded by its fence
+    swapchainImages_.assign(framesInFlight_, VK_NULL_HANDLE);
+    offscreenImageMemory_.assign(framesInFlight_, nullptr);
+
+    for (size_t i = 0; i < swapchainImages_.size(); ++i) {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = swapchainExtent_.width;
+        imageInfo.extent.height = swapchainExtent_.height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = offscreenFormat_;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateImage(device_, &imageInfo, nullptr, &swapchainImages_[i]) != VK_SUCCESS) {
+            throw Exception("Failed to create offscreen image!");
+        }
+
+        offscreenImageMemory_[i] = memoryAllocator_->allocateForImage(swapchainImages_[i], VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    if (offscreenReadback_) {
+        const VkDeviceSize size = VkDeviceSize(swapchainExtent_.width) * swapchainExtent_.height * 4;
+
+        readbackBuffers_.assign(framesInFlight_, VK_NULL_HANDLE);
+        readbackMemory_.assign(framesInFlight_, nullptr);
+
+        for (size_t i = 0; i < readbackBuffers_.size(); ++i) {
+            VulkanBufferUtils::createBuffer(
+                *memoryAllocator_,
+                device_,
+                size,
+                VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                readbackBuffers_[i],
+                readbackMemory_[i]
+            );
+        }
+    }
+
+    char message[96];
+    snprintf(message, sizeof(message), "Rendering offscreen at %ux%u%s",
+        swapchainExtent_.width, swapchainExtent_.height, offscreenReadback_ ? " with readback" : "");
+    Logger::Log(LogLevel::Info, message);
+}
+
+void VulkanGraphicAPI::destroyOffscreenTargets() {
+    for (size_t i = 0; i < offscreenImageMemory_.size(); ++i) {
+        if (swapchainImages_[i] != VK_NULL_HANDLE) {
+            vkDestroyImage(device_, swapchainImages_[i], nullptr);
+        }
+        memoryAllocator_->free(offscreenImageMemory_[i]);
+    }
+    offscreenImageMemory_.clear();
+    swapchainImages_.clear();
+
+    for (size_t i = 0; i < readbackBuffers_.size(); ++i) {
+        if (readbackBuffers_[i] != VK_NULL_HANDLE) {
+            vkDestroyBuffer(device_, readbackBuffers_[i], nullptr);
+        }
+        memoryAllocator_->free(readbackMemory_[i]);
+    }
+    readbackBuffers_.clear();
+    readbackMemory_.clear();
+    readbackFrame_ = -1;
+}
+
+void VulkanGraphicAPI::recordFrameReadback(VkCommandBuffer commandBuffer) {
+    // The render pass leaves the image in TRANSFER_SRC_OPTIMAL and its external
+    // dependency orders the color writes before this copy
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = { swapchainExtent_.width, swapchainExtent_.height, 1 };
+
+    vkCmdCopyImageToBuffer(
+        commandBuffer,
+        swapchainImages_[currentImageIndex_],
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        readbackBuffers_[currentFrame_],
+        1,
+        &region
+    );
+
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = readbackBuffers_[currentFrame_];
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        0, nullptr,
+        1, &barrier,
+        0, nullptr
+    );
+}
+
+bool VulkanGraphicAPI::readFramePixels(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) {
+    if (!offscreenReadback_ || readbackFrame_ < 0) return false;
+
+    vkWaitForFences(device_, 1, &inFlightFences_[readbackFrame_], VK_TRUE, UINT64_MAX);
+
+    width = swapchainExtent_.width;
+    height = swapchainExtent_.height;
+    pixels.resize(size_t(width) * height * 4);
+    std::memcpy(pixels.data(), readbackMemory_[readbackFrame_]->mapped, pixels.size());
+    return true;
+}
+
+}
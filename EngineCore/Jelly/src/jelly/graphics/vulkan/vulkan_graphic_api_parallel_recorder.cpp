@@ -0,0 +1,86 @@
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+
+#include "jelly/exception.hpp"
+
+namespace jelly::graphics::vulkan {
+
+namespace {
+
+// Secondary command buffer the calling worker is recording into, if any
+thread_local VkCommandBuffer threadCommandBuffer = VK_NULL_HANDLE;
+
+} // namespace
+
+void VulkanGraphicAPI::createParallelRecorder() {
+    parallelRecorder_.reset();
+
+    if (recordingThreadCount_ == 0) return;
+
+    QueueFamilyIndices queueFamilyIndices = findQueueFamilies(physicalDevice_, surface_);
+
+    parallelRecorder_ = std::make_unique<VulkanParallelRecorder>(
+        device_.get(),
+        queueFamilyIndices.graphicsFamily.value(),
+        recordingThreadCount_,
+        framesInFlight_
+    );
+}
+
+void VulkanGraphicAPI::setRecordingThreadCount(uint32_t count) {
+    if (count == recordingThreadCount_) return;
+
+    recordingThreadCount_ = count;
+
+    // Before initialize() the recorder is created with the rest of the device objects
+    if (device_ == VK_NULL_HANDLE) return;
+
+    // Worker pools may still own buffers of frames in flight
+    vkDeviceWaitIdle(device_);
+    createParallelRecorder();
+}
+
+VkCommandBuffer VulkanGraphicAPI::getCurrentCommandBuffer() const {
+    if (threadCommandBuffer != VK_NULL_HANDLE) {
+        return threadCommandBuffer;
+    }
+    return commandBuffers_[currentImageIndex_];
+}
+
+void VulkanGraphicAPI::recordDraws(uint32_t itemCount, const std::function<void(uint32_t begin, uint32_t end)>& record) {
+    if (!parallelRecorder_) {
+        record(0, itemCount);
+        return;
+    }
+
+    VkCommandBufferInheritanceInfo inheritance{};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = renderPass_;
+    inheritance.subpass = 0;
+    inheritance.framebuffer = swapchainFramebuffers_[currentImageIndex_];
+
+    secondaryCommandBuffers_.clear();
+
+    parallelRecorder_->record(
+        inheritance,
+        itemCount,
+        minDrawsPerRecordingThread_,
+        [this, &record](VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end) {
+            // Secondaries inherit no state from the primary
+            threadCommandBuffer = commandBuffer;
+            bindFrameState(commandBuffer);
+            record(begin, end);
+            threadCommandBuffer = VK_NULL_HANDLE;
+        },
+        secondaryCommandBuffers_
+    );
+
+    if (!secondaryCommandBuffers_.empty()) {
+        vkCmdExecuteCommands(
+            commandBuffers_[currentImageIndex_],
+            static_cast<uint32_t>(secondaryCommandBuffers_.size()),
+            secondaryCommandBuffers_.data()
+        );
+    }
+}
+
+} // namespace jelly::graphics::vulkan
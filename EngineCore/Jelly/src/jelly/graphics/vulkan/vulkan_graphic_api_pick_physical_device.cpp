@@ -25,15 +25,18 @@ void VulkanGraphicAPI::pickPhysicalDevice() {
             std::vector<VkExtensionProperties> availableExtensions(extCount);
             vkEnumerateDeviceExtensionProperties(device, nullptr, &extCount, availableExtensions.data());
 
-            std::set<std::string> requiredExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+            std::set<std::string> requiredExtensions;
+            if (!offscreen_) {
+                requiredExtensions.insert(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+            }
             for (const auto &ext : availableExtensions)
                 requiredExtensions.erase(ext.extensionName);
 
             extensionsSupported = requiredExtensions.empty();
         }
 
-        bool swapchainAdequate = false;
-        if (extensionsSupported) {
+        bool swapchainAdequate = offscreen_;
+        if (extensionsSupported && !offscreen_) {
             SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device, surface_);
             swapchainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
         }
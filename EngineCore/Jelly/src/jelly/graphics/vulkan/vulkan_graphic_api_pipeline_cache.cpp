@@ -0,0 +1,177 @@
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+
+#include "jelly/exception.hpp"
+#include "jelly/core/logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace jelly::graphics::vulkan {
+
+using jelly::core::Logger;
+using jelly::core::LogLevel;
+
+namespace {
+
+/// @brief Checks that a cache blob was written by this driver for this exact device
+bool isPipelineCacheCompatible(const std::vector<char>& data, const VkPhysicalDeviceProperties& properties) {
+    VkPipelineCacheHeaderVersionOne header{};
+    if (data.size() < sizeof(header)) return false;
+
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    return header.headerSize >= sizeof(header)
+        && header.headerSize <= data.size()
+        && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        && header.vendorID == properties.vendorID
+        && header.deviceID == properties.deviceID
+        && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+std::vector<char> readCacheFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return {};
+
+    std::vector<char> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) return {};
+
+    return data;
+}
+
+}
+
+void VulkanGraphicAPI::createPipelineCache() {
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice_, &properties);
+
+    // One file per device and driver, so switching GPUs or updating drivers never loads a stale blob
+    std::string deviceKey;
+    char hex[3];
+    for (uint8_t byte : properties.pipelineCacheUUID) {
+        snprintf(hex, sizeof(hex), "%02x", byte);
+        deviceKey += hex;
+    }
+    pipelineCachePath_ = std::filesystem::path("cache") /
+        ("pipeline_cache_" + deviceKey + "_" + std::to_string(properties.driverVersion) + ".bin");
+
+    std::vector<char> initialData = readCacheFile(pipelineCachePath_);
+    if (!initialData.empty() && !isPipelineCacheCompatible(initialData, properties)) {
+        Logger::Log(LogLevel::Warning, "Discarding incompatible pipeline cache " + pipelineCachePath_.string());
+        initialData.clear();
+    }
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = initialData.size();
+    createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    VkPipelineCache rawCache = VK_NULL_HANDLE;
+    VkResult result = vkCreatePipelineCache(device_, &createInfo, nullptr, &rawCache);
+
+    // Drivers may still reject a blob that passed the header check
+    if (result != VK_SUCCESS && !initialData.empty()) {
+        Logger::Log(LogLevel::Warning, "Driver rejected pipeline cache " + pipelineCachePath_.string());
+        initialData.clear();
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache(device_, &createInfo, nullptr, &rawCache);
+    }
+
+    if (result != VK_SUCCESS) {
+        throw jelly::Exception("Failed to create pipeline cache!");
+    }
+
+    VkDevice device = device_.get();
+    pipelineCache_ = ManagedResource<VkPipelineCache>(
+        rawCache,
+        [device](VkPipelineCache cache) { vkDestroyPipelineCache(device, cache, nullptr); },
+        VK_NULL_HANDLE
+    );
+
+    if (!initialData.empty()) {
+        Logger::Log(LogLevel::Info, "Pipeline cache loaded (" + std::to_string(initialData.size()) + " bytes)");
+    }
+}
+
+void VulkanGraphicAPI::savePipelineCache() {
+    if (pipelineCache_.get() == VK_NULL_HANDLE) return;
+
+    const uint32_t compiles = pipelineCompileCount_.load();
+    const uint32_t hits = pipelineCacheHitCount_.load();
+    const double compileMilliseconds = static_cast<double>(pipelineCompileNanoseconds_.load()) / 1.0e6;
+
+    char message[160];
+    if (pipelineCreationFeedback_) {
+        snprintf(message, sizeof(message),
+            "Pipeline cache: %u compiles, %u hits (%.1f%%), %.2f ms compiling",
+            compiles, hits, compiles ? 100.0 * hits / compiles : 0.0, compileMilliseconds);
+    } else {
+        snprintf(message, sizeof(message),
+            "Pipeline cache: %u compiles, hit rate unavailable, %.2f ms compiling",
+            compiles, compileMilliseconds);
+    }
+    Logger::Log(LogLevel::Info, message);
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(device_, pipelineCache_, &size, nullptr) != VK_SUCCESS || size == 0) return;
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(device_, pipelineCache_, &size, data.data()) != VK_SUCCESS) return;
+
+    // Write next to the target and rename, so a crash mid-write never leaves a truncated cache
+    std::error_code error;
+    std::filesystem::create_directories(pipelineCachePath_.parent_path(), error);
+
+    std::filesystem::path tempPath = pipelineCachePath_;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.write(data.data(), static_cast<std::streamsize>(size))) {
+            Logger::Log(LogLevel::Warning, "Failed to write pipeline cache " + tempPath.string());
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempPath, pipelineCachePath_, error);
+    if (error) {
+        Logger::Log(LogLevel::Warning, "Failed to save pipeline cache " + pipelineCachePath_.string());
+    }
+}
+
+VkPipeline VulkanGraphicAPI::compileGraphicsPipeline(const VkGraphicsPipelineCreateInfo& createInfo) {
+    VkGraphicsPipelineCreateInfo info = createInfo;
+
+    VkPipelineCreationFeedbackEXT feedback{};
+    VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{};
+    if (pipelineCreationFeedback_) {
+        feedbackInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+        feedbackInfo.pNext = info.pNext;
+        feedbackInfo.pPipelineCreationFeedback = &feedback;
+        info.pNext = &feedbackInfo;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(device_, pipelineCache_, 1, &info, nullptr, &pipeline) != VK_SUCCESS) {
+        throw jelly::Exception("Failed to create graphics pipeline!");
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    pipelineCompileNanoseconds_ += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    ++pipelineCompileCount_;
+
+    if ((feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) &&
+        (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT)) {
+        ++pipelineCacheHitCount_;
+    }
+
+    return pipeline;
+}
+
+}
@@ -0,0 +1,25 @@
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+
+#include "jelly/core/logger.hpp"
+
+namespace jelly::graphics::vulkan {
+
+void VulkanGraphicAPI::createPipelineRegistry() {
+    pipelineRegistry_ = std::make_unique<VulkanPipelineRegistry>(
+        device_.get(),
+        [this](const VkGraphicsPipelineCreateInfo& createInfo) { return compileGraphicsPipeline(createInfo); }
+    );
+}
+
+void VulkanGraphicAPI::destroyPipelineRegistry() {
+    if (!pipelineRegistry_) return;
+
+    core::Logger::Log(core::LogLevel::Info,
+        "Pipeline registry: " + std::to_string(pipelineRegistry_->getPipelineCount()) +
+        " pipelines for " + std::to_string(pipelineRegistry_->getRequestCount()) + " material requests");
+
+    pipelineRegistry_->release();
+    pipelineRegistry_.reset();
+}
+
+}
@@ -0,0 +1,51 @@
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+
+#include "jelly/exception.hpp"
+
+#include <cstring>
+
+namespace jelly::graphics::vulkan {
+
+void VulkanGraphicAPI::createRingBuffers() {
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice_, &properties);
+
+    // Dynamic uniform offsets must respect the device alignment
+    uniformRingBuffer_ = std::make_unique<VulkanRingBuffer>(
+        device_.get(),
+        *memoryAllocator_,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        uniformRingCapacity_,
+        properties.limits.minUniformBufferOffsetAlignment,
+        framesInFlight_
+    );
+
+    // Aligning to the record size keeps every offset a whole instance index
+    instanceRingBuffer_ = std::make_unique<VulkanRingBuffer>(
+        device_.get(),
+        *memoryAllocator_,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        instanceRingCapacity_,
+        INSTANCE_STRIDE,
+        framesInFlight_
+    );
+
+    // Indirect buffer offsets must be multiples of 4
+    indirectRingBuffer_ = std::make_unique<VulkanRingBuffer>(
+        device_.get(),
+        *memoryAllocator_,
+        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        indirectRingCapacity_,
+        4,
+        framesInFlight_
+    );
+}
+
+uint32_t VulkanGraphicAPI::writeInstanceData(const float* worldMatrices, uint32_t count) {
+    VkDeviceSize size = static_cast<VkDeviceSize>(count) * INSTANCE_STRIDE;
+    RingAllocation slice = instanceRingBuffer_->allocate(size);
+    memcpy(slice.data, worldMatrices, static_cast<size_t>(size));
+    return static_cast<uint32_t>(slice.offset / INSTANCE_STRIDE);
+}
+
+}
@@ -0,0 +1,15 @@
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+
+namespace jelly::graphics::vulkan {
+
+void VulkanGraphicAPI::createStagingUploader() {
+    stagingUploader_ = std::make_unique<VulkanStagingUploader>(
+        device_.get(),
+        *memoryAllocator_,
+        transferQueue_,
+        transferFamily_,
+        graphicsFamily_
+    );
+}
+
+}
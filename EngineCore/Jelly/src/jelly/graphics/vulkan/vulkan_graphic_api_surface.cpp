@@ -7,6 +7,8 @@
 namespace jelly::graphics::vulkan {
 
 void VulkanGraphicAPI::createSurface() {
+    if (offscreen_) return;
+
     if (!windowProvider_) {
         throw jelly::Exception("Window system does not support Vulkan surface creation!");
     }
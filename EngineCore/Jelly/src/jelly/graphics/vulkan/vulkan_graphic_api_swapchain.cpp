@@ -1,17 +1,30 @@
 #include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
 
 #include "jelly/exception.hpp"
+#include "jelly/graphics/material_factory.hpp"
+
+#include <algorithm>
 
 namespace jelly::graphics::vulkan {
 
+void VulkanGraphicAPI::setPresentMode(core::PresentMode mode) {
+    presentMode_ = mode;
+}
+
 void VulkanGraphicAPI::createSwapchain() {
+    if (offscreen_) {
+        createOffscreenTargets();
+        return;
+    }
+
     SwapChainSupportDetails support = querySwapChainSupport(physicalDevice_, surface_);
 
     VkSurfaceFormatKHR surfaceFmt = chooseSurfaceFormat(support.formats);
     VkPresentModeKHR present = choosePresentMode(support.presentModes);
     VkExtent2D extent = chooseSwapExtent(support.capabilities);
 
-    uint32_t imageCount = support.capabilities.minImageCount + 1;
+    // Enough images that every frame in flight can hold one while another is presented
+    uint32_t imageCount = std::max(support.capabilities.minImageCount + 1, framesInFlight_);
     if (support.capabilities.maxImageCount &&
         imageCount > support.capabilities.maxImageCount) {
         imageCount = support.capabilities.maxImageCount;
@@ -78,14 +91,31 @@ void VulkanGraphicAPI::recreateSwapchain()
 
     vkDeviceWaitIdle(device_);
 
+    const VkFormat previousFormat = swapchainImageFormat_;
+    const size_t previousImageCount = swapchainImages_.size();
+
     cleanupSwapchain();
+    destroyDepthResources();
 
     createSwapchain();
     createImageViews();
-    createRenderPass();
+    createDepthResources();
+
+    // Pipelines are only compatible with render passes of the same formats
+    if (swapchainImageFormat_ != previousFormat) {
+        createRenderPass();
+        pipelineRegistry_->release();
+        jelly::graphics::MaterialFactory::recreatePipelines();
+    }
+
     createFramebuffers();
-    createCommandBuffers();
-    createSyncObjects();
+
+    // Command buffers and present semaphores are per swapchain image;
+    // the per-frame fences and semaphores do not depend on the swapchain
+    if (swapchainImages_.size() != previousImageCount) {
+        createCommandBuffers();
+        createImageSyncObjects();
+    }
 }
 
 void VulkanGraphicAPI::cleanupSwapchain()
@@ -107,7 +137,6 @@ void VulkanGraphicAPI::cleanupSwapchain()
     swapchainImageViews_.clear();
 
     swapchain_.reset();
-    renderPass_.reset();
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,362 @@
+#include "jelly/graphics/vulkan/vulkan_memory_allocator.hpp"
+
+#include "jelly/exception.hpp"
+
+#include <algorithm>
+
+namespace jelly::graphics::vulkan {
+
+struct MemoryBlock {
+    MemoryBlock(VkDeviceMemory memory, uint8_t* mapped, VkDeviceSize size, MemoryStrategy strategy, uint32_t pool)
+        : memory(memory), mapped(mapped), pool(pool), metadata(size, strategy) {}
+
+    VkDeviceMemory memory;
+    uint8_t* mapped;
+    uint32_t pool; // Index in VulkanMemoryAllocator::pools_
+    MemoryBlockMetadata metadata;
+};
+
+namespace {
+
+constexpr VkDeviceSize LARGE_HEAP_BLOCK_SIZE = 256ull * 1024 * 1024;
+constexpr VkDeviceSize SMALL_HEAP_THRESHOLD = 1024ull * 1024 * 1024;
+
+constexpr uint32_t poolIndex(uint32_t memoryType, VulkanMemoryAllocator::ResourceKind kind, MemoryStrategy strategy) {
+    return memoryType * 4 + static_cast<uint32_t>(kind) * 2 + static_cast<uint32_t>(strategy);
+}
+
+} // namespace
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice)
+    : device_(device)
+{
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties_);
+
+    pools_.resize(memoryProperties_.memoryTypeCount * 4);
+    for (uint32_t type = 0; type < memoryProperties_.memoryTypeCount; ++type) {
+        for (auto kind : { ResourceKind::Buffer, ResourceKind::Image }) {
+            for (auto strategy : { MemoryStrategy::Tlsf, MemoryStrategy::Linear }) {
+                Pool& pool = pools_[poolIndex(type, kind, strategy)];
+                pool.memoryType = type;
+                pool.kind = kind;
+                pool.strategy = strategy;
+            }
+        }
+    }
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+    // Whatever is still allocated goes away with its block
+    for (auto* allocation : dedicated_) {
+        freeDeviceMemory(allocation->memory, allocation->mapped);
+    }
+    for (auto& pool : pools_) {
+        for (auto& block : pool.blocks) {
+            freeDeviceMemory(block->memory, block->mapped);
+        }
+    }
+}
+
+MemoryAllocation* VulkanMemoryAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    VkMemoryPropertyFlags properties,
+    ResourceKind kind,
+    MemoryStrategy strategy)
+{
+    std::lock_guard lock(mutex_);
+
+    const uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+
+    MemoryAllocation* allocation = newRecord();
+    allocation->size = requirements.size;
+    allocation->alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+    allocation->memoryType = memoryType;
+
+    if (requirements.size > getBlockSize(memoryType) / 2) {
+        try {
+            allocation->memory = allocateDeviceMemory(memoryType, requirements.size, allocation->mapped);
+        } catch (...) {
+            freeAllocations_.push_back(allocation);
+            throw;
+        }
+        allocation->offset = 0;
+        dedicated_.push_back(allocation);
+        return allocation;
+    }
+
+    bool placed = false;
+    try {
+        placed = allocateFromPool(getPool(memoryType, kind, strategy), requirements.size, allocation->alignment, *allocation);
+    } catch (...) {
+        *allocation = MemoryAllocation{};
+        freeAllocations_.push_back(allocation);
+        throw;
+    }
+
+    if (!placed) {
+        *allocation = MemoryAllocation{};
+        freeAllocations_.push_back(allocation);
+        throw Exception("Failed to place allocation in a new memory block!");
+    }
+    return allocation;
+}
+
+MemoryAllocation* VulkanMemoryAllocator::allocateForBuffer(
+    VkBuffer buffer,
+    VkMemoryPropertyFlags properties,
+    MemoryStrategy strategy)
+{
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device_, buffer, &requirements);
+
+    MemoryAllocation* allocation = allocate(requirements, properties, ResourceKind::Buffer, strategy);
+    vkBindBufferMemory(device_, buffer, allocation->memory, allocation->offset);
+    return allocation;
+}
+
+MemoryAllocation* VulkanMemoryAllocator::allocateForImage(VkImage image, VkMemoryPropertyFlags properties) {
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(device_, image, &requirements);
+
+    MemoryAllocation* allocation = allocate(requirements, properties, ResourceKind::Image);
+    vkBindImageMemory(device_, image, allocation->memory, allocation->offset);
+    return allocation;
+}
+
+void VulkanMemoryAllocator::free(MemoryAllocation* allocation) {
+    if (!allocation) return;
+
+    std::lock_guard lock(mutex_);
+
+    if (allocation->block) {
+        const uint32_t pool = allocation->block->pool;
+        releaseRange(*allocation);
+        trimPool(pools_[pool]);
+    } else {
+        freeDeviceMemory(allocation->memory, allocation->mapped);
+        dedicated_.erase(std::find(dedicated_.begin(), dedicated_.end(), allocation));
+    }
+
+    *allocation = MemoryAllocation{};
+    freeAllocations_.push_back(allocation);
+}
+
+std::vector<DefragmentationCandidate> VulkanMemoryAllocator::getDefragmentationCandidates(float maxUsage) {
+    std::lock_guard lock(mutex_);
+
+    std::vector<DefragmentationCandidate> candidates;
+    std::vector<const MemoryBlock*> blocks;
+
+    for (const auto& pool : pools_) {
+        // Linear blocks are released as a whole by their owners
+        if (pool.strategy != MemoryStrategy::Tlsf || pool.blocks.size() < 2) continue;
+
+        VkDeviceSize poolFreeBytes = 0;
+        for (const auto& block : pool.blocks) {
+            poolFreeBytes += block->metadata.getFreeBytes();
+        }
+
+        for (const auto& block : pool.blocks) {
+            const MemoryBlockMetadata& metadata = block->metadata;
+            if (metadata.isEmpty()) continue;
+            if (static_cast<float>(metadata.getAllocatedBytes()) > maxUsage * static_cast<float>(metadata.getSize())) continue;
+
+            // The other blocks must at least have the bytes to take everything in
+            if (poolFreeBytes - metadata.getFreeBytes() < metadata.getAllocatedBytes()) continue;
+
+            DefragmentationCandidate& candidate = candidates.emplace_back();
+            candidate.memory = block->memory;
+            candidate.allocatedBytes = metadata.getAllocatedBytes();
+            blocks.push_back(block.get());
+        }
+    }
+
+    for (auto& allocation : allocations_) {
+        if (!allocation.block) continue;
+        auto it = std::find(blocks.begin(), blocks.end(), allocation.block);
+        if (it != blocks.end()) {
+            candidates[it - blocks.begin()].allocations.push_back(&allocation);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.allocatedBytes < b.allocatedBytes;
+    });
+    return candidates;
+}
+
+MemoryAllocation* VulkanMemoryAllocator::allocateRelocation(const MemoryAllocation* allocation) {
+    if (!allocation || !allocation->block) return nullptr;
+
+    std::lock_guard lock(mutex_);
+
+    MemoryAllocation* relocated = newRecord();
+    relocated->size = allocation->size;
+    relocated->alignment = allocation->alignment;
+    relocated->memoryType = allocation->memoryType;
+
+    if (!placeInBlocks(pools_[allocation->block->pool], allocation->size, allocation->alignment, allocation->block, *relocated)) {
+        *relocated = MemoryAllocation{};
+        freeAllocations_.push_back(relocated);
+        return nullptr;
+    }
+    return relocated;
+}
+
+std::vector<MemoryHeapStats> VulkanMemoryAllocator::getHeapStats() const {
+    std::lock_guard lock(mutex_);
+
+    std::vector<MemoryHeapStats> stats(memoryProperties_.memoryHeapCount);
+    std::vector<VkDeviceSize> freeBytes(memoryProperties_.memoryHeapCount, 0);
+
+    for (uint32_t heap = 0; heap < memoryProperties_.memoryHeapCount; ++heap) {
+        stats[heap].heapSize = memoryProperties_.memoryHeaps[heap].size;
+    }
+
+    for (const auto& pool : pools_) {
+        const uint32_t heap = memoryProperties_.memoryTypes[pool.memoryType].heapIndex;
+        for (const auto& block : pool.blocks) {
+            const MemoryBlockMetadata& metadata = block->metadata;
+            stats[heap].blockBytes += metadata.getSize();
+            stats[heap].allocatedBytes += metadata.getAllocatedBytes();
+            stats[heap].allocationCount += metadata.getAllocationCount();
+            stats[heap].largestFreeRange = std::max(stats[heap].largestFreeRange, metadata.getLargestFreeRange());
+            ++stats[heap].blockCount;
+            freeBytes[heap] += metadata.getFreeBytes();
+        }
+    }
+
+    for (const auto* allocation : dedicated_) {
+        const uint32_t heap = memoryProperties_.memoryTypes[allocation->memoryType].heapIndex;
+        stats[heap].blockBytes += allocation->size;
+        stats[heap].allocatedBytes += allocation->size;
+        ++stats[heap].allocationCount;
+        ++stats[heap].dedicatedCount;
+    }
+
+    for (uint32_t heap = 0; heap < memoryProperties_.memoryHeapCount; ++heap) {
+        if (freeBytes[heap] > 0) {
+            stats[heap].fragmentation =
+                1.0f - static_cast<float>(stats[heap].largestFreeRange) / static_cast<float>(freeBytes[heap]);
+        }
+    }
+
+    return stats;
+}
+
+uint32_t VulkanMemoryAllocator::getDeviceAllocationCount() const {
+    std::lock_guard lock(mutex_);
+    return deviceAllocationCount_;
+}
+
+VkDeviceSize VulkanMemoryAllocator::getBlockSize(uint32_t memoryType) const {
+    const VkDeviceSize heapSize = memoryProperties_.memoryHeaps[memoryProperties_.memoryTypes[memoryType].heapIndex].size;
+    // Small heaps (e.g. the 256 MiB host-visible BAR) get proportionally smaller blocks
+    return heapSize <= SMALL_HEAP_THRESHOLD ? heapSize / 8 : LARGE_HEAP_BLOCK_SIZE;
+}
+
+uint32_t VulkanMemoryAllocator::findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < memoryProperties_.memoryTypeCount; ++i) {
+        if ((typeBits & (1u << i)) &&
+            (memoryProperties_.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    throw Exception("Failed to find suitable memory type!");
+}
+
+VulkanMemoryAllocator::Pool& VulkanMemoryAllocator::getPool(uint32_t memoryType, ResourceKind kind, MemoryStrategy strategy) {
+    return pools_[poolIndex(memoryType, kind, strategy)];
+}
+
+VkDeviceMemory VulkanMemoryAllocator::allocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, uint8_t*& outMapped) {
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    if (vkAllocateMemory(device_, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+        throw Exception("Failed to allocate device memory!");
+    }
+
+    outMapped = nullptr;
+    if (memoryProperties_.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        void* data = nullptr;
+        if (vkMapMemory(device_, memory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS) {
+            vkFreeMemory(device_, memory, nullptr);
+            throw Exception("Failed to map device memory!");
+        }
+        outMapped = static_cast<uint8_t*>(data);
+    }
+
+    ++deviceAllocationCount_;
+    return memory;
+}
+
+void VulkanMemoryAllocator::freeDeviceMemory(VkDeviceMemory memory, uint8_t* mapped) {
+    if (mapped) vkUnmapMemory(device_, memory);
+    vkFreeMemory(device_, memory, nullptr);
+    --deviceAllocationCount_;
+}
+
+bool VulkanMemoryAllocator::allocateFromPool(Pool& pool, VkDeviceSize size, VkDeviceSize alignment, MemoryAllocation& out) {
+    if (placeInBlocks(pool, size, alignment, nullptr, out)) return true;
+
+    const VkDeviceSize blockSize = getBlockSize(pool.memoryType);
+    uint8_t* mapped = nullptr;
+    VkDeviceMemory memory = allocateDeviceMemory(pool.memoryType, blockSize, mapped);
+    pool.blocks.push_back(std::make_unique<MemoryBlock>(
+        memory, mapped, blockSize, pool.strategy, poolIndex(pool.memoryType, pool.kind, pool.strategy)));
+
+    return placeInBlocks(pool, size, alignment, nullptr, out);
+}
+
+bool VulkanMemoryAllocator::placeInBlocks(
+    Pool& pool, VkDeviceSize size, VkDeviceSize alignment, const MemoryBlock* skipped, MemoryAllocation& out)
+{
+    // Newest blocks first: older ones are the likeliest to be full
+    for (auto it = pool.blocks.rbegin(); it != pool.blocks.rend(); ++it) {
+        MemoryBlock& block = **it;
+        if (&block == skipped) continue;
+
+        VkDeviceSize offset = 0;
+        const uint32_t node = block.metadata.allocate(size, alignment, offset);
+        if (node == MemoryBlockMetadata::INVALID_NODE) continue;
+
+        out.memory = block.memory;
+        out.offset = offset;
+        out.mapped = block.mapped ? block.mapped + offset : nullptr;
+        out.block = &block;
+        out.node = node;
+        return true;
+    }
+    return false;
+}
+
+void VulkanMemoryAllocator::trimPool(Pool& pool) {
+    for (auto it = pool.blocks.begin(); it != pool.blocks.end();) {
+        if (!(*it)->metadata.isEmpty() || pool.blocks.size() == 1) {
+            ++it;
+        } else {
+            freeDeviceMemory((*it)->memory, (*it)->mapped);
+            it = pool.blocks.erase(it);
+        }
+    }
+}
+
+MemoryAllocation* VulkanMemoryAllocator::newRecord() {
+    if (!freeAllocations_.empty()) {
+        MemoryAllocation* record = freeAllocations_.back();
+        freeAllocations_.pop_back();
+        return record;
+    }
+    return &allocations_.emplace_back();
+}
+
+void VulkanMemoryAllocator::releaseRange(MemoryAllocation& allocation) {
+    allocation.block->metadata.free(allocation.node, allocation.size);
+}
+
+} // namespace jelly::graphics::vulkan
@@ -1,61 +1,142 @@
 #include "jelly/graphics/vulkan/vulkan_mesh.hpp"
 #include "jelly/graphics/graphic_context.hpp"
 #include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+#include "jelly/core/frame_allocator.hpp"
 
 #include <stdexcept>
 #include <cstring>
 
 namespace jelly::graphics::vulkan {
 
-VulkanMesh::VulkanMesh(VkDevice device, VkPhysicalDevice physicalDevice)
-    : device_(device), physicalDevice_(physicalDevice) {}
+VulkanMesh::VulkanMesh(VkDevice device, VulkanMemoryAllocator* allocator)
+    : device_(device), allocator_(allocator) {}
 
-VulkanMesh::~VulkanMesh() = default;
+VulkanMesh::~VulkanMesh() {
+    releaseShared();
+}
 
 void VulkanMesh::upload() {
-    auto vertices = buildVertexBuffer();
+    computeBounds();
+
+    // Vertices are copied to staging or mapped memory before returning
+    core::FrameAllocator::Scope scope;
+    auto vertices = buildVertexBuffer(scope.resource());
 
     VkDeviceSize vertexSize = vertices.size() * sizeof(Vertex);
+    VkDeviceSize indexSize = indices_.size() * sizeof(uint32_t);
+    indexCount_ = static_cast<uint32_t>(indices_.size());
+
+    releaseShared();
+    if (usage_ == MeshUsage::Shared && uploadShared(vertices)) {
+        return;
+    }
+
+    // Static meshes, and shared meshes the arena had no room for
+    if (usage_ != MeshUsage::Dynamic) {
+        auto vulkanAPI = static_cast<VulkanGraphicAPI*>(GraphicContext::get().getAPI());
+        VulkanStagingUploader* uploader = vulkanAPI->getStagingUploader();
+
+        createBuffer(vertexSize,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            uploader,
+            vertexBuffer_, vertexMemory_
+        );
+        uploader->upload(vertexBuffer_.get(), vertices.data(), vertexSize);
+
+        createBuffer(indexSize,
+            VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            uploader,
+            indexBuffer_, indexMemory_
+        );
+        uploader->upload(indexBuffer_.get(), indices_.data(), indexSize);
+        return;
+    }
 
     createBuffer(vertexSize,
         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        nullptr,
         vertexBuffer_, vertexMemory_
     );
 
-    void* data = nullptr;
-    vkMapMemory(device_, vertexMemory_.get(), 0, vertexSize, 0, &data);
-    std::memcpy(data, vertices.data(), static_cast<size_t>(vertexSize));
-    vkUnmapMemory(device_, vertexMemory_.get());
+    std::memcpy(vertexMemory_.get()->mapped, vertices.data(), static_cast<size_t>(vertexSize));
 
-    VkDeviceSize indexSize = indices_.size() * sizeof(uint32_t);
     createBuffer(indexSize,
         VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        nullptr,
         indexBuffer_, indexMemory_
     );
 
-    vkMapMemory(device_, indexMemory_.get(), 0, indexSize, 0, &data);
-    std::memcpy(data, indices_.data(), static_cast<size_t>(indexSize));
-    vkUnmapMemory(device_, indexMemory_.get());
+    std::memcpy(indexMemory_.get()->mapped, indices_.data(), static_cast<size_t>(indexSize));
+}
 
-    indexCount_ = static_cast<uint32_t>(indices_.size());
+bool VulkanMesh::uploadShared(const std::pmr::vector<Vertex>& vertices) {
+    auto vulkanAPI = static_cast<VulkanGraphicAPI*>(GraphicContext::get().getAPI());
+    VulkanGeometryArena* arena = vulkanAPI->getGeometryArena();
+
+    if (!arena || !arena->allocate(static_cast<uint32_t>(vertices.size()), indexCount_, arenaRange_)) {
+        return false;
+    }
+
+    arena->upload(arenaRange_, vertices.data(), indices_.data());
+
+    // Buffers of a previous non-shared upload are no longer needed
+    vertexBuffer_.reset();
+    vertexMemory_.reset();
+    indexBuffer_.reset();
+    indexMemory_.reset();
+
+    geometryRange_.indexCount = indexCount_;
+    geometryRange_.firstIndex = arenaRange_.firstIndex;
+    geometryRange_.vertexOffset = static_cast<int32_t>(arenaRange_.vertexOffset);
+    sharedGeometry_ = true;
+    return true;
 }
 
-void VulkanMesh::draw() const {
+void VulkanMesh::releaseShared() {
+    if (!sharedGeometry_) return;
+
     auto vulkanAPI = static_cast<VulkanGraphicAPI*>(GraphicContext::get().getAPI());
+    if (VulkanGeometryArena* arena = vulkanAPI->getGeometryArena()) {
+        arena->free(arenaRange_);
+    }
+
+    geometryRange_ = MeshGeometryRange{};
+    sharedGeometry_ = false;
+}
+
+void VulkanMesh::bind() const {
+    auto vulkanAPI = static_cast<VulkanGraphicAPI*>(GraphicContext::get().getAPI());
+
+    if (sharedGeometry_) {
+        vulkanAPI->bindSharedGeometry();
+        return;
+    }
+
     VkCommandBuffer cmdBuffer = vulkanAPI->getCurrentCommandBuffer();
 
     VkBuffer vertexBuffers[] = { vertexBuffer_.get() };
     VkDeviceSize offsets[] = { 0 };
     vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
     vkCmdBindIndexBuffer(cmdBuffer, indexBuffer_.get(), 0, VK_INDEX_TYPE_UINT32);
-    vkCmdDrawIndexed(cmdBuffer, indexCount_, 1, 0, 0, 0);
+}
+
+void VulkanMesh::drawIndexed(uint32_t instanceCount, uint32_t firstInstance) const {
+    auto vulkanAPI = static_cast<VulkanGraphicAPI*>(GraphicContext::get().getAPI());
+    VkCommandBuffer cmdBuffer = vulkanAPI->getCurrentCommandBuffer();
+
+    vkCmdDrawIndexed(
+        cmdBuffer, indexCount_, instanceCount,
+        geometryRange_.firstIndex, geometryRange_.vertexOffset, firstInstance);
 }
 
 void VulkanMesh::release()
 {
     if (device_ != VK_NULL_HANDLE) {
+        releaseShared();
         vertexBuffer_.reset();
         vertexMemory_.reset();
         indexBuffer_.reset();
@@ -66,8 +147,9 @@ void VulkanMesh::release()
 void VulkanMesh::createBuffer(
     VkDeviceSize size, VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
+    const VulkanStagingUploader* uploader,
     core::ManagedResource<VkBuffer>& buffer,
-    core::ManagedResource<VkDeviceMemory>& memory
+    core::ManagedResource<MemoryAllocation*>& memory
 ) {
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -75,24 +157,16 @@ void VulkanMesh::createBuffer(
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+    // Concurrent sharing avoids ownership transfers between the transfer and graphics queues
+    if (uploader && uploader->usesDedicatedTransferQueue()) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.pQueueFamilyIndices = uploader->getQueueFamilyIndices(bufferInfo.queueFamilyIndexCount);
+    }
+
     VkBuffer rawBuffer{};
     if (vkCreateBuffer(device_, &bufferInfo, nullptr, &rawBuffer) != VK_SUCCESS)
         throw std::runtime_error("failed to create buffer");
 
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(device_, rawBuffer, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-    VkDeviceMemory rawMemory{};
-    if (vkAllocateMemory(device_, &allocInfo, nullptr, &rawMemory) != VK_SUCCESS)
-        throw std::runtime_error("failed to allocate buffer memory");
-
-    vkBindBufferMemory(device_, rawBuffer, rawMemory, 0);
-
     // Wrap resources in ManagedResource with proper cleanup
     buffer = core::ManagedResource<VkBuffer>(
         rawBuffer,
@@ -100,24 +174,11 @@ void VulkanMesh::createBuffer(
         VK_NULL_HANDLE
     );
 
-    memory = core::ManagedResource<VkDeviceMemory>(
-        rawMemory,
-        [device = device_](VkDeviceMemory mem) { vkFreeMemory(device, mem, nullptr); },
-        VK_NULL_HANDLE
+    memory = core::ManagedResource<MemoryAllocation*>(
+        allocator_->allocateForBuffer(rawBuffer, properties),
+        [allocator = allocator_](MemoryAllocation* allocation) { allocator->free(allocation); },
+        nullptr
     );
 }
 
-uint32_t VulkanMesh::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice_, &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) &&
-            (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-            return i;
-    }
-
-    throw std::runtime_error("failed to find suitable memory type");
-}
-
 } // namespace jelly::graphics::vulkan
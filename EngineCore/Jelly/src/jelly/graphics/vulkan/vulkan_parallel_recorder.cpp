@@ -0,0 +1,190 @@
+#include "jelly/graphics/vulkan/vulkan_parallel_recorder.hpp"
+
+#include "jelly/exception.hpp"
+
+#include <algorithm>
+
+namespace jelly::graphics::vulkan {
+
+VulkanParallelRecorder::VulkanParallelRecorder(
+    VkDevice device,
+    uint32_t queueFamilyIndex,
+    uint32_t workerCount,
+    uint32_t frameCount)
+    : device_(device)
+{
+    workerCount = std::max(workerCount, 1u);
+
+    frames_.resize(frameCount);
+    for (auto& workers : frames_) {
+        workers.resize(workerCount);
+
+        for (auto& worker : workers) {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = queueFamilyIndex;
+
+            if (vkCreateCommandPool(device_, &poolInfo, nullptr, &worker.pool) != VK_SUCCESS) {
+                release();
+                throw Exception("Failed to create worker command pool!");
+            }
+        }
+    }
+
+    tasks_.resize(workerCount);
+    threads_.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        threads_.emplace_back(&VulkanParallelRecorder::workerLoop, this, i);
+    }
+}
+
+VulkanParallelRecorder::~VulkanParallelRecorder() {
+    release();
+}
+
+void VulkanParallelRecorder::beginFrame(uint32_t frameIndex) {
+    currentFrame_ = frameIndex;
+
+    for (auto& worker : frames_[currentFrame_]) {
+        vkResetCommandPool(device_, worker.pool, 0);
+        worker.used = 0;
+    }
+}
+
+VkCommandBuffer VulkanParallelRecorder::acquireCommandBuffer(uint32_t workerIndex) {
+    WorkerFrame& worker = frames_[currentFrame_][workerIndex];
+
+    if (worker.used == worker.buffers.size()) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = worker.pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(device_, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+            throw Exception("Failed to allocate secondary command buffer!");
+        }
+        worker.buffers.push_back(commandBuffer);
+    }
+
+    return worker.buffers[worker.used++];
+}
+
+void VulkanParallelRecorder::record(
+    const VkCommandBufferInheritanceInfo& inheritance,
+    uint32_t itemCount,
+    uint32_t minItemsPerWorker,
+    const RecordFunction& record,
+    std::vector<VkCommandBuffer>& outCommandBuffers)
+{
+    if (itemCount == 0) return;
+
+    const uint32_t workerCount = getWorkerCount();
+    minItemsPerWorker = std::max(minItemsPerWorker, 1u);
+
+    uint32_t rangeCount = std::min(workerCount, (itemCount + minItemsPerWorker - 1) / minItemsPerWorker);
+    uint32_t rangeSize = (itemCount + rangeCount - 1) / rangeCount;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        for (uint32_t i = 0; i < workerCount; ++i) {
+            uint32_t begin = std::min(i * rangeSize, itemCount);
+            uint32_t end = std::min(begin + rangeSize, itemCount);
+
+            tasks_[i] = Task{};
+            if (begin < end) {
+                tasks_[i] = Task{ begin, end, acquireCommandBuffer(i) };
+                outCommandBuffers.push_back(tasks_[i].commandBuffer);
+            }
+        }
+
+        currentRecord_ = &record;
+        currentInheritance_ = &inheritance;
+        error_ = nullptr;
+        pending_ = workerCount;
+        ++generation_;
+    }
+    workAvailable_.notify_all();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    workDone_.wait(lock, [this] { return pending_ == 0; });
+
+    currentRecord_ = nullptr;
+    currentInheritance_ = nullptr;
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void VulkanParallelRecorder::workerLoop(uint32_t workerIndex) {
+    uint64_t seenGeneration = 0;
+
+    for (;;) {
+        Task task;
+        const RecordFunction* record = nullptr;
+        const VkCommandBufferInheritanceInfo* inheritance = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [&] { return stopping_ || generation_ != seenGeneration; });
+            if (stopping_) return;
+
+            seenGeneration = generation_;
+            task = tasks_[workerIndex];
+            record = currentRecord_;
+            inheritance = currentInheritance_;
+        }
+
+        if (task.commandBuffer != VK_NULL_HANDLE) {
+            try {
+                VkCommandBufferBeginInfo beginInfo{};
+                beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+                beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                                  VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+                beginInfo.pInheritanceInfo = inheritance;
+
+                vkBeginCommandBuffer(task.commandBuffer, &beginInfo);
+                (*record)(task.commandBuffer, task.begin, task.end);
+                vkEndCommandBuffer(task.commandBuffer);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            workDone_.notify_one();
+        }
+    }
+}
+
+void VulkanParallelRecorder::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+    threads_.clear();
+
+    if (device_ == VK_NULL_HANDLE) return;
+
+    for (auto& workers : frames_) {
+        for (auto& worker : workers) {
+            if (worker.pool) vkDestroyCommandPool(device_, worker.pool, nullptr);
+        }
+    }
+
+    frames_.clear();
+    device_ = VK_NULL_HANDLE;
+}
+
+} // namespace jelly::graphics::vulkan
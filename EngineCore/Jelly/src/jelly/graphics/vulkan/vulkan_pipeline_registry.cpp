@@ -0,0 +1,352 @@
+#include "jelly/graphics/vulkan/vulkan_pipeline_registry.hpp"
+#include "jelly/graphics/vulkan/vulkan_graphic_api.hpp"
+#include "jelly/graphics/vulkan/vulkan_shader.hpp"
+
+#include "jelly/exception.hpp"
+#include "jelly/core/logger.hpp"
+#include "jelly/core/profiler.hpp"
+#include "jelly/graphics/mesh.hpp"
+
+#include <cstddef>
+
+namespace jelly::graphics::vulkan {
+
+namespace {
+
+inline void hashCombine(size_t& seed, size_t value) {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+}
+
+size_t VulkanPipelineRegistry::KeyHash::operator()(const Key& key) const {
+    size_t h = key.vertexHash;
+    hashCombine(h, key.fragmentHash);
+    hashCombine(h, std::hash<const void*>{}(key.renderPass));
+    hashCombine(h, key.instanced);
+    hashCombine(h, static_cast<size_t>(key.state.polygonMode));
+    hashCombine(h, static_cast<size_t>(key.state.cullMode));
+    hashCombine(h, static_cast<size_t>(key.state.frontFace));
+    hashCombine(h, static_cast<size_t>(key.state.depthCompareOp));
+    hashCombine(h,
+        (key.state.blendEnable ? 1u : 0u) |
+        (key.state.depthTestEnable ? 2u : 0u) |
+        (key.state.depthWriteEnable ? 4u : 0u));
+    return h;
+}
+
+VulkanPipelineRegistry::VulkanPipelineRegistry(VkDevice device, CompileFunction compile)
+    : device_(device), compile_(std::move(compile))
+{}
+
+VulkanPipelineRegistry::~VulkanPipelineRegistry() {
+    waitForCompiles();
+}
+
+std::shared_ptr<const VulkanPipeline> VulkanPipelineRegistry::acquire(
+    const VulkanShader& shader,
+    VkRenderPass renderPass,
+    const PipelineStateDesc& state)
+{
+    const Key key = makeKey(shader, renderPass, state);
+
+    std::shared_ptr<VulkanPipeline> entry;
+    bool compileHere = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++requestCount_;
+
+        auto it = pipelines_.find(key);
+        if (it != pipelines_.end() && !isFailed(*it->second)) {
+            entry = it->second;
+        } else {
+            // Published Pending so concurrent requests wait for this compile instead of starting another.
+            // A failed entry is replaced so the request retries.
+            entry = createEntry();
+            pipelines_.insert_or_assign(key, entry);
+            compileHere = true;
+        }
+    }
+
+    if (compileHere) {
+        compileEntry(*entry, shader, key);
+        return entry;
+    }
+
+    // Requested asynchronously first; the caller wants it now
+    if (entry->status.load(std::memory_order_acquire) == VulkanPipeline::Status::Pending) {
+        waitForCompiles();
+    }
+
+    // Still pending: another acquire() is compiling it on its own thread
+    if (entry->status.load(std::memory_order_acquire) == VulkanPipeline::Status::Pending) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        compiled_.wait(lock, [&entry] {
+            return entry->status.load(std::memory_order_acquire) != VulkanPipeline::Status::Pending;
+        });
+    }
+
+    if (entry->status.load(std::memory_order_acquire) == VulkanPipeline::Status::Failed) {
+        throw jelly::Exception("Failed to create graphics pipeline!");
+    }
+
+    return entry;
+}
+
+std::shared_ptr<const VulkanPipeline> VulkanPipelineRegistry::acquireAsync(
+    std::shared_ptr<const VulkanShader> shader,
+    VkRenderPass renderPass,
+    const PipelineStateDesc& state)
+{
+    const Key key = makeKey(*shader, renderPass, state);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++requestCount_;
+
+    auto it = pipelines_.find(key);
+    if (it != pipelines_.end() && !isFailed(*it->second)) {
+        return it->second;
+    }
+
+    // A failed entry is replaced so the request retries
+    auto entry = createEntry();
+    pipelines_.insert_or_assign(key, entry);
+
+    auto compileJob = [this, entry, shader, key]() {
+        try {
+            compileEntry(*entry, *shader, key);
+        } catch (const std::exception& e) {
+            core::Logger::Log(core::LogLevel::Error, std::string("Background pipeline compile failed: ") + e.what());
+        }
+    };
+
+    // Without workers a scheduled job would only run once someone waits on it
+    auto& jobSystem = core::JobSystem::get();
+    if (jobSystem.getWorkerCount() == 0) {
+        compileJob();
+    } else {
+        jobSystem.schedule(std::move(compileJob), &pendingCompiles_);
+    }
+
+    return entry;
+}
+
+void VulkanPipelineRegistry::waitForCompiles() {
+    core::JobSystem::get().wait(pendingCompiles_);
+}
+
+uint32_t VulkanPipelineRegistry::getPipelineCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<uint32_t>(pipelines_.size());
+}
+
+uint32_t VulkanPipelineRegistry::getRequestCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requestCount_;
+}
+
+void VulkanPipelineRegistry::release() {
+    waitForCompiles();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pipelines_.clear();
+}
+
+VulkanPipelineRegistry::Key VulkanPipelineRegistry::makeKey(
+    const VulkanShader& shader,
+    VkRenderPass renderPass,
+    const PipelineStateDesc& state)
+{
+    Key key;
+    key.vertexHash = shader.getVertexModule()->getCodeHash();
+    key.fragmentHash = shader.getFragmentModule()->getCodeHash();
+    key.instanced = shader.supportsInstancing();
+    key.renderPass = renderPass;
+    key.state = state;
+    return key;
+}
+
+bool VulkanPipelineRegistry::isFailed(const VulkanPipeline& entry) {
+    return entry.status.load(std::memory_order_acquire) == VulkanPipeline::Status::Failed;
+}
+
+std::shared_ptr<VulkanPipeline> VulkanPipelineRegistry::createEntry() {
+    auto result = std::make_shared<VulkanPipeline>();
+    result->id = nextId_++;
+    return result;
+}
+
+void VulkanPipelineRegistry::compileEntry(VulkanPipeline& entry, const VulkanShader& shader, const Key& key) {
+    auto notifyWaiters = [this] {
+        // Taking the lock orders the notification after a waiter's status check
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        compiled_.notify_all();
+    };
+
+    try {
+        compile(entry, shader, key);
+    } catch (...) {
+        entry.status.store(VulkanPipeline::Status::Failed, std::memory_order_release);
+        notifyWaiters();
+        throw;
+    }
+
+    notifyWaiters();
+}
+
+void VulkanPipelineRegistry::compile(VulkanPipeline& entry, const VulkanShader& shader, const Key& key) {
+    JELLY_PROFILE_SCOPE("VulkanPipelineRegistry::compile");
+    VkDevice device = device_;
+
+    VkDescriptorSetLayout setLayout = shader.getDescriptorSetLayout();
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 0;
+
+    VkPipelineLayout rawPipelineLayout = VK_NULL_HANDLE;
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &rawPipelineLayout) != VK_SUCCESS) {
+        throw jelly::Exception("Failed to create pipeline layout!");
+    }
+
+    entry.layout = jelly::core::ManagedResource<VkPipelineLayout>(
+        rawPipelineLayout,
+        [device](VkPipelineLayout layout) { vkDestroyPipelineLayout(device, layout, nullptr); },
+        VK_NULL_HANDLE
+    );
+
+    VkPipelineShaderStageCreateInfo vertStageInfo{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
+    vertStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertStageInfo.module = shader.getVertexModule()->getModule();
+    vertStageInfo.pName = "main";
+
+    VkPipelineShaderStageCreateInfo fragStageInfo{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
+    fragStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    fragStageInfo.module = shader.getFragmentModule()->getModule();
+    fragStageInfo.pName = "main";
+
+    VkPipelineShaderStageCreateInfo shaderStages[] = { vertStageInfo, fragStageInfo };
+
+    // Vertex input
+    VkVertexInputBindingDescription bindingDescriptions[2]{};
+    bindingDescriptions[0].binding = 0;
+    bindingDescriptions[0].stride = sizeof(Vertex);
+    bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    // Per-instance world matrix
+    bindingDescriptions[1].binding = VulkanGraphicAPI::INSTANCE_BINDING;
+    bindingDescriptions[1].stride = VulkanGraphicAPI::INSTANCE_STRIDE;
+    bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+    VkVertexInputAttributeDescription attributeDescriptions[6]{};
+
+    // Position
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = offsetof(Vertex, pos);
+
+    // UV
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
+    attributeDescriptions[1].offset = offsetof(Vertex, uv);
+
+    // Instance model matrix, one vec4 column per location
+    for (uint32_t column = 0; column < 4; ++column) {
+        auto& attribute = attributeDescriptions[2 + column];
+        attribute.binding = VulkanGraphicAPI::INSTANCE_BINDING;
+        attribute.location = VulkanShader::INSTANCE_MATRIX_LOCATION + column;
+        attribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+        attribute.offset = sizeof(float) * 4 * column;
+    }
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = key.instanced ? 2 : 1;
+    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions;
+    vertexInputInfo.vertexAttributeDescriptionCount = key.instanced ? 6 : 2;
+    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    // Viewport and scissor are set per command buffer (VulkanGraphicAPI::bindFrameState)
+    VkPipelineViewportStateCreateInfo viewportState{VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO};
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    const VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+    VkPipelineDynamicStateCreateInfo dynamicState{VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO};
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
+    // Rasterizer
+    VkPipelineRasterizationStateCreateInfo rasterizer{VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO};
+    rasterizer.polygonMode = key.state.polygonMode;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = key.state.cullMode;
+    rasterizer.frontFace = key.state.frontFace;
+
+    // Multisampling
+    VkPipelineMultisampleStateCreateInfo multisampling{VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO};
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    // Color blend
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    if (key.state.blendEnable) {
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    }
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO};
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = key.state.depthTestEnable ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = key.state.depthWriteEnable ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = key.state.depthCompareOp;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+
+    // Pipeline
+    VkGraphicsPipelineCreateInfo pipelineInfo{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = entry.layout.get();
+    pipelineInfo.renderPass = key.renderPass;
+    pipelineInfo.subpass = 0;
+
+    entry.pipeline = jelly::core::ManagedResource<VkPipeline>(
+        compile_(pipelineInfo),
+        [device](VkPipeline pipeline) { vkDestroyPipeline(device, pipeline, nullptr); },
+        VK_NULL_HANDLE
+    );
+
+    // Publishes the handle to the render thread
+    entry.status.store(VulkanPipeline::Status::Ready, std::memory_order_release);
+}
+
+} // namespace jelly::graphics::vulkan
@@ -0,0 +1,79 @@
+#include "jelly/graphics/vulkan/vulkan_ring_buffer.hpp"
+
+#include "jelly/exception.hpp"
+#include "jelly/graphics/vulkan/vulkan_buffer_utils.hpp"
+
+namespace jelly::graphics::vulkan {
+
+VulkanRingBuffer::VulkanRingBuffer(
+    VkDevice device,
+    VulkanMemoryAllocator& allocator,
+    VkBufferUsageFlags usage,
+    VkDeviceSize capacityPerFrame,
+    VkDeviceSize alignment,
+    uint32_t frameCount)
+    : device_(device), allocator_(&allocator), capacity_(capacityPerFrame), alignment_(alignment > 0 ? alignment : 1)
+{
+    buffers_.resize(frameCount, VK_NULL_HANDLE);
+    allocations_.resize(frameCount, nullptr);
+    mapped_.resize(frameCount, nullptr);
+
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        VulkanBufferUtils::createBuffer(
+            allocator,
+            device_,
+            capacity_,
+            usage,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            buffers_[i],
+            allocations_[i]
+        );
+
+        mapped_[i] = allocations_[i]->mapped;
+        if (!mapped_[i]) {
+            throw Exception("Ring buffer memory is not host-visible!");
+        }
+    }
+}
+
+VulkanRingBuffer::~VulkanRingBuffer() {
+    release();
+}
+
+void VulkanRingBuffer::beginFrame(uint32_t frameIndex) {
+    currentFrame_ = frameIndex;
+    head_ = 0;
+}
+
+RingAllocation VulkanRingBuffer::allocate(VkDeviceSize size) {
+    VkDeviceSize offset = (head_ + alignment_ - 1) / alignment_ * alignment_;
+
+    if (offset + size > capacity_) {
+        throw Exception("Ring buffer exhausted for the current frame!");
+    }
+
+    head_ = offset + size;
+
+    RingAllocation allocation;
+    allocation.data = mapped_[currentFrame_] + offset;
+    allocation.buffer = buffers_[currentFrame_];
+    allocation.offset = offset;
+    return allocation;
+}
+
+void VulkanRingBuffer::release() {
+    if (device_ == VK_NULL_HANDLE) return;
+
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        if (buffers_[i]) vkDestroyBuffer(device_, buffers_[i], nullptr);
+        allocator_->free(allocations_[i]);
+    }
+
+    buffers_.clear();
+    allocations_.clear();
+    mapped_.clear();
+    head_ = 0;
+    device_ = VK_NULL_HANDLE;
+}
+
+} // namespace jelly::graphics::vulkan
@@ -1,6 +1,10 @@
 #include "jelly/graphics/vulkan/vulkan_shader.hpp"
+#include "jelly/core/frame_allocator.hpp"
 
+#include <memory_resource>
 #include <stdexcept>
+#include <unordered_map>
+#include <vector>
 #include <string.h>
 
 #include <iostream>
@@ -18,7 +22,11 @@ VulkanShader::VulkanShader(
     }
 
     reflectUniforms();
-    createUniformBuffers();
+
+    if (uniformBufferSize == 0) {
+        throw std::runtime_error("Uniform buffer size is zero — shader has no UBO?");
+    }
+
     createDescriptorSetLayout();
     createDescriptorPool();
     allocateDescriptorSets();
@@ -29,6 +37,29 @@ VulkanShader::VulkanShader(
 void VulkanShader::reflectUniforms() {
     reflectShaderCode(vertex_->getSPIRVCode());
     reflectShaderCode(fragment_->getSPIRVCode());
+    reflectVertexInputs();
+}
+
+void VulkanShader::reflectVertexInputs() {
+    const auto& code = vertex_->getSPIRVCode();
+
+    SpvReflectShaderModule module;
+    spvReflectCreateShaderModule(code.size(), code.data(), &module);
+
+    uint32_t count = 0;
+    spvReflectEnumerateInputVariables(&module, &count, nullptr);
+
+    std::vector<SpvReflectInterfaceVariable*> inputs(count);
+    spvReflectEnumerateInputVariables(&module, &count, inputs.data());
+
+    for (auto* input : inputs) {
+        if (input->location == INSTANCE_MATRIX_LOCATION) {
+            supportsInstancing_ = true;
+            break;
+        }
+    }
+
+    spvReflectDestroyShaderModule(&module);
 }
 
 void VulkanShader::reflectShaderCode(const std::vector<uint8_t>& code) {
@@ -65,75 +96,12 @@ void VulkanShader::reflectShaderCode(const std::vector<uint8_t>& code) {
     spvReflectDestroyShaderModule(&module);
 }
 
-void VulkanShader::createUniformBuffers() {
-    if (uniformBufferSize == 0) {
-        throw std::runtime_error("Uniform buffer size is zero — shader has no UBO?");
-    }
-
-    VkDevice device = api_->getDevice();
-    VkPhysicalDevice physicalDevice = api_->getPhysicalDevice();
-
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        VkBufferCreateInfo bufferInfo{};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = uniformBufferSize;
-        bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-        VkBuffer buffer;
-        if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to create uniform buffer");
-        }
-
-        uniformBuffers_[i] = jelly::core::ManagedResource<VkBuffer>(
-            buffer, [device](VkBuffer b){ vkDestroyBuffer(device, b, nullptr); }, VK_NULL_HANDLE
-        );
-
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
-
-        VkPhysicalDeviceMemoryProperties memProperties;
-        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-
-        uint32_t memoryTypeIndex = UINT32_MAX;
-        for (uint32_t j = 0; j < memProperties.memoryTypeCount; j++) {
-            if ((memRequirements.memoryTypeBits & (1 << j)) &&
-                (memProperties.memoryTypes[j].propertyFlags &
-                 (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) ==
-                 (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
-                memoryTypeIndex = j;
-                break;
-            }
-        }
-
-        if (memoryTypeIndex == UINT32_MAX) {
-            throw std::runtime_error("Failed to find suitable memory type for uniform buffer");
-        }
-
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = memoryTypeIndex;
-
-        VkDeviceMemory memory;
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to allocate uniform buffer memory");
-        }
-
-        uniformBufferMemories_[i] = jelly::core::ManagedResource<VkDeviceMemory>(
-            memory, [device](VkDeviceMemory m){ vkFreeMemory(device, m, nullptr); }, VK_NULL_HANDLE
-        );
-
-        vkBindBufferMemory(device, buffer, memory, 0);
-    }
-}
-
 void VulkanShader::createDescriptorSetLayout() {
     VkDevice device = api_->getDevice();
 
     VkDescriptorSetLayoutBinding uboLayoutBinding{};
     uboLayoutBinding.binding = 0;
-    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     uboLayoutBinding.descriptorCount = 1;
     uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     uboLayoutBinding.pImmutableSamplers = nullptr;
@@ -170,17 +138,19 @@ void VulkanShader::createDescriptorSetLayout() {
 void VulkanShader::createDescriptorPool() {
     VkDevice device = api_->getDevice();
     
+    const uint32_t frameCount = api_->getFramesInFlight();
+
     std::array<VkDescriptorPoolSize, 2> poolSizes{};
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = MAX_FRAMES_IN_FLIGHT;
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = frameCount;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = MAX_FRAMES_IN_FLIGHT;
+    poolSizes[1].descriptorCount = frameCount;
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
     poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    poolInfo.maxSets = frameCount;
 
     VkDescriptorPool pool;
     if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
@@ -196,12 +166,13 @@ void VulkanShader::createDescriptorPool() {
 
 void VulkanShader::allocateDescriptorSets() {
     VkDevice device = api_->getDevice();
-    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayout_.get());
+    std::vector<VkDescriptorSetLayout> layouts(api_->getFramesInFlight(), descriptorSetLayout_.get());
+    descriptorSets_.assign(layouts.size(), VK_NULL_HANDLE);
 
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool = descriptorPool_.get();
-    allocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
     allocInfo.pSetLayouts = layouts.data();
 
     if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets_.data()) != VK_SUCCESS) {
@@ -211,7 +182,6 @@ void VulkanShader::allocateDescriptorSets() {
 
 void VulkanShader::initializeDefaultTexture() {
     VkDevice device = api_->getDevice();
-    VkPhysicalDevice physicalDevice = api_->getPhysicalDevice();
 
     std::vector<uint8_t> whitePixel = {255, 255, 255, 255};
 
@@ -235,36 +205,8 @@ void VulkanShader::initializeDefaultTexture() {
         throw std::runtime_error("Failed to create default texture image");
     }
 
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(device, image, &memRequirements);
-
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-
-    uint32_t memoryTypeIndex = UINT32_MAX;
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i) {
-        if ((memRequirements.memoryTypeBits & (1 << i)) &&
-            (memProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
-            memoryTypeIndex = i;
-            break;
-        }
-    }
-
-    if (memoryTypeIndex == UINT32_MAX) {
-        throw std::runtime_error("Failed to find memory type for default texture");
-    }
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = memoryTypeIndex;
-
-    VkDeviceMemory imageMemory;
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate memory for default texture");
-    }
-
-    vkBindImageMemory(device, image, imageMemory, 0);
+    VulkanMemoryAllocator* allocator = api_->getMemoryAllocator();
+    MemoryAllocation* imageMemory = allocator->allocateForImage(image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -306,7 +248,7 @@ void VulkanShader::initializeDefaultTexture() {
     }
 
     defaultTextureImage_ = jelly::core::ManagedResource<VkImage>(image, [device](VkImage i){ vkDestroyImage(device, i, nullptr); }, VK_NULL_HANDLE);
-    defaultTextureMemory_ = jelly::core::ManagedResource<VkDeviceMemory>(imageMemory, [device](VkDeviceMemory m){ vkFreeMemory(device, m, nullptr); }, VK_NULL_HANDLE);
+    defaultTextureMemory_ = jelly::core::ManagedResource<MemoryAllocation*>(imageMemory, [allocator](MemoryAllocation* m){ allocator->free(m); }, nullptr);
     defaultTextureView_ = jelly::core::ManagedResource<VkImageView>(imageView, [device](VkImageView v){ vkDestroyImageView(device, v, nullptr); }, VK_NULL_HANDLE);
     defaultTextureSampler_ = jelly::core::ManagedResource<VkSampler>(sampler, [device](VkSampler s){ vkDestroySampler(device, s, nullptr); }, VK_NULL_HANDLE);
 }
@@ -314,8 +256,11 @@ void VulkanShader::initializeDefaultTexture() {
 void VulkanShader::updateDescriptorSets() {
     VkDevice device = api_->getDevice();
 
-    std::vector<const VulkanShaderModule*> modules = { vertex_.get(), fragment_.get() };
-    std::unordered_map<uint32_t, VkDescriptorType> bindingTypes;
+    // Scratch only: everything below is consumed by vkUpdateDescriptorSets
+    core::FrameAllocator::Scope scope;
+
+    const VulkanShaderModule* modules[] = { vertex_.get(), fragment_.get() };
+    std::pmr::unordered_map<uint32_t, VkDescriptorType> bindingTypes(scope.resource());
 
     for (const auto* module : modules) {
         SpvReflectShaderModule reflectModule;
@@ -328,7 +273,7 @@ void VulkanShader::updateDescriptorSets() {
 
         uint32_t count = 0;
         spvReflectEnumerateDescriptorBindings(&reflectModule, &count, nullptr);
-        std::vector<SpvReflectDescriptorBinding*> bindings(count);
+        std::pmr::vector<SpvReflectDescriptorBinding*> bindings(count, scope.resource());
         spvReflectEnumerateDescriptorBindings(&reflectModule, &count, bindings.data());
 
         for (auto* binding : bindings) {
@@ -338,8 +283,17 @@ void VulkanShader::updateDescriptorSets() {
         spvReflectDestroyShaderModule(&reflectModule);
     }
 
-    for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
-        std::vector<VkWriteDescriptorSet> writes;
+    VulkanRingBuffer* uniformRing = api_->getUniformRingBuffer();
+
+    for (size_t frame = 0; frame < descriptorSets_.size(); ++frame) {
+        std::pmr::vector<VkWriteDescriptorSet> writes(scope.resource());
+        std::pmr::vector<VkDescriptorBufferInfo> bufferInfos(scope.resource());
+        std::pmr::vector<VkDescriptorImageInfo> imageInfos(scope.resource());
+
+        // Infos are referenced by pointer until vkUpdateDescriptorSets, so no reallocation
+        writes.reserve(bindingTypes.size());
+        bufferInfos.reserve(bindingTypes.size());
+        imageInfos.reserve(bindingTypes.size());
 
         for (auto& [binding, type] : bindingTypes) {
             VkWriteDescriptorSet write{};
@@ -351,15 +305,17 @@ void VulkanShader::updateDescriptorSets() {
             write.descriptorType = type;
 
             if (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
-                VkDescriptorBufferInfo bufferInfo{};
-                bufferInfo.buffer = uniformBuffers_[frame].get();
+                // Uniform blocks are sub-allocated per draw from the frame's ring buffer
+                VkDescriptorBufferInfo& bufferInfo = bufferInfos.emplace_back();
+                bufferInfo.buffer = uniformRing->getBuffer(static_cast<uint32_t>(frame));
                 bufferInfo.offset = 0;
                 bufferInfo.range = uniformBufferSize;
 
+                write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
                 write.pBufferInfo = &bufferInfo;
                 writes.push_back(write);
             } else if (type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
-                VkDescriptorImageInfo imageInfo{};
+                VkDescriptorImageInfo& imageInfo = imageInfos.emplace_back();
                 imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
                 imageInfo.imageView = boundTextures[binding].imageView ? boundTextures[binding].imageView : defaultTextureView_.get();
                 imageInfo.sampler   = boundTextures[binding].sampler   ? boundTextures[binding].sampler   : defaultTextureSampler_.get();
@@ -375,11 +331,10 @@ void VulkanShader::updateDescriptorSets() {
     }
 }
 
-void VulkanShader::flushUniforms(uint32_t frameIndex) {
-    void* data;
-    vkMapMemory(api_->getDevice(), uniformBufferMemories_[frameIndex], 0, uniformBufferSize, 0, &data);
-    memcpy(data, cpuUniformData.data(), uniformBufferSize);
-    vkUnmapMemory(api_->getDevice(), uniformBufferMemories_[frameIndex]);
+uint32_t VulkanShader::commitUniforms() {
+    RingAllocation slice = api_->getUniformRingBuffer()->allocate(uniformBufferSize);
+    memcpy(slice.data, cpuUniformData.data(), uniformBufferSize);
+    return static_cast<uint32_t>(slice.offset);
 }
 
 void VulkanShader::bind() {
@@ -395,20 +350,15 @@ void VulkanShader::release() {
         fragment_.reset();
         vertex_.reset();
 
-        for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-            uniformBuffers_[i].reset();
-            uniformBufferMemories_[i].reset();
-        }
-
         descriptorSetLayout_.reset();
         descriptorPool_.reset();
 
-        descriptorSets_.fill(VK_NULL_HANDLE);
+        descriptorSets_.clear();
 
         defaultTextureSampler_.reset();
         defaultTextureView_.reset();
-        defaultTextureMemory_.reset();
         defaultTextureImage_.reset();
+        defaultTextureMemory_.reset();
     }
 }
 
@@ -416,14 +366,12 @@ void VulkanShader::setUniformVec3(const char* name, const float* vec) {
     auto it = uniformOffsets.find(name);
     if (it == uniformOffsets.end()) return;
     memcpy(cpuUniformData.data() + it->second, vec, sizeof(float) * 3);
-    flushUniforms(api_->getCurrentFrameIndex());
 }
 
 void VulkanShader::setUniformMat4(const char* name, const float* matrix) {
     auto it = uniformOffsets.find(name);
     if (it == uniformOffsets.end()) return;
     memcpy(cpuUniformData.data() + it->second, matrix, sizeof(float) * 16);
-    flushUniforms(api_->getCurrentFrameIndex());
 }
 
 void VulkanShader::updateTextureDescriptor(VkImageView imageView, VkSampler sampler, uint32_t binding, uint32_t frameIndex)
@@ -462,7 +410,7 @@ VkDescriptorSetLayout VulkanShader::getDescriptorSetLayout() const {
 }
 
 VkDescriptorSet VulkanShader::getDescriptorSet(uint32_t frameIndex) const {
-    return descriptorSets_[frameIndex % MAX_FRAMES_IN_FLIGHT];
+    return descriptorSets_[frameIndex % descriptorSets_.size()];
 }
 
 uint32_t VulkanShader::getUniformBinding(const std::string& name) const { 
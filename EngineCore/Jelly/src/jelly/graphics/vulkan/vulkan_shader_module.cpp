@@ -2,6 +2,7 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <string_view>
 
 namespace jelly::graphics::vulkan {
 
@@ -34,6 +35,9 @@ VulkanShaderModule::VulkanShaderModule(
         std::cerr << "vkCreateShaderModule failed with error code: " << result << std::endl;
         throw std::runtime_error("Failed to create shader module");
     }
+
+    codeHash_ = std::hash<std::string_view>{}(
+        std::string_view(reinterpret_cast<const char*>(spirvCode_.data()), spirvCode_.size()));
 }
 
 VulkanShaderModule::~VulkanShaderModule() {
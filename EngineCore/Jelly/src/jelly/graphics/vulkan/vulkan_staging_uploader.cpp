@@ -0,0 +1,207 @@
+#include "jelly/graphics/vulkan/vulkan_staging_uploader.hpp"
+
+#include "jelly/exception.hpp"
+#include "jelly/graphics/vulkan/vulkan_buffer_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace jelly::graphics::vulkan {
+
+VulkanStagingUploader::VulkanStagingUploader(
+    VkDevice device,
+    VulkanMemoryAllocator& allocator,
+    VkQueue transferQueue,
+    uint32_t transferFamily,
+    uint32_t graphicsFamily)
+    : device_(device),
+      allocator_(allocator),
+      transferQueue_(transferQueue),
+      transferFamily_(transferFamily),
+      graphicsFamily_(graphicsFamily),
+      queueFamilies_{ graphicsFamily, transferFamily }
+{
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = transferFamily_;
+
+    if (vkCreateCommandPool(device_, &poolInfo, nullptr, &commandPool_) != VK_SUCCESS) {
+        throw Exception("Failed to create transfer command pool!");
+    }
+}
+
+VulkanStagingUploader::~VulkanStagingUploader() {
+    release();
+}
+
+void VulkanStagingUploader::upload(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset) {
+    if (size == 0) return;
+
+    std::lock_guard lock(mutex_);
+
+    if (openBatch_.commandBuffer == VK_NULL_HANDLE) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = commandPool_;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(device_, &allocInfo, &openBatch_.commandBuffer) != VK_SUCCESS) {
+            throw Exception("Failed to allocate transfer command buffer!");
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(openBatch_.commandBuffer, &beginInfo);
+    }
+
+    StagingChunk& chunk = acquireChunk(size);
+    std::memcpy(chunk.mapped + chunk.used, data, static_cast<size_t>(size));
+
+    VkBufferCopy region{};
+    region.srcOffset = chunk.used;
+    region.dstOffset = dstOffset;
+    region.size = size;
+    vkCmdCopyBuffer(openBatch_.commandBuffer, chunk.buffer, dstBuffer, 1, &region);
+
+    // Keep every copy source 16-byte aligned
+    chunk.used = (chunk.used + size + 15) & ~VkDeviceSize(15);
+}
+
+VkSemaphore VulkanStagingUploader::flush(VkFence consumerFence) {
+    std::lock_guard lock(mutex_);
+
+    recycleFinishedBatches(false);
+
+    if (openBatch_.commandBuffer == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+
+    vkEndCommandBuffer(openBatch_.commandBuffer);
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    if (vkCreateFence(device_, &fenceInfo, nullptr, &openBatch_.fence) != VK_SUCCESS ||
+        vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &openBatch_.semaphore) != VK_SUCCESS) {
+        throw Exception("Failed to create transfer synchronization objects!");
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &openBatch_.commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &openBatch_.semaphore;
+
+    if (vkQueueSubmit(transferQueue_, 1, &submitInfo, openBatch_.fence) != VK_SUCCESS) {
+        throw Exception("Failed to submit transfer batch!");
+    }
+
+    openBatch_.consumerFence = consumerFence;
+
+    VkSemaphore semaphore = openBatch_.semaphore;
+    submittedBatches_.push_back(std::move(openBatch_));
+    openBatch_ = Batch{};
+    return semaphore;
+}
+
+const uint32_t* VulkanStagingUploader::getQueueFamilyIndices(uint32_t& outCount) const {
+    outCount = usesDedicatedTransferQueue() ? 2 : 1;
+    return queueFamilies_;
+}
+
+void VulkanStagingUploader::release() {
+    if (device_ == VK_NULL_HANDLE) return;
+
+    std::lock_guard lock(mutex_);
+
+    recycleFinishedBatches(true);
+
+    // A batch that was never flushed is simply dropped
+    if (openBatch_.commandBuffer != VK_NULL_HANDLE) {
+        vkEndCommandBuffer(openBatch_.commandBuffer);
+        for (auto& chunk : openBatch_.chunks) destroyChunk(chunk);
+        openBatch_ = Batch{};
+    }
+
+    for (auto& chunk : freeChunks_) destroyChunk(chunk);
+    freeChunks_.clear();
+
+    if (commandPool_ != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(device_, commandPool_, nullptr);
+        commandPool_ = VK_NULL_HANDLE;
+    }
+
+    device_ = VK_NULL_HANDLE;
+}
+
+VulkanStagingUploader::StagingChunk& VulkanStagingUploader::acquireChunk(VkDeviceSize size) {
+    auto& chunks = openBatch_.chunks;
+    if (!chunks.empty() && chunks.back().used + size <= chunks.back().size) {
+        return chunks.back();
+    }
+
+    if (size <= CHUNK_SIZE && !freeChunks_.empty()) {
+        chunks.push_back(freeChunks_.back());
+        freeChunks_.pop_back();
+        chunks.back().used = 0;
+        return chunks.back();
+    }
+
+    StagingChunk chunk;
+    chunk.size = std::max(size, CHUNK_SIZE);
+    VulkanBufferUtils::createBuffer(
+        allocator_,
+        device_,
+        chunk.size,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        chunk.buffer,
+        chunk.memory
+    );
+    chunk.mapped = chunk.memory->mapped;
+
+    chunks.push_back(chunk);
+    return chunks.back();
+}
+
+void VulkanStagingUploader::recycleFinishedBatches(bool deviceIdle) {
+    auto finished = [this, deviceIdle](Batch& batch) {
+        if (!deviceIdle) {
+            if (vkGetFenceStatus(device_, batch.fence) != VK_SUCCESS) return false;
+
+            // The semaphore stays in use until the submission waiting on it is done.
+            // The frame fence may already be reused, which only delays recycling.
+            if (batch.consumerFence != VK_NULL_HANDLE &&
+                vkGetFenceStatus(device_, batch.consumerFence) != VK_SUCCESS) return false;
+        }
+
+        for (auto& chunk : batch.chunks) {
+            if (chunk.size == CHUNK_SIZE) {
+                freeChunks_.push_back(chunk);
+            } else {
+                destroyChunk(chunk);
+            }
+        }
+
+        vkFreeCommandBuffers(device_, commandPool_, 1, &batch.commandBuffer);
+        vkDestroyFence(device_, batch.fence, nullptr);
+        vkDestroySemaphore(device_, batch.semaphore, nullptr);
+        return true;
+    };
+
+    submittedBatches_.erase(
+        std::remove_if(submittedBatches_.begin(), submittedBatches_.end(), finished),
+        submittedBatches_.end());
+}
+
+void VulkanStagingUploader::destroyChunk(StagingChunk& chunk) {
+    if (chunk.buffer) vkDestroyBuffer(device_, chunk.buffer, nullptr);
+    allocator_.free(chunk.memory);
+    chunk = StagingChunk{};
+}
+
+} // namespace jelly::graphics::vulkan
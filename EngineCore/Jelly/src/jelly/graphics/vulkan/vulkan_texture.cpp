@@ -5,6 +5,8 @@
 
 #include "jelly/graphics/image.hpp"
 
+#include <cstring>
+
 namespace jelly::graphics::vulkan {
 
 VulkanTexture::VulkanTexture(VulkanGraphicAPI* api) 
@@ -20,30 +22,26 @@ void VulkanTexture::upload(const Image& image) {
     height_ = image.getHeight();
     
     VkDevice device = api_->getDevice();
-    VkPhysicalDevice physicalDevice = api_->getPhysicalDevice();
-    VkCommandPool commandPool = api_->getCommandPool();
-    VkQueue graphicsQueue = api_->getGraphicsQueue();
+    VulkanMemoryAllocator* allocator = api_->getMemoryAllocator();
 
-    // Create staging buffer
+    // Create staging buffer; it only lives for this upload
     VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
+    MemoryAllocation* stagingBufferMemory;
     VkDeviceSize imageSize = width_ * height_ * 4; // Assuming RGBA
 
     VulkanBufferUtils::createBuffer(
+        *allocator,
         device,
-        physicalDevice,
         imageSize,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         stagingBuffer,
-        stagingBufferMemory
+        stagingBufferMemory,
+        MemoryStrategy::Linear
     );
 
     // Copy pixel data to buffer
-    void* data;
-    vkMapMemory(device, stagingBufferMemory, 0, imageSize, 0, &data);
-    memcpy(data, image.getPixels().data(), static_cast<size_t>(imageSize));
-    vkUnmapMemory(device, stagingBufferMemory);
+    memcpy(stagingBufferMemory->mapped, image.getPixels().data(), static_cast<size_t>(imageSize));
 
     // Create Vulkan image
     VkImageCreateInfo imageInfo{};
@@ -73,32 +71,13 @@ void VulkanTexture::upload(const Image& image) {
         VK_NULL_HANDLE
     );
 
-    // Allocate image memory
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(device, image_.get(), &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = VulkanBufferUtils::findMemoryType(
-        physicalDevice,
-        memRequirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    // Allocate and bind image memory
+    imageMemory_ = jelly::core::ManagedResource<MemoryAllocation*>(
+        allocator->allocateForImage(image_.get(), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+        [allocator](MemoryAllocation* allocation) { allocator->free(allocation); },
+        nullptr
     );
 
-    VkDeviceMemory vkImageMemory;
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &vkImageMemory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate image memory!");
-    }
-
-    imageMemory_ = jelly::core::ManagedResource<VkDeviceMemory>(
-        vkImageMemory,
-        [device](VkDeviceMemory mem) { vkFreeMemory(device, mem, nullptr); },
-        VK_NULL_HANDLE
-    );
-
-    vkBindImageMemory(device, image_.get(), imageMemory_.get(), 0);
-
     // Transition image layout and copy buffer to image
     transitionImageLayout(image_.get(), VK_FORMAT_R8G8B8A8_SRGB, 
         VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
@@ -110,7 +89,7 @@ void VulkanTexture::upload(const Image& image) {
 
     // Clean up staging resources
     vkDestroyBuffer(device, stagingBuffer, nullptr);
-    vkFreeMemory(device, stagingBufferMemory, nullptr);
+    allocator->free(stagingBufferMemory);
 
     // Create image view
     VkImageViewCreateInfo viewInfo{};
@@ -173,8 +152,8 @@ void VulkanTexture::release()
 
     sampler_.reset();
     imageView_.reset();
-    imageMemory_.reset();
     image_.reset();
+    imageMemory_.reset();
 
     width_  = 0;
     height_ = 0;
@@ -1,48 +1,92 @@
 #include "jelly/jelly.hpp"
 
+#include "jelly/error.hpp"
 #include "jelly/exception.hpp"
 #include "jelly/core/game_time.hpp"
+#include "jelly/core/frame_timings.hpp"
+#include "jelly/core/frame_allocator.hpp"
+#include "jelly/core/job_system.hpp"
+#include "jelly/core/profiler.hpp"
 #include "jelly/graphics/graphic_context.hpp"
 #include "jelly/graphics/graphic_api_factory.hpp"
 #include "jelly/windowing/window_system_factory.hpp"
 #include "jelly/windowing/window_graphic_api_binder.hpp"
 
+#include <chrono>
+
 namespace jelly {
 
 bool Jelly::initialize(GraphicAPIType graphicAPIType, const WindowSettings &windowSettings) {
     
     sceneManager_ = std::make_unique<core::SceneManager>();
 
+    core::Profiler::setThreadName("Main Thread");
+
+    core::JobSystem::get().initialize(windowSettings.jobThreads);
+
     // Headless mode
     if (graphicAPIType == GraphicAPIType::NoApi) {
         isHeadless_ = true;
         return true;
     }
 
-    windowSystem_ = windowing::WindowSystemFactory::create(graphicAPIType);
+    // Offscreen rendering, no window system
+    if (windowSettings.headless) {
+        isHeadless_ = true;
 
-    if (!windowSystem_) {
-        return false;
-    }
+        graphicAPI_ = graphics::GraphicsAPIFactory::create(graphicAPIType);
+
+        if (!graphicAPI_ || !graphicAPI_->setOffscreenTarget(
+                static_cast<uint32_t>(windowSettings.width),
+                static_cast<uint32_t>(windowSettings.height),
+                windowSettings.frameReadback)) {
+            return false;
+        }
+    } else {
+        windowSystem_ = windowing::WindowSystemFactory::create(graphicAPIType);
 
-    windowSystem_->createWindow(windowSettings);
+        if (!windowSystem_) {
+            return false;
+        }
 
-    graphicAPI_ = graphics::GraphicsAPIFactory::create(graphicAPIType);
+        windowSystem_->createWindow(windowSettings);
 
-    if (!graphicAPI_) {
-        return false;
+        graphicAPI_ = graphics::GraphicsAPIFactory::create(graphicAPIType);
+
+        if (!graphicAPI_) {
+            return false;
+        }
+
+        if (!windowing::WindowGraphicAPIBinder::bind(graphicAPIType, windowSystem_.get(), graphicAPI_.get())) {
+            return false;
+        }
     }
 
-    if (!windowing::WindowGraphicAPIBinder::bind(graphicAPIType, windowSystem_.get(), graphicAPI_.get())) {
-        return false;
+    // Auto without vsync prefers tearing over waiting for the display
+    core::PresentMode presentMode = windowSettings.presentMode;
+    if (presentMode == core::PresentMode::Auto && !windowSettings.vsync) {
+        presentMode = core::PresentMode::Immediate;
     }
-    
+
+    graphicAPI_->setRecordingThreadCount(windowSettings.recordingThreads);
+    graphicAPI_->setFramesInFlight(windowSettings.framesInFlight);
+    graphicAPI_->setPresentMode(presentMode);
     graphicAPI_->initialize();
 
+    framePacer_.setTargetFrameRate(windowSettings.targetFrameRate);
+    framePacer_.setLowLatency(windowSettings.lowLatency);
+
+    fixedTimestep_.setTickRate(windowSettings.fixedTickRate);
+    fixedTimestep_.setMaxStepsPerFrame(windowSettings.maxFixedSteps);
+
     graphics::GraphicContext::get().initialize(graphicAPIType, graphicAPI_.get());
 
     jelly::core::GameTime::initialize();
 
+    if (windowSettings.renderThread) {
+        renderThread_.start();
+    }
+
     return true;
 }
 
@@ -51,36 +95,115 @@ bool Jelly::isHeadless() const {
 }
 
 bool Jelly::isRunning() const {
-    // TODO : move to proper place later
-    jelly::core::GameTime::update();
     if (isHeadless_) return true;
     return windowSystem_ && windowSystem_->isWindowOpen();
 }
 
 void Jelly::pollEvents() {
-    if (!isHeadless_ && windowSystem_) {
+    framePacer_.beginFrame();
+
+    jelly::core::GameTime::update();
+    jelly::core::FrameAllocator::local().reset();
+
+    if (windowSystem_) {
         windowSystem_->pollEvents();
     }
 }
 
 void Jelly::update() {
+    JELLY_PROFILE_SCOPE("Jelly::update");
+    core::ScopedFrameTiming timing(core::FramePhase::Update);
+
+    const uint32_t steps = fixedTimestep_.advance(core::GameTime::deltaTime());
+    core::GameTime::setFixedStep(static_cast<float>(fixedTimestep_.getStepSeconds()), fixedTimestep_.getAlpha());
+
+    for (uint32_t step = 0; step < steps; ++step) {
+        sceneManager_->fixedUpdate();
+    }
+
+    sceneManager_->interpolateActiveScene(fixedTimestep_.getAlpha());
     sceneManager_->updateActiveScene();
 }
 
 void Jelly::render() {
-    if (!isHeadless_ && windowSystem_) {
-        graphicAPI_->beginFrame();
-        sceneManager_->renderActiveScene();
-        graphicAPI_->endFrame();
+    JELLY_PROFILE_SCOPE("Jelly::render");
+    if (!graphicAPI_) return;
+
+    // Copied on the main thread, so recording never reads the registry
+    const uint64_t frame = frameIndex_++;
+    sceneManager_->extractActiveScene(frame);
+
+    if (!renderThread_.isRunning()) {
+        renderFrame(frame);
+        completeFrame();
+        return;
     }
+
+    // The previous frame must be done before the next snapshot is handed over
+    waitForRender();
+    completeFrame();
+    // The next frame is extracted while this one renders, so the frame to draw is handed over
+    renderThread_.submit([this, frame] {
+        // The render thread has its own frame allocator
+        core::FrameAllocator::local().reset();
+        renderFrame(frame);
+    });
+}
+
+void Jelly::renderFrame(uint64_t frame) {
+    JELLY_PROFILE_SCOPE("Jelly::renderFrame");
+    graphicAPI_->beginFrame();
+    sceneManager_->renderActiveScene(frame);
+    graphicAPI_->endFrame();
+}
+
+void Jelly::completeFrame() {
+    // Nothing is recording at this point, so the phase totals are complete
+    core::FrameTimings::endFrame();
+
+    hasGpuFrameStats_ = graphicAPI_->getGpuFrameStats(gpuFrameStats_);
+    framePacer_.endFrame(hasGpuFrameStats_ ? gpuFrameStats_.frameMs : 0.0);
+}
+
+void Jelly::waitForRender() {
+    if (!renderThread_.isRunning()) return;
+
+    // Window events keep flowing meanwhile: a minimized window stalls the render thread until restored
+    while (!renderThread_.waitFor(std::chrono::milliseconds(10))) {
+        if (windowSystem_) {
+            windowSystem_->pollEvents();
+        }
+    }
+}
+
+bool Jelly::getGpuFrameStats(graphics::GpuFrameStats& stats) const {
+    if (!hasGpuFrameStats_) return false;
+    stats = gpuFrameStats_;
+    return true;
+}
+
+bool Jelly::readFrame(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) {
+    waitForRender();
+    return graphicAPI_ && graphicAPI_->readFramePixels(pixels, width, height);
 }
 
 void Jelly::shutdown() {
-    if (!isHeadless_ && windowSystem_) {
+    try {
+        renderThread_.stop();
+    } catch (const std::exception& e) {
+        Error::Print(e);
+    }
+
+    if (graphicAPI_) {
         graphicAPI_->shutdown();
+    }
+
+    if (windowSystem_) {
         windowSystem_->destroyWindow();
         windowSystem_.reset();
     }
+
+    core::JobSystem::get().shutdown();
 }
 
 SceneManager& Jelly::getSceneManager() {
@@ -90,4 +213,12 @@ SceneManager& Jelly::getSceneManager() {
     return *sceneManager_;
 }
 
+core::FramePacer& Jelly::getFramePacer() {
+    return framePacer_;
+}
+
+core::FixedTimestep& Jelly::getFixedTimestep() {
+    return fixedTimestep_;
+}
+
 } // namespace jelly
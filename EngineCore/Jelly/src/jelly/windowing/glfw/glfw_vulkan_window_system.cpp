@@ -2,6 +2,7 @@
 
 #include "jelly/exception.hpp"
 
+#include <chrono>
 #include <iostream>
 
 namespace jelly::windowing::glfw {
@@ -43,19 +44,41 @@ void GLFWVulkanWindowSystem::createWindow(const WindowSettings &settings) {
     glfwShowWindow(window_.get());
     glfwRestoreWindow(window_.get());
     glfwFocusWindow(window_.get());
+
+    windowThread_ = std::this_thread::get_id();
+    cacheFramebufferSize();
 }
 
-void GLFWVulkanWindowSystem::getFramebufferSize(uint32_t &width, uint32_t &height)
+void GLFWVulkanWindowSystem::pollEvents()
+{
+    GLFWWindowSystem::pollEvents();
+    cacheFramebufferSize();
+}
+
+void GLFWVulkanWindowSystem::cacheFramebufferSize()
 {
     int iw, ih;
     glfwGetFramebufferSize(window_.get(), &iw, &ih);
-    width = static_cast<uint32_t>(iw);
-    height = static_cast<uint32_t>(ih);
+    framebufferWidth_.store(static_cast<uint32_t>(iw), std::memory_order_relaxed);
+    framebufferHeight_.store(static_cast<uint32_t>(ih), std::memory_order_relaxed);
+}
+
+void GLFWVulkanWindowSystem::getFramebufferSize(uint32_t &width, uint32_t &height)
+{
+    if (std::this_thread::get_id() == windowThread_) {
+        cacheFramebufferSize();
+    }
+    width = framebufferWidth_.load(std::memory_order_relaxed);
+    height = framebufferHeight_.load(std::memory_order_relaxed);
 }
 
 void GLFWVulkanWindowSystem::waitEvents()
 {
-    glfwWaitEvents();
+    if (std::this_thread::get_id() == windowThread_) {
+        glfwWaitEvents();
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
 }
 
 void *GLFWVulkanWindowSystem::getNativeWindowHandle()
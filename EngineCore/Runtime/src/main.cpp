@@ -7,6 +7,7 @@
 #include "jelly/graphics/mesh_renderer_system.hpp"
 #include "jelly/graphics/material_factory.hpp"
 #include "jelly/core/transform.hpp"
+#include "jelly/core/interpolated_transform.hpp"
 #include "jelly/core/hierarchy.hpp"
 #include "jelly/core/transform_system.hpp"
 #include "jelly/core/camera.hpp"
@@ -74,6 +75,7 @@ int main() {
     registry.emplace<jelly::graphics::MeshComponent>(entity, mesh);
     registry.emplace<jelly::graphics::MaterialComponent>(entity, material);
     registry.emplace<Rotate>(entity, 1.0f);
+    registry.emplace<jelly::core::InterpolatedTransform>(entity);
 
     auto meshRendererSystem = std::make_shared<jelly::graphics::MeshRendererSystem>(scene->getEntityManager());
     scene->addGameSystem(meshRendererSystem);
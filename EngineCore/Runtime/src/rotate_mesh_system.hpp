@@ -2,6 +2,7 @@
 
 #include "jelly/core/camera.hpp"
 #include "jelly/core/game_time.hpp"
+#include "jelly/core/job_system.hpp"
 #include "jelly/core/transform.hpp"
 #include "jelly/core/game_system_interface.hpp"
 
@@ -18,12 +19,17 @@ public:
     explicit RotateMeshSystem(entt::registry& registry)
         : registry_(registry) {}
 
-    void update() override {
-        float dt = jelly::core::GameTime::deltaTime();
+    void declareAccess(jelly::core::SystemAccess& access) const override {
+        access.reads<Rotate>().writes<jelly::core::Transform>();
+    }
+
+    // Runs at the fixed tick rate; InterpolatedTransform smooths the rotation between ticks
+    void fixedUpdate() override {
+        float dt = jelly::core::GameTime::fixedDeltaTime();
 
         auto view = registry_.view<jelly::core::Transform, Rotate>();
 
-        view.each([dt](auto& transform, auto& rotate){
+        jelly::core::JobSystem::get().parallelForEach(view, [dt](auto /*entity*/, auto& transform, auto& rotate){
             glm::vec3 eulerDelta = glm::vec3(rotate.speed * dt);
 
             glm::quat incremental = glm::quat(eulerDelta);
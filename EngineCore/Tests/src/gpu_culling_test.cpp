@@ -0,0 +1,273 @@
+// Culls the same static scene on the GPU and on the CPU, and checks the draws
+// and instances written by the compute pass match the visible set of
+// Frustum::testBoxes, including boxes straddling a frustum plane.
+//
+// Usage: GpuCullingTest [shader]   (default "instanced", must read per-instance matrices)
+
+#include "headless_test.hpp"
+
+#include "jelly/core/bounds.hpp"
+#include "jelly/core/camera.hpp"
+#include "jelly/core/camera_system.hpp"
+#include "jelly/core/frustum.hpp"
+#include "jelly/core/scene.hpp"
+#include "jelly/core/transform.hpp"
+#include "jelly/core/transform_system.hpp"
+#include "jelly/graphics/graphic_context.hpp"
+#include "jelly/graphics/material_factory.hpp"
+#include "jelly/graphics/mesh_factory.hpp"
+#include "jelly/graphics/mesh_renderer_system.hpp"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace jelly;
+using namespace jelly::tests;
+
+namespace {
+
+constexpr uint32_t WIDTH = 320;
+constexpr uint32_t HEIGHT = 240;
+constexpr int GRID_HALF_SIDE = 10;   // Grid of 21 x 21 per layer, wider than the frustum
+constexpr float GRID_SPACING = 2.0f;
+const float LAYER_DEPTHS[] = { 0.0f, -8.0f, 25.0f }; // The last one is behind the camera
+constexpr float CAMERA_DISTANCE = 20.0f;
+
+// Boxes closer than this to the visibility threshold are left out: the CPU
+// and the GPU round differently, and either answer would be right
+constexpr float MIN_PLANE_MARGIN = 0.05f;
+
+// A visible instance: mesh (by first index in the geometry arena) and translation
+using InstanceKey = std::tuple<uint32_t, float, float, float>;
+
+// Signed distance of a box to the visibility threshold: negative once outside a plane
+float visibilityMargin(const core::Frustum& frustum, const core::BoundingBox& box) {
+    const glm::vec3 center = box.getCenter();
+    const glm::vec3 extents = box.getExtents();
+
+    float margin = INFINITY;
+    for (int plane = 0; plane < core::Frustum::PlaneCount; ++plane) {
+        const glm::vec4& p = frustum.getPlane(static_cast<core::Frustum::Plane>(plane));
+        const glm::vec3 normal(p);
+        margin = std::min(margin, glm::dot(normal, center) + p.w + glm::dot(glm::abs(normal), extents));
+    }
+    return margin;
+}
+
+InstanceKey makeKey(const graphics::Mesh* mesh, const glm::mat4& world) {
+    return { mesh->getGeometryRange().firstIndex, world[3].x, world[3].y, world[3].z };
+}
+
+int runTest(Jelly& jelly, const char* shaderName) {
+    using namespace jelly::core;
+    using namespace jelly::graphics;
+
+    auto shader = loadShader(shaderName);
+    if (!shader) return FAILED;
+    if (!shader->supportsInstancing()) {
+        std::fprintf(stderr, "Shader '%s' has no per-instance matrix\n", shaderName);
+        return FAILED;
+    }
+
+    auto* api = GraphicContext::get().getAPI();
+    if (!api->supportsGpuCulling()) {
+        std::fprintf(stderr, "GPU culling unsupported\n");
+        return SKIPPED;
+    }
+    api->setGpuCullingReadback(true);
+
+    auto scene = std::make_unique<Scene>("GpuCullingTest");
+    auto& registry = scene->getEntityManager();
+    scene->addGameSystem(std::make_shared<TransformSystem>(registry));
+
+    auto cameraEntity = registry.create();
+    registry.emplace<Transform>(cameraEntity).setLocalPosition(glm::vec3(0.0f, 0.0f, CAMERA_DISTANCE));
+    registry.emplace<Camera>(cameraEntity);
+    scene->addGameSystem(std::make_shared<CameraSystem>(
+        registry, static_cast<float>(WIDTH), static_cast<float>(HEIGHT)));
+
+    auto meshRenderer = std::make_shared<MeshRendererSystem>(registry);
+    scene->addGameSystem(meshRenderer);
+
+    jelly.getSceneManager().addScene(std::move(scene));
+    jelly.getSceneManager().setActiveScene(0);
+
+    // One frame to place the camera, so the scene can avoid boxes on a plane
+    runFrame(jelly);
+    const Camera& camera = registry.get<Camera>(cameraEntity);
+    const Frustum frustum(camera.projection * camera.view);
+
+    std::vector<MaterialHandle> materials = { MaterialFactory::create(shader), MaterialFactory::create(shader) };
+    MeshHandle meshes[] = { MeshFactory::cube(), MeshFactory::quad() };
+
+    uint32_t entityCount = 0;
+    uint32_t index = 0;
+    for (float depth : LAYER_DEPTHS) {
+        for (int y = -GRID_HALF_SIDE; y <= GRID_HALF_SIDE; ++y) {
+            for (int x = -GRID_HALF_SIDE; x <= GRID_HALF_SIDE; ++x, ++index) {
+                const glm::vec3 position(x * GRID_SPACING, y * GRID_SPACING, depth);
+                const glm::quat rotation(glm::vec3(0.3f * (index % 7), 0.2f * (index % 11), 0.0f));
+                const glm::vec3 scale(0.5f + 0.25f * (index % 4));
+                const MeshHandle& mesh = meshes[index % 2];
+
+                const glm::mat4 world = glm::translate(glm::mat4(1.0f), position)
+                                      * glm::mat4_cast(rotation)
+                                      * glm::scale(glm::mat4(1.0f), scale);
+                if (std::abs(visibilityMargin(frustum, mesh->getBoundingBox().transformed(world))) < MIN_PLANE_MARGIN) {
+                    continue;
+                }
+
+                auto entity = registry.create();
+                auto& transform = registry.emplace<Transform>(entity);
+                transform.setLocalPosition(position);
+                transform.setLocalRotationQuat(rotation);
+                transform.setLocalScale(scale);
+
+                registry.emplace<MeshComponent>(entity, mesh);
+                registry.emplace<MaterialComponent>(entity, materials[(index / 3) % 2]);
+                ++entityCount;
+            }
+        }
+    }
+
+    if (!runUntilReady(jelly, materials)) return fail("pipelines never became ready");
+
+    // CPU reference over the world matrices the renderer used
+    std::vector<float> centers[3], extents[3];
+    std::vector<InstanceKey> keys;
+    std::vector<MaterialInterface*> keyMaterials;
+    uint32_t straddling = 0;
+
+    auto view = registry.view<MeshComponent, MaterialComponent, Transform>();
+    view.each([&](auto, MeshComponent& mesh, MaterialComponent& material, Transform& transform) {
+        const BoundingBox box = mesh.mesh->getBoundingBox().transformed(transform.worldMatrix);
+        const glm::vec3 center = box.getCenter();
+        const glm::vec3 extent = box.getExtents();
+        for (int axis = 0; axis < 3; ++axis) {
+            centers[axis].push_back(center[axis]);
+            extents[axis].push_back(extent[axis]);
+        }
+        keys.push_back(makeKey(mesh.mesh.get(), transform.worldMatrix));
+        keyMaterials.push_back(material.material.get());
+
+        if (frustum.intersects(box) && !frustum.contains(box)) ++straddling;
+    });
+
+    const BoxSoA boxes = {
+        centers[0].data(), centers[1].data(), centers[2].data(),
+        extents[0].data(), extents[1].data(), extents[2].data()
+    };
+    std::vector<uint8_t> visible(keys.size());
+    const size_t visibleCount = frustum.testBoxes(boxes, keys.size(), visible.data());
+
+    std::vector<InstanceKey> expected;
+    std::map<InstanceKey, MaterialInterface*> materialOf;
+    std::set<std::pair<uint32_t, MaterialInterface*>> expectedDraws;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!visible[i]) continue;
+        expected.push_back(keys[i]);
+        materialOf[keys[i]] = keyMaterials[i];
+        expectedDraws.insert({ std::get<0>(keys[i]), keyMaterials[i] });
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::printf("CPU reference: %zu of %u entities visible, %u straddling a plane\n",
+        visibleCount, entityCount, straddling);
+    if (visibleCount == 0 || visibleCount == entityCount) return fail("scene does not exercise culling");
+    if (straddling == 0) return fail("no entity straddles a frustum plane");
+
+    // GPU pass
+    meshRenderer->setGpuCulling(true);
+    runFrame(jelly);
+
+    if (meshRenderer->getCullingStats().gpuCount != entityCount) {
+        return fail("%u of %u entities went to the GPU pass", meshRenderer->getCullingStats().gpuCount, entityCount);
+    }
+
+    GpuCullingResults results;
+    if (!api->readGpuCullingResults(results)) return fail("no culling results to read back");
+
+    std::vector<InstanceKey> culled;
+    uint32_t drawCount = 0;
+    for (size_t bucket = 0; bucket < results.buckets.size(); ++bucket) {
+        MaterialInterface* bucketMaterial = nullptr;
+
+        for (const DrawIndexedCommand& command : results.buckets[bucket]) {
+            if (command.instanceCount == 0) return fail("bucket %zu has an empty draw", bucket);
+            if (size_t(command.firstInstance + command.instanceCount) * 16 > results.instances.size()) {
+                return fail("bucket %zu draws past the instance stream", bucket);
+            }
+            ++drawCount;
+
+            for (uint32_t i = 0; i < command.instanceCount; ++i) {
+                const float* world = results.instances.data() + size_t(command.firstInstance + i) * 16;
+                const InstanceKey key = { command.firstIndex, world[12], world[13], world[14] };
+
+                auto it = materialOf.find(key);
+                if (it == materialOf.end()) {
+                    return fail("GPU kept an instance at (%.2f, %.2f, %.2f) the CPU culled",
+                        world[12], world[13], world[14]);
+                }
+                if (bucketMaterial && it->second != bucketMaterial) return fail("bucket %zu mixes materials", bucket);
+                bucketMaterial = it->second;
+
+                culled.push_back(key);
+            }
+        }
+    }
+    std::sort(culled.begin(), culled.end());
+
+    if (culled != expected) {
+        return fail("GPU kept %zu instances, the CPU %zu", culled.size(), expected.size());
+    }
+    if (drawCount != expectedDraws.size()) {
+        return fail("GPU wrote %u draws instead of %zu", drawCount, expectedDraws.size());
+    }
+    std::printf("GPU culling: %zu instances in %u draws, identical\n", culled.size(), drawCount);
+
+    // CPU pass
+    meshRenderer->setGpuCulling(false);
+    runFrame(jelly);
+
+    const CullingStats& stats = meshRenderer->getCullingStats();
+    if (stats.gpuCount != 0 || stats.testedCount != entityCount) {
+        return fail("CPU pass tested %u of %u entities", stats.testedCount, entityCount);
+    }
+    if (stats.visibleCount != visibleCount) {
+        return fail("CPU pass kept %u entities instead of %zu", stats.visibleCount, visibleCount);
+    }
+    std::printf("CPU culling: %u entities visible, identical\n", stats.visibleCount);
+
+    return PASSED;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* shaderName = argc > 1 ? argv[1] : "instanced";
+
+    Jelly jelly;
+    if (!initializeHeadless(jelly, WIDTH, HEIGHT)) return SKIPPED;
+
+    int result = FAILED;
+    try {
+        result = runTest(jelly, shaderName);
+    } catch (const std::exception& e) {
+        result = fail("%s", e.what());
+    }
+
+    jelly.shutdown();
+    return result;
+}
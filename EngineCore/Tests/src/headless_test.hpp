@@ -0,0 +1,81 @@
+#pragma once
+
+#include "jelly/jelly.hpp"
+#include "jelly/graphics/material.hpp"
+#include "jelly/graphics/shader_factory.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace jelly::tests {
+
+// Exit code ctest reports as skipped (SKIP_RETURN_CODE)
+constexpr int SKIPPED = 77;
+
+// Exit codes of a finished test
+constexpr int PASSED = 0;
+constexpr int FAILED = 1;
+
+// Starts the engine offscreen with frame readback; false without a usable Vulkan device
+inline bool initializeHeadless(Jelly& jelly, uint32_t width, uint32_t height) {
+    core::WindowSettings settings = { static_cast<int>(width), static_cast<int>(height), false, "JellyTests" };
+    settings.headless = true;
+    settings.frameReadback = true;
+
+    try {
+        if (jelly.initialize(core::GraphicAPIType::Vulkan, settings)) {
+            return true;
+        }
+        std::fprintf(stderr, "Headless Vulkan initialization failed\n");
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Headless Vulkan initialization failed: %s\n", e.what());
+    }
+    return false;
+}
+
+// Loads a shader compiled into the working directory by the TestShaders target; null if it is missing
+inline std::shared_ptr<graphics::ShaderInterface> loadShader(const std::string& name) {
+    try {
+        return graphics::ShaderFactory::createFromFiles(name);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Shader '%s' unavailable: %s\n", name.c_str(), e.what());
+        return nullptr;
+    }
+}
+
+// Runs one frame of the active scene
+inline void runFrame(Jelly& jelly) {
+    jelly.pollEvents();
+    jelly.update();
+    jelly.render();
+}
+
+// Runs frames until every material has its pipeline; the last frame draws all of them
+inline bool runUntilReady(Jelly& jelly, const std::vector<graphics::MaterialHandle>& materials, uint32_t maxFrames = 600) {
+    for (uint32_t frame = 0; frame < maxFrames; ++frame) {
+        const bool ready = std::all_of(materials.begin(), materials.end(),
+            [](const graphics::MaterialHandle& material) { return material->isReady(); });
+
+        runFrame(jelly);
+        if (ready) return true;
+    }
+
+    std::fprintf(stderr, "Materials not ready after %u frames\n", maxFrames);
+    return false;
+}
+
+// Prints the failure and returns FAILED
+template <typename... Args>
+int fail(const char* format, Args... args) {
+    std::fprintf(stderr, "FAILED: ");
+    std::fprintf(stderr, format, args...);
+    std::fprintf(stderr, "\n");
+    return FAILED;
+}
+
+} // namespace jelly::tests
@@ -0,0 +1,142 @@
+// Renders the same static scene with draws recorded on the main thread and on
+// recording threads, and checks the frames are identical.
+//
+// Usage: ParallelRecordingTest [shader]   (default "test", one draw per entity)
+
+#include "headless_test.hpp"
+
+#include "jelly/core/camera.hpp"
+#include "jelly/core/camera_system.hpp"
+#include "jelly/core/scene.hpp"
+#include "jelly/core/transform.hpp"
+#include "jelly/core/transform_system.hpp"
+#include "jelly/graphics/graphic_context.hpp"
+#include "jelly/graphics/material_factory.hpp"
+#include "jelly/graphics/mesh_factory.hpp"
+#include "jelly/graphics/mesh_renderer_system.hpp"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace jelly;
+using namespace jelly::tests;
+
+namespace {
+
+constexpr uint32_t WIDTH = 320;
+constexpr uint32_t HEIGHT = 240;
+constexpr uint32_t GRID_SIDE = 40; // Enough draws for every recording thread to get a range
+const uint32_t RECORDING_THREADS[] = { 1, 2, 4 };
+
+int runTest(Jelly& jelly, const char* shaderName) {
+    using namespace jelly::core;
+    using namespace jelly::graphics;
+
+    auto shader = loadShader(shaderName);
+    if (!shader) return FAILED;
+
+    auto scene = std::make_unique<Scene>("ParallelRecordingTest");
+    auto& registry = scene->getEntityManager();
+    scene->addGameSystem(std::make_shared<TransformSystem>(registry));
+
+    // Two materials interleaved so the queue switches resources between draws
+    std::vector<MaterialHandle> materials = { MaterialFactory::create(shader), MaterialFactory::create(shader) };
+    MeshHandle meshes[] = { MeshFactory::cube(), MeshFactory::quad() };
+
+    for (uint32_t y = 0; y < GRID_SIDE; ++y) {
+        for (uint32_t x = 0; x < GRID_SIDE; ++x) {
+            const uint32_t index = y * GRID_SIDE + x;
+
+            auto entity = registry.create();
+            auto& transform = registry.emplace<Transform>(entity);
+            transform.setLocalPosition(glm::vec3(
+                (static_cast<float>(x) - GRID_SIDE * 0.5f) * 1.2f,
+                (static_cast<float>(y) - GRID_SIDE * 0.5f) * 1.2f,
+                -static_cast<float>(index % 5)));
+            transform.setLocalRotationQuat(glm::quat(glm::vec3(0.3f * (index % 7), 0.2f * (index % 11), 0.0f)));
+            transform.setLocalScale(glm::vec3(0.5f));
+
+            registry.emplace<MeshComponent>(entity, meshes[index % 2]);
+            registry.emplace<MaterialComponent>(entity, materials[(index / 3) % 2]);
+        }
+    }
+
+    auto cameraEntity = registry.create();
+    registry.emplace<Transform>(cameraEntity).setLocalPosition(glm::vec3(0.0f, 0.0f, 45.0f));
+    registry.emplace<Camera>(cameraEntity);
+    scene->addGameSystem(std::make_shared<CameraSystem>(
+        registry, static_cast<float>(WIDTH), static_cast<float>(HEIGHT)));
+
+    auto meshRenderer = std::make_shared<MeshRendererSystem>(registry);
+    scene->addGameSystem(meshRenderer);
+
+    jelly.getSceneManager().addScene(std::move(scene));
+    jelly.getSceneManager().setActiveScene(0);
+
+    if (!runUntilReady(jelly, materials)) return fail("pipelines never became ready");
+
+    std::vector<uint8_t> reference;
+    uint32_t width = 0, height = 0;
+    if (!jelly.readFrame(reference, width, height)) return fail("no frame to read back");
+
+    const uint32_t drawCount = meshRenderer->getQueueStats().drawCount;
+    std::printf("Reference frame: %u draws recorded on the main thread\n", drawCount);
+
+    // A frame of clear color alone would match trivially
+    size_t drawnPixels = 0;
+    for (size_t i = 0; i < reference.size(); i += 4) {
+        if (!std::equal(reference.begin() + i, reference.begin() + i + 4, reference.begin())) ++drawnPixels;
+    }
+    if (drawnPixels == 0) return fail("reference frame is empty");
+
+    auto* api = GraphicContext::get().getAPI();
+
+    for (uint32_t threads : RECORDING_THREADS) {
+        api->setRecordingThreadCount(threads);
+        runFrame(jelly);
+
+        std::vector<uint8_t> pixels;
+        if (!jelly.readFrame(pixels, width, height)) return fail("no frame to read back with %u threads", threads);
+
+        if (meshRenderer->getQueueStats().drawCount != drawCount) {
+            return fail("%u threads recorded %u draws instead of %u",
+                threads, meshRenderer->getQueueStats().drawCount, drawCount);
+        }
+
+        size_t differing = 0;
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+            if (!std::equal(pixels.begin() + i, pixels.begin() + i + 4, reference.begin() + i)) ++differing;
+        }
+        if (pixels.size() != reference.size() || differing != 0) {
+            return fail("%zu of %u pixels differ with %u recording threads",
+                differing, width * height, threads);
+        }
+
+        std::printf("%u recording threads: frame identical\n", threads);
+    }
+
+    return PASSED;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* shaderName = argc > 1 ? argv[1] : "test";
+
+    Jelly jelly;
+    if (!initializeHeadless(jelly, WIDTH, HEIGHT)) return SKIPPED;
+
+    int result = FAILED;
+    try {
+        result = runTest(jelly, shaderName);
+    } catch (const std::exception& e) {
+        result = fail("%s", e.what());
+    }
+
+    jelly.shutdown();
+    return result;
+}
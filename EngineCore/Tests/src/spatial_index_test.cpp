@@ -0,0 +1,345 @@
+// Inserts, moves and removes random boxes in the dynamic AABB tree and the
+// SpatialIndexSystem, checks the tree invariants after every round, and
+// compares every query against a brute-force scan of the same boxes.
+//
+// Usage: SpatialIndexTest [seed]
+
+#include "headless_test.hpp"
+
+#include "jelly/core/bounds.hpp"
+#include "jelly/core/dynamic_aabb_tree.hpp"
+#include "jelly/core/frustum.hpp"
+#include "jelly/core/spatial_index_system.hpp"
+#include "jelly/core/transform.hpp"
+#include "jelly/core/transform_system.hpp"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace jelly;
+using namespace jelly::tests;
+
+namespace {
+
+constexpr uint32_t ROUNDS = 200;
+constexpr uint32_t INITIAL_BOXES = 1000;
+constexpr uint32_t CHANGES_PER_ROUND = 50;
+constexpr uint32_t QUERIES_PER_ROUND = 8;
+constexpr float WORLD_HALF_SIZE = 100.0f;
+
+class Random {
+public:
+    explicit Random(uint32_t seed) : engine_(seed) {}
+
+    float range(float low, float high) { return std::uniform_real_distribution<float>(low, high)(engine_); }
+    uint32_t below(uint32_t count) { return std::uniform_int_distribution<uint32_t>(0, count - 1)(engine_); }
+
+    glm::vec3 point(float halfSize) {
+        return { range(-halfSize, halfSize), range(-halfSize, halfSize), range(-halfSize, halfSize) };
+    }
+
+    core::BoundingBox box(const glm::vec3& center) {
+        const glm::vec3 extents(range(0.1f, 3.0f), range(0.1f, 3.0f), range(0.1f, 3.0f));
+        return { center - extents, center + extents };
+    }
+
+    core::Frustum frustum() {
+        const glm::vec3 eye = point(WORLD_HALF_SIZE);
+        const glm::vec3 target = point(WORLD_HALF_SIZE * 0.5f);
+        const glm::mat4 view = glm::lookAtRH(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 projection = glm::perspectiveRH_ZO(glm::radians(range(30.0f, 90.0f)), range(1.0f, 2.0f), 0.1f, range(20.0f, 150.0f));
+        return core::Frustum(projection * view);
+    }
+
+    core::Ray ray() {
+        glm::vec3 direction = point(1.0f);
+        if (glm::dot(direction, direction) < 1e-4f) direction = glm::vec3(0.0f, 0.0f, -1.0f);
+        return { point(WORLD_HALF_SIZE), glm::normalize(direction) };
+    }
+
+private:
+    std::mt19937 engine_;
+};
+
+// Same structure check as the tree's, plus the height bound of a balanced tree
+bool checkTree(const core::DynamicAabbTree& tree) {
+    if (!tree.validate()) return false;
+    if (tree.getMaxBalance() > 1) return false;
+
+    const size_t count = tree.getProxyCount();
+    return count < 2 || tree.getHeight() <= 2 * static_cast<int32_t>(std::ceil(std::log2(double(count))));
+}
+
+std::vector<entt::entity> sorted(std::vector<entt::entity> entities) {
+    std::sort(entities.begin(), entities.end());
+    return entities;
+}
+
+// === DynamicAabbTree on its own ===
+
+int testTree(Random& random) {
+    core::DynamicAabbTree tree(0.5f);
+
+    struct Proxy {
+        int32_t id;
+        core::BoundingBox box;
+    };
+    std::vector<Proxy> proxies;
+
+    for (uint32_t i = 0; i < INITIAL_BOXES; ++i) {
+        const core::BoundingBox box = random.box(random.point(WORLD_HALF_SIZE));
+        proxies.push_back({ tree.createProxy(box, i), box });
+    }
+
+    for (uint32_t round = 0; round < ROUNDS; ++round) {
+        for (uint32_t change = 0; change < CHANGES_PER_ROUND; ++change) {
+            const uint32_t action = random.below(4);
+
+            if (action == 0 || proxies.empty()) {
+                const core::BoundingBox box = random.box(random.point(WORLD_HALF_SIZE));
+                proxies.push_back({ tree.createProxy(box, proxies.size()), box });
+            } else if (action == 1) {
+                const uint32_t index = random.below(static_cast<uint32_t>(proxies.size()));
+                tree.destroyProxy(proxies[index].id);
+                proxies[index] = proxies.back();
+                proxies.pop_back();
+            } else {
+                // Small moves mostly stay inside the fat box, large ones reinsert
+                Proxy& proxy = proxies[random.below(static_cast<uint32_t>(proxies.size()))];
+                const float distance = action == 2 ? 0.2f : WORLD_HALF_SIZE * 0.2f;
+                const glm::vec3 offset = random.point(distance);
+                proxy.box = { proxy.box.min + offset, proxy.box.max + offset };
+                tree.moveProxy(proxy.id, proxy.box);
+            }
+        }
+
+        if (tree.getProxyCount() != proxies.size()) {
+            return fail("round %u: tree holds %zu proxies instead of %zu", round, tree.getProxyCount(), proxies.size());
+        }
+        if (!checkTree(tree)) {
+            return fail("round %u: invariants broken (height %d, max balance %d, %zu proxies)",
+                round, tree.getHeight(), tree.getMaxBalance(), proxies.size());
+        }
+        for (const Proxy& proxy : proxies) {
+            if (!tree.getFatBox(proxy.id).contains(proxy.box)) {
+                return fail("round %u: a fat box does not contain its proxy", round);
+            }
+        }
+
+        for (uint32_t query = 0; query < QUERIES_PER_ROUND; ++query) {
+            const core::BoundingBox box = random.box(random.point(WORLD_HALF_SIZE));
+            const core::BoundingBox searchBox = box.expanded(random.range(0.0f, 20.0f));
+
+            std::vector<int32_t> found;
+            tree.query(searchBox, [&](int32_t proxyId) {
+                found.push_back(proxyId);
+                return true;
+            });
+
+            std::vector<int32_t> expected;
+            for (const Proxy& proxy : proxies) {
+                if (tree.getFatBox(proxy.id).overlaps(searchBox)) expected.push_back(proxy.id);
+            }
+
+            std::sort(found.begin(), found.end());
+            std::sort(expected.begin(), expected.end());
+            if (found != expected) {
+                return fail("round %u: box query found %zu proxies instead of %zu", round, found.size(), expected.size());
+            }
+        }
+    }
+
+    std::printf("DynamicAabbTree: %zu proxies, height %d, invariants and box queries hold\n",
+        proxies.size(), tree.getHeight());
+    return PASSED;
+}
+
+// === SpatialIndexSystem against its entities ===
+
+struct IndexedBox {
+    entt::entity entity;
+    core::BoundingBox worldBox;
+};
+
+std::vector<IndexedBox> collectBoxes(entt::registry& registry) {
+    std::vector<IndexedBox> boxes;
+    registry.view<core::SpatialBounds, core::Transform>().each(
+        [&](auto entity, core::SpatialBounds& bounds, core::Transform& transform) {
+            boxes.push_back({ entity, bounds.localBox.transformed(transform.worldMatrix) });
+        });
+    return boxes;
+}
+
+int compareQueries(const core::SpatialIndexSystem& index, const std::vector<IndexedBox>& boxes, Random& random, uint32_t round) {
+    for (uint32_t query = 0; query < QUERIES_PER_ROUND; ++query) {
+        std::vector<entt::entity> found, expected;
+
+        const core::Frustum frustum = random.frustum();
+        index.queryFrustum(frustum, found);
+        for (const IndexedBox& box : boxes) {
+            if (frustum.intersects(box.worldBox)) expected.push_back(box.entity);
+        }
+        if (sorted(found) != sorted(expected)) {
+            return fail("round %u: frustum query found %zu entities instead of %zu", round, found.size(), expected.size());
+        }
+
+        found.clear();
+        expected.clear();
+        const core::BoundingBox searchBox = random.box(random.point(WORLD_HALF_SIZE)).expanded(random.range(0.0f, 20.0f));
+        index.queryOverlap(searchBox, found);
+        for (const IndexedBox& box : boxes) {
+            if (searchBox.overlaps(box.worldBox)) expected.push_back(box.entity);
+        }
+        if (sorted(found) != sorted(expected)) {
+            return fail("round %u: overlap query found %zu entities instead of %zu", round, found.size(), expected.size());
+        }
+
+        found.clear();
+        expected.clear();
+        const glm::vec3 center = random.point(WORLD_HALF_SIZE);
+        const float radius = random.range(1.0f, 25.0f);
+        index.queryRadius(center, radius, found);
+        for (const IndexedBox& box : boxes) {
+            const glm::vec3 offset = glm::clamp(center, box.worldBox.min, box.worldBox.max) - center;
+            if (glm::dot(offset, offset) <= radius * radius) expected.push_back(box.entity);
+        }
+        if (sorted(found) != sorted(expected)) {
+            return fail("round %u: radius query found %zu entities instead of %zu", round, found.size(), expected.size());
+        }
+
+        const core::Ray ray = random.ray();
+        const float maxDistance = random.range(10.0f, 300.0f);
+        const std::optional<core::RaycastHit> hit = index.raycast(ray, maxDistance);
+
+        std::optional<float> closest;
+        for (const IndexedBox& box : boxes) {
+            float distance = 0.0f;
+            if (box.worldBox.intersects(ray, maxDistance, distance) && (!closest || distance < *closest)) {
+                closest = distance;
+            }
+        }
+
+        if (hit.has_value() != closest.has_value() || (hit && hit->distance != *closest)) {
+            return fail("round %u: raycast hit at %.4f instead of %.4f", round,
+                hit ? hit->distance : -1.0f, closest ? *closest : -1.0f);
+        }
+        if (hit) {
+            // Ties may report either entity, but it must be hit at that distance
+            auto it = std::find_if(boxes.begin(), boxes.end(), [&](const IndexedBox& box) { return box.entity == hit->entity; });
+            float distance = 0.0f;
+            if (it == boxes.end() || !it->worldBox.intersects(ray, maxDistance, distance) || distance != hit->distance) {
+                return fail("round %u: raycast reported an entity not hit at %.4f", round, hit->distance);
+            }
+        }
+    }
+    return PASSED;
+}
+
+int testIndex(Random& random) {
+    entt::registry registry;
+    core::TransformSystem transformSystem(registry);
+    core::SpatialIndexSystem index(registry, transformSystem, 0.5f);
+
+    std::vector<entt::entity> entities;
+    auto createEntity = [&] {
+        auto entity = registry.create();
+        registry.emplace<core::Transform>(entity).setLocalPosition(random.point(WORLD_HALF_SIZE));
+        registry.emplace<core::SpatialBounds>(entity, random.box(glm::vec3(0.0f)));
+        entities.push_back(entity);
+    };
+
+    for (uint32_t i = 0; i < INITIAL_BOXES; ++i) {
+        createEntity();
+    }
+
+    for (uint32_t round = 0; round < ROUNDS; ++round) {
+        for (uint32_t change = 0; change < CHANGES_PER_ROUND; ++change) {
+            const uint32_t action = entities.empty() ? 0 : random.below(6);
+            const uint32_t slot = entities.empty() ? 0 : random.below(static_cast<uint32_t>(entities.size()));
+
+            switch (action) {
+            case 0:
+                createEntity();
+                break;
+            case 1: // Destroyed entity
+                registry.destroy(entities[slot]);
+                entities[slot] = entities.back();
+                entities.pop_back();
+                break;
+            case 2: // Small move, usually inside the fat box
+            case 3: { // Large move
+                auto& transform = registry.get<core::Transform>(entities[slot]);
+                const float distance = action == 2 ? 0.2f : WORLD_HALF_SIZE * 0.2f;
+                transform.setLocalPosition(transform.localPosition + random.point(distance));
+                break;
+            }
+            case 4: // Changed bounds
+                if (registry.all_of<core::SpatialBounds>(entities[slot])) {
+                    registry.patch<core::SpatialBounds>(entities[slot], [&](core::SpatialBounds& bounds) {
+                        bounds.localBox = random.box(glm::vec3(0.0f));
+                    });
+                }
+                break;
+            default: // Bounds removed, the entity leaves the index
+                if (registry.all_of<core::SpatialBounds>(entities[slot])) {
+                    registry.remove<core::SpatialBounds>(entities[slot]);
+                } else {
+                    registry.emplace<core::SpatialBounds>(entities[slot], random.box(glm::vec3(0.0f)));
+                }
+                break;
+            }
+        }
+
+        transformSystem.update();
+        index.update();
+
+        const std::vector<IndexedBox> boxes = collectBoxes(registry);
+        const core::DynamicAabbTree& tree = index.getTree();
+
+        if (tree.getProxyCount() != boxes.size()) {
+            return fail("round %u: index holds %zu entities instead of %zu", round, tree.getProxyCount(), boxes.size());
+        }
+        if (!checkTree(tree)) {
+            return fail("round %u: invariants broken (height %d, max balance %d, %zu entities)",
+                round, tree.getHeight(), tree.getMaxBalance(), boxes.size());
+        }
+        for (const IndexedBox& box : boxes) {
+            const core::BoundingBox* indexed = index.getWorldBox(box.entity);
+            if (!indexed || indexed->min != box.worldBox.min || indexed->max != box.worldBox.max) {
+                return fail("round %u: stale world box", round);
+            }
+        }
+
+        const int result = compareQueries(index, boxes, random, round);
+        if (result != PASSED) return result;
+    }
+
+    std::printf("SpatialIndexSystem: %zu entities, height %d, queries match a brute-force scan\n",
+        index.getTree().getProxyCount(), index.getTree().getHeight());
+    return PASSED;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t seed = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1;
+
+    int result = FAILED;
+    try {
+        Random random(seed);
+        result = testTree(random);
+        if (result == PASSED) result = testIndex(random);
+    } catch (const std::exception& e) {
+        result = fail("%s", e.what());
+    }
+    return result;
+}